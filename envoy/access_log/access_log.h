@@ -37,6 +37,27 @@ public:
 
 using AccessLogFileSharedPtr = std::shared_ptr<AccessLogFile>;
 
+/**
+ * What an access log file does with a write once its buffered data reaches the configured write
+ * buffer limit.
+ */
+enum class FileOverflowPolicy {
+  /**
+   * Buffer the write anyway and only count the overflow.
+   */
+  Count,
+
+  /**
+   * Drop the write and count it as dropped.
+   */
+  Drop,
+
+  /**
+   * Block the writer until the flush thread has brought the buffered data under the limit.
+   */
+  Block,
+};
+
 class AccessLogManager {
 public:
   virtual ~AccessLogManager() = default;
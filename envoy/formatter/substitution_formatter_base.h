@@ -28,6 +28,19 @@ public:
    */
   virtual std::string formatWithContext(const FormatterContext& context,
                                         const StreamInfo::StreamInfo& stream_info) const PURE;
+
+  /**
+   * Append a formatted substitution line to the given output. Implementations may override this
+   * to write directly into the output, which lets callers reuse a single buffer across lines.
+   * @param context supplies the formatter context.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the string to append the formatted substitution line to.
+   */
+  virtual void appendWithContext(const FormatterContext& context,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 std::string& output) const {
+    output.append(formatWithContext(context, stream_info));
+  }
 };
 
 template <class FormatterContext>
@@ -61,6 +74,25 @@ public:
   virtual ProtobufWkt::Value
   formatValueWithContext(const FormatterContext& context,
                          const StreamInfo::StreamInfo& stream_info) const PURE;
+
+  /**
+   * Append the value formatted with the given context and stream info to the given output.
+   * Providers may override this to avoid the temporary string returned by formatWithContext().
+   * @param context supplies the formatter context.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the string to append the value to.
+   * @return bool true if a value was appended, false if there is no value.
+   */
+  virtual bool appendWithContext(const FormatterContext& context,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 std::string& output) const {
+    const absl::optional<std::string> value = formatWithContext(context, stream_info);
+    if (!value.has_value()) {
+      return false;
+    }
+    output.append(value.value());
+    return true;
+  }
 };
 
 template <class FormatterContext>
@@ -183,6 +215,21 @@ public:
    * @return ProtobufWkt::Value containing a single value extracted from the given stream info.
    */
   virtual ProtobufWkt::Value formatValue(const StreamInfo::StreamInfo& stream_info) const PURE;
+
+  /**
+   * Append the value formatted with the given stream info to the given output.
+   * @param stream_info supplies the stream info.
+   * @param output supplies the string to append the value to.
+   * @return bool true if a value was appended, false if there is no value.
+   */
+  virtual bool append(const StreamInfo::StreamInfo& stream_info, std::string& output) const {
+    const absl::optional<std::string> value = format(stream_info);
+    if (!value.has_value()) {
+      return false;
+    }
+    output.append(value.value());
+    return true;
+  }
 };
 
 using StreamInfoFormatterProvider = FormatterProviderBase<StreamInfoOnlyFormatterContext>;
@@ -15,6 +15,10 @@
 #include "envoy/stats/stats_macros.h"
 
 namespace Envoy {
+namespace Event {
+class Dispatcher;
+} // namespace Event
+
 namespace Network {
 
 /**
@@ -111,10 +115,13 @@ public:
   /**
    * Creates an UdpPacketWriter object for the given Udp Socket
    * @param socket UDP socket used to send packets.
+   * @param scope the stats scope of the writer.
+   * @param dispatcher the dispatcher of the worker which the writer is used on.
    * @return the UdpPacketWriter created.
    */
   virtual UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
-                                                   Stats::Scope& scope) PURE;
+                                                   Stats::Scope& scope,
+                                                   Event::Dispatcher& dispatcher) PURE;
 };
 
 using UdpPacketWriterFactoryPtr = std::unique_ptr<UdpPacketWriterFactory>;
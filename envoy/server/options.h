@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <string>
 
+#include "envoy/access_log/access_log.h"
 #include "envoy/admin/v3/server_info.pb.h"
 #include "envoy/common/pure.h"
 #include "envoy/config/bootstrap/v3/bootstrap.pb.h"
@@ -217,6 +218,18 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint64_t the number of bytes an access log file may buffer before its overflow policy
+   *         applies. 0 means no limit.
+   */
+  virtual uint64_t fileWriteBufferLimitBytes() const PURE;
+
+  /**
+   * @return AccessLog::FileOverflowPolicy what access log files do with writes once the write
+   *         buffer limit is reached.
+   */
+  virtual AccessLog::FileOverflowPolicy fileWriteOverflowPolicy() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
@@ -101,6 +101,11 @@ public:
    */
   virtual bool autoSniSanMatch() const PURE;
 
+  /**
+   * @return the max number of verified certificate chains to remember, or 0 to verify every chain.
+   */
+  virtual uint32_t verifiedChainCacheSize() const PURE;
+
   // SECURITY NOTE
   //
   // When adding or changing this interface, it is likely that a change is needed to
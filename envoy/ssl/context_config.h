@@ -173,6 +173,15 @@ public:
     MustStaple,
   };
 
+  struct DynamicRecordSizing {
+    // The plaintext size of the records written at the start of a connection and after it was idle.
+    uint32_t small_record_size_;
+    // The number of bytes written in small records before moving to full size records.
+    uint64_t small_record_bytes_;
+    // The duration without writes after which a connection goes back to small records.
+    std::chrono::milliseconds idle_timeout_;
+  };
+
   /**
    * @return True if client certificate is required, false otherwise.
    */
@@ -207,6 +216,12 @@ public:
    */
   virtual bool disableStatefulSessionResumption() const PURE;
 
+  /**
+   * @return the maximum number of sessions kept in the session cache shared by the workers, or 0
+   * if the sessions are kept in the internal cache of each certificate.
+   */
+  virtual uint32_t sharedSessionCacheSize() const PURE;
+
   /**
    * @return True if we allow full scan certificates when there is no cert matching SNI during
    * downstream TLS handshake, false otherwise.
@@ -218,6 +233,18 @@ public:
    */
   virtual bool preferClientCiphers() const PURE;
 
+  /**
+   * @return true if the record layer of the connections is handed to the kernel after the
+   * handshake, false otherwise.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
+  /**
+   * @return the dynamic record sizing settings of the connections, or nullopt if the connections
+   * write records as large as possible.
+   */
+  virtual const absl::optional<DynamicRecordSizing>& dynamicRecordSizing() const PURE;
+
   /**
    * @return a factory which can be used to create TLS context provider instances.
    */
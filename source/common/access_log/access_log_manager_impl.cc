@@ -46,37 +46,42 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
                                                   open_result.err_->getErrorDetails()));
   }
 
-  access_logs_[file_name] =
-      std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+  access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+      std::move(file), dispatcher_, lock_, file_stats_, file_flush_interval_msec_,
+      api_.threadFactory(), file_write_buffer_limit_bytes_, file_write_overflow_policy_);
   return access_logs_[file_name];
 }
 
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
+                                     Thread::ThreadFactory& thread_factory,
+                                     uint64_t write_buffer_limit_bytes,
+                                     FileOverflowPolicy overflow_policy)
     : file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
         flush_event_.notifyOne();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec),
+      write_buffer_limit_bytes_(write_buffer_limit_bytes), overflow_policy_(overflow_policy),
+      stats_(stats) {
   flush_timer_->enableTimer(flush_interval_msec_);
 }
 
 void AccessLogFileImpl::reopen() {
-  Thread::LockGuard lock(write_lock_);
+  Thread::LockGuard lock(state_lock_);
   reopen_file_ = true;
   flush_event_.notifyOne();
 }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
   {
-    Thread::LockGuard lock(write_lock_);
+    Thread::LockGuard lock(state_lock_);
     flush_thread_exit_ = true;
     flush_event_.notifyOne();
+    flush_done_event_.notifyAll();
   }
 
   if (flush_thread_ != nullptr) {
@@ -85,8 +90,10 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    Thread::LockGuard flush_lock(flush_lock_);
+    collectWriteShards();
+    if (about_to_write_buffer_.length() > 0) {
+      doWrite(about_to_write_buffer_);
     }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
@@ -94,6 +101,17 @@ AccessLogFileImpl::~AccessLogFileImpl() {
   }
 }
 
+void AccessLogFileImpl::collectWriteShards() {
+  for (WriteShard& shard : write_shards_) {
+    Thread::LockGuard lock(shard.lock_);
+    const uint64_t length = shard.buffer_.length();
+    if (length > 0) {
+      about_to_write_buffer_.move(shard.buffer_);
+      buffered_bytes_ -= length;
+    }
+  }
+}
+
 void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   Buffer::RawSliceVector slices = buffer.getRawSlices();
 
@@ -134,17 +152,17 @@ void AccessLogFileImpl::flushThreadFunc() {
     std::unique_lock<Thread::BasicLockable> flush_lock;
 
     {
-      Thread::LockGuard write_lock(write_lock_);
+      Thread::LockGuard state_lock(state_lock_);
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
+      // flush_event_ can be woken up either by enough buffered data or by timer.
+      // In case it was timer, the write buffers can be empty.
       //
       // Note: do not stop waiting when only `do_reopen` is true. In this case, we tried to
       // reopen and failed. We don't want to retry this in a tight loop, so wait for the next
       // event (timer or flush).
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
+      while (buffered_bytes_ == 0 && !flush_thread_exit_ && !reopen_file_) {
         // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
+        flush_event_.wait(state_lock_);
       }
 
       if (flush_thread_exit_) {
@@ -152,8 +170,6 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
 
       flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
 
       if (reopen_file_) {
         do_reopen = true;
@@ -161,6 +177,8 @@ void AccessLogFileImpl::flushThreadFunc() {
       }
     }
 
+    collectWriteShards();
+
     if (do_reopen) {
       if (file_->isOpen()) {
         const Api::IoCallBoolResult result = file_->close();
@@ -176,44 +194,86 @@ void AccessLogFileImpl::flushThreadFunc() {
     }
     // doWrite no matter file isOpen, if not, we can drain buffer
     doWrite(about_to_write_buffer_);
+    flush_lock.unlock();
+    notifyFlushDone();
   }
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
-
+  // flush_lock_ must be held while collecting the write buffers or else it is
+  // possible that flushThreadFunc() has already moved data from them to
+  // about_to_write_buffer_ but has not yet completed doWrite(). This would allow
+  // flush() to return before the pending data has actually been written to disk.
   {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
+    Thread::LockGuard flush_lock(flush_lock_);
+    collectWriteShards();
 
-    if (flush_buffer_.length() == 0) {
+    if (about_to_write_buffer_.length() == 0) {
       return;
     }
 
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+    doWrite(about_to_write_buffer_);
   }
-
-  doWrite(about_to_write_buffer_);
+  notifyFlushDone();
 }
 
-void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
-
+void AccessLogFileImpl::waitForFlush() {
+  Thread::LockGuard lock(state_lock_);
   if (flush_thread_ == nullptr) {
     createFlushStructures();
   }
+  flush_event_.notifyOne();
+  while (buffered_bytes_ >= write_buffer_limit_bytes_ && !flush_thread_exit_) {
+    // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+    flush_done_event_.wait(state_lock_);
+  }
+}
+
+void AccessLogFileImpl::notifyFlushDone() {
+  if (overflow_policy_ != FileOverflowPolicy::Block) {
+    return;
+  }
+  Thread::LockGuard lock(state_lock_);
+  flush_done_event_.notifyAll();
+}
+
+void AccessLogFileImpl::write(absl::string_view data) {
+  if (write_buffer_limit_bytes_ > 0 && buffered_bytes_ >= write_buffer_limit_bytes_) {
+    stats_.write_buffer_overflow_.inc();
+    switch (overflow_policy_) {
+    case FileOverflowPolicy::Count:
+      break;
+    case FileOverflowPolicy::Drop:
+      stats_.write_dropped_.inc();
+      return;
+    case FileOverflowPolicy::Block:
+      waitForFlush();
+      break;
+    }
+  }
 
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
+
+  // Writers are spread over the write buffers by thread ID, so each worker keeps using the same
+  // buffer and the order of its writes is preserved.
+  WriteShard& shard =
+      write_shards_[static_cast<uint64_t>(thread_factory_.currentThreadId().getId()) %
+                    NUM_WRITE_SHARDS];
+  uint64_t buffered_bytes;
+  {
+    Thread::LockGuard lock(shard.lock_);
+    shard.buffer_.add(data.data(), data.size());
+    buffered_bytes = buffered_bytes_ += data.size();
+  }
+
+  // The flush thread is started after the first data is buffered, so that it flushes it on its
+  // first loop.
+  if (!flush_thread_started_ || buffered_bytes > MIN_FLUSH_SIZE) {
+    Thread::LockGuard lock(state_lock_);
+    if (flush_thread_ == nullptr) {
+      createFlushStructures();
+    }
     flush_event_.notifyOne();
   }
 }
@@ -221,6 +281,7 @@ void AccessLogFileImpl::write(absl::string_view data) {
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
                                                Thread::Options{"AccessLogFlush"});
+  flush_thread_started_ = true;
 }
 
 } // namespace AccessLog
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <string>
 
 #include "envoy/access_log/access_log.h"
@@ -20,8 +22,10 @@ namespace Envoy {
 #define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_buffer_overflow)                                                                   \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -33,13 +37,17 @@ namespace AccessLog {
 
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
-  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
+  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec,
+                       uint64_t file_write_buffer_limit_bytes,
+                       FileOverflowPolicy file_write_overflow_policy, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
                        Stats::Store& stats_store)
-      : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
-                         ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                                               POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
+      : file_flush_interval_msec_(file_flush_interval_msec),
+        file_write_buffer_limit_bytes_(file_write_buffer_limit_bytes),
+        file_write_overflow_policy_(file_write_overflow_policy), api_(api),
+        dispatcher_(dispatcher), lock_(lock),
+        file_stats_{ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
+                                          POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
   ~AccessLogManagerImpl() override;
 
   // AccessLog::AccessLogManager
@@ -49,6 +57,8 @@ public:
 
 private:
   const std::chrono::milliseconds file_flush_interval_msec_;
+  const uint64_t file_write_buffer_limit_bytes_;
+  const FileOverflowPolicy file_write_overflow_policy_;
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
@@ -60,15 +70,22 @@ private:
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
  * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * files. A single flush thread for all files would let one blocked file stall every other one.
+ *
+ * Writers append to one of several write buffers chosen by their thread ID, so that workers
+ * logging to the same file rarely contend on the same lock. The flush thread gathers all of them.
+ *
+ * If a write buffer limit is set, writes made while the buffered data is at or above it are
+ * handled according to the overflow policy: buffered anyway, dropped, or held until the flush
+ * thread catches up.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    Thread::ThreadFactory& thread_factory, uint64_t write_buffer_limit_bytes,
+                    FileOverflowPolicy overflow_policy);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -83,19 +100,34 @@ public:
   void flush() override;
 
 private:
+  struct WriteShard {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   void createFlushStructures();
+  // Moves the contents of all write buffers into about_to_write_buffer_. Must be called with
+  // flush_lock_ held.
+  void collectWriteShards();
+  // Blocks the calling writer until the buffered data is under the write buffer limit.
+  void waitForFlush();
+  // Wakes up writers blocked in waitForFlush(). Must be called without flush_lock_ held.
+  void notifyFlushDone();
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Number of write buffers writers are spread over.
+  static constexpr uint32_t NUM_WRITE_SHARDS = 16;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
+  //    1) state_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) WriteShard::lock_
+  //    4) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -106,23 +138,26 @@ private:
                                           // and all other data used during flushing and file
                                           // re-opening.
   Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
+      state_lock_; // This lock protects the flush thread state and is used to wait for and
+                   // signal flush events. Writers only take it to start the flush thread or
+                   // once enough data is buffered to wake it up.
   Thread::ThreadPtr flush_thread_;
+  std::atomic<bool> flush_thread_started_{false};
   Thread::CondVar flush_event_;
-  bool flush_thread_exit_ ABSL_GUARDED_BY(write_lock_){false};
-  bool reopen_file_ ABSL_GUARDED_BY(write_lock_){false};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
+  Thread::CondVar flush_done_event_; // Signaled after each flush for writers blocked on the write
+                                     // buffer limit.
+  bool flush_thread_exit_ ABSL_GUARDED_BY(state_lock_){false};
+  bool reopen_file_ ABSL_GUARDED_BY(state_lock_){false};
+  std::array<WriteShard, NUM_WRITE_SHARDS>
+      write_shards_; // These buffers are filled by writers, each under its own lock, and get
+                     // flushed either when enough data is buffered or when a timer fires.
+  std::atomic<uint64_t> buffered_bytes_{0}; // Total length of the write_shards_ buffers.
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
   Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
+                                            // is moved from write_shards_ under their locks,
+                                            // which are then released so that the shards can
                                             // continue to fill. This buffer is then used for the
                                             // final write to disk.
   Event::TimerPtr flush_timer_;
@@ -130,6 +165,8 @@ private:
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
+  const uint64_t write_buffer_limit_bytes_; // 0 means no limit.
+  const FileOverflowPolicy overflow_policy_;
   AccessLogFileStats& stats_;
 };
 
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <utility>
+
+#include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+
+/**
+ * A bounded map shared by several threads, which evicts its least recently used entries. The
+ * entries are split into shards with their own lock and LRU list, so that the threads using
+ * different keys rarely contend. The bound applies to the whole cache: an entry is only evicted
+ * once the cache holds more than max_entries entries, and the entry evicted is then the least
+ * recently used one of a shard, taken in turn.
+ *
+ * The lookup methods accept any key type which the Hash and KeyEqual types accept.
+ */
+template <class Key, class Value, class Hash = typename absl::node_hash_map<Key, Value>::hasher,
+          class KeyEqual = typename absl::node_hash_map<Key, Value>::key_equal>
+class ShardedLruCache {
+public:
+  /**
+   * @param max_entries supplies the maximum number of entries, at least 1.
+   */
+  explicit ShardedLruCache(size_t max_entries) : max_entries_(std::max<size_t>(1, max_entries)) {}
+
+  /**
+   * Looks up the entry of a key, which becomes the most recently used one if it is kept.
+   * @param key supplies the key.
+   * @param visit supplies a function called with the value of the entry under the lock of its
+   *        shard, which returns false to remove the entry.
+   * @return whether the entry was found and kept.
+   */
+  template <class LookupKey, class Visitor> bool lookup(const LookupKey& key, Visitor visit) {
+    Shard& shard = shardOf(key);
+    {
+      absl::MutexLock lock(&shard.mutex_);
+      auto it = shard.map_.find(key);
+      if (it == shard.map_.end()) {
+        return false;
+      }
+      if (visit(it->second->value_)) {
+        shard.list_.splice(shard.list_.begin(), shard.list_, it->second);
+        return true;
+      }
+      shard.list_.erase(it->second);
+      shard.map_.erase(it);
+    }
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  /**
+   * Sets the value of a key, whose entry becomes the most recently used one.
+   * @param key supplies the key.
+   * @param value supplies the value.
+   */
+  template <class InsertKey> void insert(const InsertKey& key, Value value) {
+    Shard& shard = shardOf(key);
+    {
+      absl::MutexLock lock(&shard.mutex_);
+      auto it = shard.map_.find(key);
+      if (it != shard.map_.end()) {
+        it->second->value_ = std::move(value);
+        shard.list_.splice(shard.list_.begin(), shard.list_, it->second);
+        return;
+      }
+      add(shard, Key(key), std::move(value));
+    }
+    evictOverflow(shard);
+  }
+
+  /**
+   * @param key supplies the key.
+   * @param create supplies a function creating the value of the key if it has no entry.
+   * @return the value of the key, whose entry becomes the most recently used one.
+   */
+  template <class Factory> Value getOrCreate(const Key& key, Factory create) {
+    Shard& shard = shardOf(key);
+    Value value;
+    {
+      absl::MutexLock lock(&shard.mutex_);
+      auto it = shard.map_.find(key);
+      if (it != shard.map_.end()) {
+        shard.list_.splice(shard.list_.begin(), shard.list_, it->second);
+        return it->second->value_;
+      }
+      value = create();
+      add(shard, key, value);
+    }
+    evictOverflow(shard);
+    return value;
+  }
+
+  /**
+   * @return the number of entries.
+   */
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr size_t NumShards = 16;
+
+  struct Entry {
+    // The key stored in the map, whose nodes are stable.
+    const Key* key_;
+    Value value_;
+  };
+  using LruList = std::list<Entry>;
+  struct Shard {
+    absl::Mutex mutex_;
+    LruList list_ ABSL_GUARDED_BY(mutex_);
+    absl::node_hash_map<Key, typename LruList::iterator, Hash, KeyEqual>
+        map_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  template <class LookupKey> Shard& shardOf(const LookupKey& key) {
+    return shards_[Hash()(key) % NumShards];
+  }
+
+  void add(Shard& shard, Key key, Value value) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_) {
+    shard.list_.push_front(Entry{nullptr, std::move(value)});
+    auto it = shard.map_.emplace(std::move(key), shard.list_.begin()).first;
+    shard.list_.front().key_ = &it->first;
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Evicts entries until the cache holds at most max_entries_ of them. The shards are locked one
+  // at a time, after the lock of the shard an entry was added to is released. The entry just added
+  // to a shard is its most recently used one, which is kept.
+  void evictOverflow(const Shard& added_to) {
+    while (size_.load(std::memory_order_relaxed) > max_entries_) {
+      Shard& victim = shards_[next_victim_.fetch_add(1, std::memory_order_relaxed) % NumShards];
+      absl::MutexLock lock(&victim.mutex_);
+      if (victim.list_.size() > (&victim == &added_to ? 1 : 0)) {
+        victim.map_.erase(victim.map_.find(*victim.list_.back().key_));
+        victim.list_.pop_back();
+        size_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  const size_t max_entries_;
+  std::atomic<size_t> size_{0};
+  std::atomic<size_t> next_victim_{0};
+  std::array<Shard, NumShards> shards_;
+};
+
+} // namespace Envoy
@@ -59,6 +59,7 @@ public:
 protected:
   absl::optional<std::string> format(const Http::HeaderMap& headers) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
+  bool append(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   const Http::HeaderEntry* findHeader(const Http::HeaderMap& headers) const;
@@ -107,6 +108,9 @@ public:
   ProtobufWkt::Value
   formatValueWithContext(const HttpFormatterContext& context,
                          const StreamInfo::StreamInfo& stream_info) const override;
+  bool appendWithContext(const HttpFormatterContext& context,
+                         const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override;
 };
 
 /**
@@ -124,6 +128,9 @@ public:
   ProtobufWkt::Value
   formatValueWithContext(const HttpFormatterContext& context,
                          const StreamInfo::StreamInfo& stream_info) const override;
+  bool appendWithContext(const HttpFormatterContext& context,
+                         const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override;
 };
 
 /**
@@ -141,6 +148,9 @@ public:
   ProtobufWkt::Value
   formatValueWithContext(const HttpFormatterContext& context,
                          const StreamInfo::StreamInfo& stream_info) const override;
+  bool appendWithContext(const HttpFormatterContext& context,
+                         const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override;
 };
 
 /**
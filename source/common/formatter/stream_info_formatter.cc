@@ -642,6 +642,15 @@ public:
 
     return ValueUtil::numberValue(millis.value());
   }
+  bool append(const StreamInfo::StreamInfo& stream_info, std::string& output) const override {
+    const auto millis = extractMillis(stream_info);
+    if (!millis) {
+      return false;
+    }
+
+    absl::StrAppend(&output, millis.value());
+    return true;
+  }
 
 private:
   absl::optional<int64_t> extractMillis(const StreamInfo::StreamInfo& stream_info) const {
@@ -669,6 +678,10 @@ public:
   ProtobufWkt::Value formatValue(const StreamInfo::StreamInfo& stream_info) const override {
     return ValueUtil::numberValue(field_extractor_(stream_info));
   }
+  bool append(const StreamInfo::StreamInfo& stream_info, std::string& output) const override {
+    absl::StrAppend(&output, field_extractor_(stream_info));
+    return true;
+  }
 
 private:
   FieldExtractor field_extractor_;
@@ -724,6 +737,24 @@ public:
 
     return ValueUtil::stringValue(toString(*address));
   }
+  bool append(const StreamInfo::StreamInfo& stream_info, std::string& output) const override {
+    Network::Address::InstanceConstSharedPtr address = field_extractor_(stream_info);
+    if (!address) {
+      return false;
+    }
+
+    switch (extraction_type_) {
+    case StreamInfoAddressFieldExtractionType::WithoutPort:
+      output.append(StreamInfo::Utility::formatDownstreamAddressNoPort(*address));
+      return true;
+    case StreamInfoAddressFieldExtractionType::WithPort:
+      output.append(address->asStringView());
+      return true;
+    default:
+      output.append(toString(*address));
+      return true;
+    }
+  }
 
 private:
   std::string toString(const Network::Address::Instance& address) const {
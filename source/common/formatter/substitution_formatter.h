@@ -42,6 +42,11 @@ public:
                                             const StreamInfo::StreamInfo&) const override {
     return str_;
   }
+  bool appendWithContext(const FormatterContext&, const StreamInfo::StreamInfo&,
+                         std::string& output) const override {
+    output.append(str_.string_value());
+    return true;
+  }
 
 private:
   ProtobufWkt::Value str_;
@@ -90,6 +95,10 @@ public:
                          const StreamInfo::StreamInfo& stream_info) const override {
     return formatter_->formatValue(stream_info);
   }
+  bool appendWithContext(const FormatterContext&, const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override {
+    return formatter_->append(stream_info, output);
+  }
 
 protected:
   StreamInfoFormatterProviderPtr formatter_;
@@ -230,19 +239,18 @@ public:
                                 const StreamInfo::StreamInfo& stream_info) const override {
     std::string log_line;
     log_line.reserve(256);
-
+    appendWithContext(context, stream_info, log_line);
+    return log_line;
+  }
+  void appendWithContext(const FormatterContext& context, const StreamInfo::StreamInfo& stream_info,
+                         std::string& output) const override {
     for (const auto& provider : providers_) {
-      const absl::optional<std::string> bit = provider->formatWithContext(context, stream_info);
       // Add the formatted value if there is one. Otherwise add a default value
       // of "-" if omit_empty_values_ is not set.
-      if (bit.has_value()) {
-        log_line += bit.value();
-      } else if (!omit_empty_values_) {
-        log_line += DefaultUnspecifiedValueStringView;
+      if (!provider->appendWithContext(context, stream_info, output) && !omit_empty_values_) {
+        output.append(DefaultUnspecifiedValueStringView);
       }
     }
-
-    return log_line;
   }
 
 protected:
@@ -423,6 +431,11 @@ public:
                                 const StreamInfo::StreamInfo& info) const override {
     std::string log_line;
     log_line.reserve(2048);
+    appendWithContext(context, info, log_line);
+    return log_line;
+  }
+  void appendWithContext(const FormatterContext& context, const StreamInfo::StreamInfo& info,
+                         std::string& log_line) const override {
     JsonStringSerializer serializer(log_line); // Helper to serialize the value to log line.
 
     for (const ParsedFormatElement& element : parsed_elements_) {
@@ -440,7 +453,7 @@ public:
 
       if (formatters.size() != 1) {
         // 2. Handle the formatter element with multiple or zero providers.
-        stringValueToLogLine(formatters, context, info, serializer);
+        stringValueToLogLine(formatters, context, info, log_line);
       } else {
         // 3. Handle the formatter element with a single provider and value
         //    type needs to be kept.
@@ -450,27 +463,32 @@ public:
     }
 
     log_line.push_back('\n');
-    return log_line;
   }
 
 private:
   void stringValueToLogLine(const Formatters& formatters, const FormatterContext& context,
-                            const StreamInfo::StreamInfo& info,
-                            JsonStringSerializer& serializer) const {
+                            const StreamInfo::StreamInfo& info, std::string& log_line) const {
 
-    serializer.addRawString(Json::Constants::DoubleQuote); // Start the JSON string.
+    log_line.append(Json::Constants::DoubleQuote); // Start the JSON string.
+    std::string sanitize_buffer;
     for (const Formatter& formatter : formatters) {
-      const absl::optional<std::string> value = formatter->formatWithContext(context, info);
-      if (!value.has_value()) {
+      const size_t value_start = log_line.size();
+      if (!formatter->appendWithContext(context, info, log_line)) {
         // Add the empty value. This needn't be sanitized.
-        serializer.addRawString(empty_value_);
+        log_line.append(empty_value_);
         continue;
       }
-      // Sanitize the string value and add it to the buffer. The string value will not be quoted
-      // since we handle the quoting by ourselves at the outer level.
-      serializer.addSanitized({}, value.value(), {});
+      // The value is written to the log line directly and only rewritten if sanitizing it changes
+      // it. The string value will not be quoted since we handle the quoting by ourselves at the
+      // outer level.
+      const absl::string_view value(log_line.data() + value_start, log_line.size() - value_start);
+      const absl::string_view sanitized = Json::sanitize(sanitize_buffer, value);
+      if (sanitized.data() != value.data()) {
+        log_line.resize(value_start);
+        log_line.append(sanitized);
+      }
     }
-    serializer.addRawString(Json::Constants::DoubleQuote); // End the JSON string.
+    log_line.append(Json::Constants::DoubleQuote); // End the JSON string.
   }
 
   const std::string empty_value_;
@@ -172,7 +172,7 @@ Buffer::InstancePtr Common::serializeToGrpcFrame(const Protobuf::Message& messag
   // NB: we do not use prependGrpcFrameHeader because that would add another BufferFragment and this
   // (using a single BufferFragment) is more efficient.
   Buffer::InstancePtr body(new Buffer::OwnedImpl());
-  const uint32_t size = message.ByteSize();
+  const uint32_t size = message.ByteSizeLong();
   const uint32_t alloc_size = size + 5;
   auto reservation = body->reserveSingleSlice(alloc_size);
   ASSERT(reservation.slice().len_ >= alloc_size);
@@ -181,22 +181,20 @@ Buffer::InstancePtr Common::serializeToGrpcFrame(const Protobuf::Message& messag
   const uint32_t nsize = htonl(size);
   safeMemcpyUnsafeDst(current, &nsize);
   current += sizeof(uint32_t);
-  Protobuf::io::ArrayOutputStream stream(current, size, -1);
-  Protobuf::io::CodedOutputStream codec_stream(&stream);
-  message.SerializeWithCachedSizes(&codec_stream);
+  // The sizes were cached by ByteSizeLong() above, so the message can be written straight into the
+  // reservation without going through a stream.
+  message.SerializeWithCachedSizesToArray(current);
   reservation.commit(alloc_size);
   return body;
 }
 
 Buffer::InstancePtr Common::serializeMessage(const Protobuf::Message& message) {
   auto body = std::make_unique<Buffer::OwnedImpl>();
-  const uint32_t size = message.ByteSize();
+  const uint32_t size = message.ByteSizeLong();
   auto reservation = body->reserveSingleSlice(size);
   ASSERT(reservation.slice().len_ >= size);
   uint8_t* current = reinterpret_cast<uint8_t*>(reservation.slice().mem_);
-  Protobuf::io::ArrayOutputStream stream(current, size, -1);
-  Protobuf::io::CodedOutputStream codec_stream(&stream);
-  message.SerializeWithCachedSizes(&codec_stream);
+  message.SerializeWithCachedSizesToArray(current);
   reservation.commit(size);
   return body;
 }
@@ -191,14 +191,6 @@ template <typename T> static T* removeConst(const void* object) {
 
 ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_limit)
     : MultiplexedStreamImplBase(parent.connection_.dispatcher()), parent_(parent),
-      pending_recv_data_(parent_.connection_.dispatcher().getWatermarkFactory().createBuffer(
-          [this]() -> void { this->pendingRecvBufferLowWatermark(); },
-          [this]() -> void { this->pendingRecvBufferHighWatermark(); },
-          []() -> void { /* TODO(adisuissa): Handle overflow watermark */ })),
-      pending_send_data_(parent_.connection_.dispatcher().getWatermarkFactory().createBuffer(
-          [this]() -> void { this->pendingSendBufferLowWatermark(); },
-          [this]() -> void { this->pendingSendBufferHighWatermark(); },
-          []() -> void { /* TODO(adisuissa): Handle overflow watermark */ })),
       local_end_stream_sent_(false), remote_end_stream_(false), remote_rst_(false),
       data_deferred_(false), received_noninformational_headers_(false),
       pending_receive_buffer_high_watermark_called_(false),
@@ -211,13 +203,28 @@ ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_l
   stream_manager_.defer_processing_segment_size_ = parent.connection_.bufferLimit();
 }
 
+Buffer::InstancePtr
+ConnectionImpl::StreamImpl::createPendingBuffer(std::function<void()> below_low_watermark,
+                                                std::function<void()> above_high_watermark) {
+  Buffer::InstancePtr buffer = parent_.connection_.dispatcher().getWatermarkFactory().createBuffer(
+      std::move(below_low_watermark), std::move(above_high_watermark),
+      []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
+  if (buffer_limit_ > 0) {
+    buffer->setWatermarks(buffer_limit_);
+  }
+  if (buffer_memory_account_ != nullptr) {
+    buffer->bindAccount(buffer_memory_account_);
+  }
+  return buffer;
+}
+
 void ConnectionImpl::StreamImpl::destroy() {
   // Cancel any pending buffered data callback for the stream.
   process_buffered_data_callback_.reset();
 
   MultiplexedStreamImplBase::destroy();
   parent_.stats_.streams_active_.dec();
-  parent_.stats_.pending_send_bytes_.sub(pending_send_data_->length());
+  parent_.stats_.pending_send_bytes_.sub(pendingSendDataLength());
 }
 
 void ConnectionImpl::ServerStreamImpl::destroy() {
@@ -332,7 +339,7 @@ void ConnectionImpl::StreamImpl::encodeTrailersBase(const HeaderMap& trailers) {
   parent_.updateActiveStreamsOnEncode(*this);
   ASSERT(!local_end_stream_);
   local_end_stream_ = true;
-  if (pending_send_data_->length() > 0) {
+  if (pendingSendDataLength() > 0) {
     // In this case we want trailers to come after we release all pending body data that is
     // waiting on window updates. We need to save the trailers so that we can emit them later.
     // However, for empty trailers, we don't need to to save the trailers.
@@ -496,17 +503,17 @@ void ConnectionImpl::StreamImpl::decodeData() {
     // entire buffer through.
     const bool decode_data_in_chunk =
         stream_manager_.decodeAsChunks() &&
-        pending_recv_data_->length() > stream_manager_.defer_processing_segment_size_;
+        pendingRecvDataLength() > stream_manager_.defer_processing_segment_size_;
 
     if (decode_data_in_chunk) {
       Buffer::OwnedImpl chunk_buffer;
       // TODO(kbaichoo): Consider implementing an approximate move for chunking.
-      chunk_buffer.move(*pending_recv_data_, stream_manager_.defer_processing_segment_size_);
+      chunk_buffer.move(pendingRecvData(), stream_manager_.defer_processing_segment_size_);
 
       // With the current implementation this should always be true,
       // though this can change with approximation.
       stream_manager_.body_buffered_ = true;
-      ASSERT(pending_recv_data_->length() > 0);
+      ASSERT(pendingRecvDataLength() > 0);
 
       decoder().decodeData(chunk_buffer, sendEndStream());
       already_drained_data = true;
@@ -516,11 +523,11 @@ void ConnectionImpl::StreamImpl::decodeData() {
       }
     } else {
       // Send the entire buffer through.
-      decoder().decodeData(*pending_recv_data_, sendEndStream());
+      decoder().decodeData(pendingRecvData(), sendEndStream());
     }
   }
 
-  if (!already_drained_data) {
+  if (!already_drained_data && pending_recv_data_ != nullptr) {
     pending_recv_data_->drain(pending_recv_data_->length());
   }
 }
@@ -721,7 +728,7 @@ void ConnectionImpl::StreamImpl::encodeDataHelper(Buffer::Instance& data, bool e
 
   local_end_stream_ = end_stream;
   parent_.stats_.pending_send_bytes_.add(data.length());
-  pending_send_data_->move(data);
+  pendingSendData().move(data);
   if (data_deferred_) {
     bool success = parent_.adapter_->ResumeStream(stream_id_);
     ASSERT(success);
@@ -833,8 +840,12 @@ void ConnectionImpl::StreamImpl::onMetadataDecoded(MetadataMapPtr&& metadata_map
 
 void ConnectionImpl::StreamImpl::setAccount(Buffer::BufferMemoryAccountSharedPtr account) {
   buffer_memory_account_ = account;
-  pending_recv_data_->bindAccount(buffer_memory_account_);
-  pending_send_data_->bindAccount(buffer_memory_account_);
+  if (pending_recv_data_ != nullptr) {
+    pending_recv_data_->bindAccount(buffer_memory_account_);
+  }
+  if (pending_send_data_ != nullptr) {
+    pending_send_data_->bindAccount(buffer_memory_account_);
+  }
 }
 
 ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stats,
@@ -847,6 +858,7 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       stream_error_on_invalid_http_messaging_(
           http2_options.override_stream_error_on_invalid_http_message().value()),
       protocol_constraints_(stats, http2_options), dispatching_(false), raised_goaway_(false),
+      batching_outbound_frames_(false),
       random_(random_generator),
       last_received_data_time_(connection_.dispatcher().timeSource().monotonicTime()) {
   if (http2_options.has_use_oghttp2_codec()) {
@@ -1007,7 +1019,7 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   StreamImpl* stream = getStream(stream_id);
   // If this results in buffering too much data, the watermark buffer will call
   // pendingRecvBufferHighWatermark, resulting in ++read_disable_count_
-  stream->pending_recv_data_->add(data, len);
+  stream->pendingRecvData().add(data, len);
   // Update the window to the peer unless some consumer of this stream's data has hit a flow control
   // limit and disabled reads on this stream
   if (stream->shouldAllowPeerAdditionalStreamWindow()) {
@@ -1353,17 +1365,27 @@ Status ConnectionImpl::trackInboundFrames(int32_t stream_id, size_t length, uint
 ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   ENVOY_CONN_LOG(trace, "send data: bytes={}", connection_, length);
   Buffer::OwnedImpl buffer;
-  addOutboundFrameFragment(buffer, data, length);
+  Buffer::OwnedImpl& output = outboundFramesBuffer(buffer);
+  addOutboundFrameFragment(output, data, length);
+  writeOutboundFrames(output);
+  return length;
+}
 
-  // While the buffer is transient the fragment it contains will be moved into the
+void ConnectionImpl::writeOutboundFrames(Buffer::OwnedImpl& output) {
+  if (batching_outbound_frames_) {
+    ASSERT(&output == &outbound_frames_);
+    return;
+  }
+  // While the buffer is transient the fragments it contains will be moved into the
   // write_buffer_ of the underlying connection_ by the write method below.
   // This creates lifetime dependency between the write_buffer_ of the underlying connection
   // and the codec object. Specifically the write_buffer_ MUST be either fully drained or
   // deleted before the codec object is deleted. This is presently guaranteed by the
   // destruction order of the Network::ConnectionImpl object where write_buffer_ is
   // destroyed before the filter_manager_ which owns the codec through Http::ConnectionManagerImpl.
-  connection_.write(buffer, false);
-  return length;
+  if (output.length() > 0) {
+    connection_.write(output, false);
+  }
 }
 
 Status ConnectionImpl::onStreamClose(StreamImpl* stream, uint32_t error_code) {
@@ -1525,7 +1547,13 @@ Status ConnectionImpl::sendPendingFrames() {
     return okStatus();
   }
 
+  // Serialize every frame the adapter has ready into outbound_frames_ and hand them to the
+  // connection with a single write, instead of one write (and one buffer) per frame. Small
+  // frames are coalesced into shared slices and DATA frame payloads are moved, not copied.
+  batching_outbound_frames_ = true;
   const int rc = adapter_->Send();
+  batching_outbound_frames_ = false;
+  writeOutboundFrames(outbound_frames_);
   if (rc != 0) {
     ASSERT(rc == ERR_CALLBACK_FAILURE);
     return codecProtocolError(codecStrError(rc));
@@ -1684,14 +1712,15 @@ ConnectionImpl::Http2Visitor::OnReadyToSendDataForStream(Http2StreamId stream_id
   if (stream == nullptr) {
     return {/*payload_length=*/-1, /*end_data=*/false, /*end_stream=*/false};
   }
-  if (stream->pending_send_data_->length() == 0 && !stream->local_end_stream_) {
+  const uint64_t pending_send_length = stream->pendingSendDataLength();
+  if (pending_send_length == 0 && !stream->local_end_stream_) {
     stream->data_deferred_ = true;
     return {/*payload_length=*/0, /*end_data=*/false, /*end_stream=*/false};
   }
-  const size_t length = std::min<size_t>(max_length, stream->pending_send_data_->length());
+  const size_t length = std::min<size_t>(max_length, pending_send_length);
   bool end_data = false;
   bool end_stream = false;
-  if (stream->local_end_stream_ && length == stream->pending_send_data_->length()) {
+  if (stream->local_end_stream_ && length == pending_send_length) {
     end_data = true;
     if (stream->pending_trailers_to_encode_) {
       stream->submitTrailers(*stream->pending_trailers_to_encode_);
@@ -1714,7 +1743,8 @@ bool ConnectionImpl::Http2Visitor::SendDataFrame(Http2StreamId stream_id,
                    stream_id);
     return false;
   }
-  Buffer::OwnedImpl output;
+  Buffer::OwnedImpl unbatched_output;
+  Buffer::OwnedImpl& output = connection_->outboundFramesBuffer(unbatched_output);
   connection_->addOutboundFrameFragment(
       output, reinterpret_cast<const uint8_t*>(frame_header.data()), frame_header.size());
   if (!connection_->protocol_constraints_.checkOutboundFrameLimits().ok()) {
@@ -1724,8 +1754,8 @@ bool ConnectionImpl::Http2Visitor::SendDataFrame(Http2StreamId stream_id,
   }
 
   connection_->stats_.pending_send_bytes_.sub(payload_length);
-  output.move(*stream->pending_send_data_, payload_length);
-  connection_->connection_.write(output, false);
+  output.move(stream->pendingSendData(), payload_length);
+  connection_->writeOutboundFrames(output);
   return true;
 }
 
@@ -340,7 +340,7 @@ protected:
     void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacksHelper(callbacks); }
     void resetStream(StreamResetReason reason) override;
     void readDisable(bool disable) override;
-    uint32_t bufferLimit() const override { return pending_recv_data_->highWatermark(); }
+    uint32_t bufferLimit() const override { return buffer_limit_; }
     const Network::ConnectionInfoProvider& connectionInfoProvider() override {
       return parent_.connection_.connectionInfoProvider();
     }
@@ -360,8 +360,39 @@ protected:
     }
 
     void setWriteBufferWatermarks(uint32_t high_watermark) {
-      pending_recv_data_->setWatermarks(high_watermark);
-      pending_send_data_->setWatermarks(high_watermark);
+      buffer_limit_ = high_watermark;
+      if (pending_recv_data_ != nullptr) {
+        pending_recv_data_->setWatermarks(high_watermark);
+      }
+      if (pending_send_data_ != nullptr) {
+        pending_send_data_->setWatermarks(high_watermark);
+      }
+    }
+
+    // The pending receive and send buffers are allocated on first use, so that streams which
+    // never buffer body data (e.g. header only requests or idle streams) do not carry two
+    // watermark buffers each.
+    Buffer::Instance& pendingRecvData() {
+      if (pending_recv_data_ == nullptr) {
+        pending_recv_data_ = createPendingBuffer(
+            [this]() -> void { this->pendingRecvBufferLowWatermark(); },
+            [this]() -> void { this->pendingRecvBufferHighWatermark(); });
+      }
+      return *pending_recv_data_;
+    }
+    Buffer::Instance& pendingSendData() {
+      if (pending_send_data_ == nullptr) {
+        pending_send_data_ = createPendingBuffer(
+            [this]() -> void { this->pendingSendBufferLowWatermark(); },
+            [this]() -> void { this->pendingSendBufferHighWatermark(); });
+      }
+      return *pending_send_data_;
+    }
+    uint64_t pendingRecvDataLength() const {
+      return pending_recv_data_ != nullptr ? pending_recv_data_->length() : 0;
+    }
+    uint64_t pendingSendDataLength() const {
+      return pending_send_data_ != nullptr ? pending_send_data_->length() : 0;
     }
 
     // If the receive buffer encounters watermark callbacks, enable/disable reads on this stream.
@@ -390,7 +421,8 @@ protected:
 
     bool buffersOverrun() const { return read_disable_count_ > 0; }
     bool shouldAllowPeerAdditionalStreamWindow() const {
-      return !buffersOverrun() && !pending_recv_data_->highWatermarkTriggered();
+      return !buffersOverrun() &&
+             (pending_recv_data_ == nullptr || !pending_recv_data_->highWatermarkTriggered());
     }
 
     void encodeDataHelper(Buffer::Instance& data, bool end_stream,
@@ -415,8 +447,11 @@ protected:
     Buffer::BufferMemoryAccountSharedPtr buffer_memory_account_;
     // This buffer may accumulate data and be drained in scheduleProcessingOfBufferedData.
     // See source/docs/flow_control.md for more information.
+    // Only access these through pendingRecvData() and pendingSendData(), which allocate them.
     Buffer::InstancePtr pending_recv_data_;
     Buffer::InstancePtr pending_send_data_;
+    // High watermark of the pending buffers, or 0 if unlimited.
+    uint32_t buffer_limit_{0};
     HeaderMapPtr pending_trailers_to_encode_;
     std::unique_ptr<MetadataDecoder> metadata_decoder_;
     std::unique_ptr<NewMetadataEncoder> metadata_encoder_;
@@ -463,7 +498,7 @@ protected:
   protected:
     // Http::MultiplexedStreamImplBase
     bool hasPendingData() override {
-      return pending_send_data_->length() > 0 || pending_trailers_to_encode_ != nullptr;
+      return pendingSendDataLength() > 0 || pending_trailers_to_encode_ != nullptr;
     }
     bool continueProcessingBufferedData() const {
       // We should stop processing buffered data if either
@@ -489,6 +524,10 @@ protected:
     // Marks data consumed by the stream, granting the peer additional stream
     // window.
     void grantPeerAdditionalStreamWindow();
+
+  private:
+    Buffer::InstancePtr createPendingBuffer(std::function<void()> below_low_watermark,
+                                            std::function<void()> above_high_watermark);
   };
 
   using StreamImplPtr = std::unique_ptr<StreamImpl>;
@@ -777,6 +816,14 @@ private:
 
   // Adds buffer fragment for a new outbound frame to the supplied Buffer::OwnedImpl.
   void addOutboundFrameFragment(Buffer::OwnedImpl& output, const uint8_t* data, size_t length);
+  // Returns the buffer that outbound frames should be serialized into. While the adapter is
+  // sending, this is outbound_frames_ so that all the frames produced by one sendPendingFrames()
+  // call reach the connection in a single write.
+  Buffer::OwnedImpl& outboundFramesBuffer(Buffer::OwnedImpl& unbatched) {
+    return batching_outbound_frames_ ? outbound_frames_ : unbatched;
+  }
+  // Writes the frames in output to the underlying connection, unless they are being batched.
+  void writeOutboundFrames(Buffer::OwnedImpl& output);
   Status trackInboundFrames(int32_t stream_id, size_t length, uint8_t type, uint8_t flags,
                             uint32_t padding_length);
   void onKeepaliveResponse();
@@ -791,8 +838,11 @@ private:
   // remove streams from the map when they are closed in order to avoid calls to resetStreamWorker
   // after the stream has been removed from the active list.
   std::map<int32_t, StreamImpl*> pending_deferred_reset_streams_;
+  // Frames serialized during adapter_->Send(), written to the connection once it returns.
+  Buffer::OwnedImpl outbound_frames_;
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
+  bool batching_outbound_frames_ : 1;
   Event::SchedulableCallbackPtr protocol_constraint_violation_callback_;
   Random::RandomGenerator& random_;
   MonotonicTime last_received_data_time_{};
@@ -31,10 +31,10 @@ namespace Network {
 
 UdpListenerImpl::UdpListenerImpl(Event::Dispatcher& dispatcher, SocketSharedPtr socket,
                                  UdpListenerCallbacks& cb, TimeSource& time_source,
-                                 const envoy::config::core::v3::UdpSocketConfig& config)
+                                 const envoy::config::core::v3::UdpSocketConfig& config,
+                                 bool prefer_gro_default)
     : BaseListenerImpl(dispatcher, std::move(socket)), cb_(cb), time_source_(time_source),
-      // Default prefer_gro to false for downstream server traffic.
-      config_(config, false) {
+      config_(config, prefer_gro_default) {
   parent_drained_callback_registrar_ = socket_->parentDrainedCallbackRegistrar();
   socket_->ioHandle().initializeFileEvent(
       dispatcher,
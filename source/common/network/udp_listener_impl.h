@@ -22,8 +22,10 @@ class UdpListenerImpl : public BaseListenerImpl,
                         public UdpPacketProcessor,
                         protected Logger::Loggable<Logger::Id::udp> {
 public:
+  // prefer_gro_default is whether to read with GRO when the config doesn't set prefer_gro.
   UdpListenerImpl(Event::Dispatcher& dispatcher, SocketSharedPtr socket, UdpListenerCallbacks& cb,
-                  TimeSource& time_source, const envoy::config::core::v3::UdpSocketConfig& config);
+                  TimeSource& time_source, const envoy::config::core::v3::UdpSocketConfig& config,
+                  bool prefer_gro_default);
   ~UdpListenerImpl() override;
   uint32_t packetsDropped() { return packets_dropped_; }
   bool paused() const { return parent_drained_callback_registrar_ != absl::nullopt; }
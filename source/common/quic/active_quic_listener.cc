@@ -43,7 +43,9 @@ ActiveQuicListener::ActiveQuicListener(
           worker_index, concurrency, parent, *listen_socket,
           std::make_unique<Network::UdpListenerImpl>(
               dispatcher, listen_socket, *this, dispatcher.timeSource(),
-              listener_config.udpListenerConfig()->config().downstream_socket_config()),
+              listener_config.udpListenerConfig()->config().downstream_socket_config(),
+              Runtime::runtimeFeatureEnabled(
+                  "envoy.reloadable_features.prefer_quic_server_udp_gro")),
           &listener_config),
       dispatcher_(dispatcher),
       version_manager_(reject_new_connections ? quic::ParsedQuicVersionVector()
@@ -102,7 +104,7 @@ ActiveQuicListener::ActiveQuicListener(
   // Create udp_packet_writer
   Network::UdpPacketWriterPtr udp_packet_writer =
       listener_config.udpListenerConfig()->packetWriterFactory().createUdpPacketWriter(
-          listen_socket_.ioHandle(), listener_config.listenerScope());
+          listen_socket_.ioHandle(), listener_config.listenerScope(), dispatcher_);
   udp_packet_writer_ = udp_packet_writer.get();
 
   // Some packet writers (like `UdpGsoBatchWriter`) already directly implement
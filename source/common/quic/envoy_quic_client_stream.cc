@@ -240,6 +240,13 @@ void EnvoyQuicClientStream::OnStreamFrame(const quic::QuicStreamFrame& frame) {
   quic::QuicSpdyClientStream::OnStreamFrame(frame);
 }
 
+void EnvoyQuicClientStream::OnDataAvailable() {
+  quic::QuicSpdyClientStream::OnDataAvailable();
+  // Free the sequencer buffer once all the received data has been consumed, so that an idle stream
+  // waiting for more data doesn't hold on to it.
+  sequencer()->ReleaseBufferIfEmpty();
+}
+
 bool EnvoyQuicClientStream::OnStopSending(quic::QuicResetStreamError error) {
   // Only called in IETF Quic to close write side.
   ENVOY_STREAM_LOG(debug, "received STOP_SENDING with reset code={}", *this,
@@ -43,6 +43,7 @@ public:
 
   // quic::QuicStream
   void OnStreamFrame(const quic::QuicStreamFrame& frame) override;
+  void OnDataAvailable() override;
   bool OnStopSending(quic::QuicResetStreamError error) override;
   // quic::QuicSpdyStream
   void OnBodyAvailable() override;
@@ -227,6 +227,13 @@ void EnvoyQuicServerStream::OnStreamFrame(const quic::QuicStreamFrame& frame) {
   quic::QuicSpdyServerStreamBase::OnStreamFrame(frame);
 }
 
+void EnvoyQuicServerStream::OnDataAvailable() {
+  quic::QuicSpdyServerStreamBase::OnDataAvailable();
+  // Free the sequencer buffer once all the received data has been consumed, so that an idle stream
+  // waiting for more data doesn't hold on to it.
+  sequencer()->ReleaseBufferIfEmpty();
+}
+
 void EnvoyQuicServerStream::OnBodyAvailable() {
   ASSERT(FinishedReadingHeaders());
   if (read_side_closed()) {
@@ -42,10 +42,7 @@ public:
         http3_options_(http3_options), quic_stream_(quic_stream), quic_session_(quic_session),
         send_buffer_simulation_(buffer_limit / 2, buffer_limit, std::move(below_low_watermark),
                                 std::move(above_high_watermark), ENVOY_LOGGER()),
-        filter_manager_connection_(filter_manager_connection),
-        async_stream_blockage_change_(
-            filter_manager_connection.dispatcher().createSchedulableCallback(
-                [this]() { switchStreamBlockState(); })) {}
+        filter_manager_connection_(filter_manager_connection) {}
 
   ~EnvoyQuicStream() override = default;
 
@@ -78,6 +75,11 @@ public:
     // stream will be spuriously unblocked and call OnDataAvailable(). This call shouldn't take any
     // effect because any available data should have been processed already upon arrival or they
     // were blocked by some condition other than flow control, i.e. Qpack decoding.
+    if (async_stream_blockage_change_ == nullptr) {
+      async_stream_blockage_change_ =
+          filter_manager_connection_.dispatcher().createSchedulableCallback(
+              [this]() { switchStreamBlockState(); });
+    }
     async_stream_blockage_change_->scheduleCallbackNextIteration();
   }
 
@@ -238,6 +240,7 @@ private:
   // Used to block or unblock stream in the next event loop. QUICHE doesn't like stream blockage
   // state change in its own call stack. And Envoy upstream doesn't like quic stream to be unblocked
   // in its callstack either because the stream will push data right away.
+  // Created upon the first readDisable() call, as most streams are never read disabled.
   Event::SchedulableCallbackPtr async_stream_blockage_change_;
 
   StreamInfo::BytesMeterSharedPtr bytes_meter_{std::make_shared<StreamInfo::BytesMeter>()};
@@ -93,7 +93,8 @@ private:
 class UdpGsoBatchWriterFactory : public Network::UdpPacketWriterFactory {
 public:
   Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
-                                                    Stats::Scope& scope) override;
+                                                    Stats::Scope& scope,
+                                                    Event::Dispatcher& dispatcher) override;
 
 private:
   envoy::config::core::v3::RuntimeFeatureFlag enabled_;
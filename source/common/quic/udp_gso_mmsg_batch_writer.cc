@@ -0,0 +1,252 @@
+#include "source/common/quic/udp_gso_mmsg_batch_writer.h"
+
+#include <cstring>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/safe_memcpy.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/utility.h"
+
+namespace Envoy {
+namespace Quic {
+
+UdpGsoMmsgBatchWriter::UdpGsoMmsgBatchWriter(Network::IoHandle& io_handle, Stats::Scope& scope,
+                                             Event::Dispatcher& dispatcher)
+    : io_handle_(io_handle), stats_({UDP_GSO_BATCH_WRITER_STATS(
+                                 POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))}),
+      gso_supported_(Api::OsSysCallsSingleton::get().supportsUdpGso()),
+      flush_callback_(dispatcher.createSchedulableCallback([this]() { flush(); })),
+      packet_data_(new char[MaxBufferedPackets * Network::UdpMaxOutgoingPacketSize]) {}
+
+Api::IoCallUint64Result
+UdpGsoMmsgBatchWriter::writePacket(const Buffer::Instance& buffer,
+                                   const Network::Address::Ip* local_ip,
+                                   const Network::Address::Instance& peer_address) {
+  if (write_blocked_) {
+    return {/*rc=*/0, /*err=*/Network::IoSocketError::getIoSocketEagainError()};
+  }
+  const uint64_t length = buffer.length();
+  if (length > Network::UdpMaxOutgoingPacketSize) {
+    // Doesn't fit in a packet slot. Keep the order of the packets by sending the buffered ones
+    // first.
+    Api::IoCallUint64Result result = flush();
+    if (!result.ok()) {
+      return result;
+    }
+    return Network::Utility::writeToSocket(io_handle_, buffer, local_ip, peer_address);
+  }
+  if (num_packets_ == MaxBufferedPackets) {
+    flush();
+    if (num_packets_ == MaxBufferedPackets) {
+      return {/*rc=*/0, /*err=*/Network::IoSocketError::getIoSocketEagainError()};
+    }
+  }
+
+  // QUIC connections serialize their packets directly in the slot that getNextWriteLocation()
+  // returns.
+  char* slot = packetSlot(num_packets_);
+  if (buffer.frontSlice().mem_ != slot) {
+    buffer.copyOut(0, length, slot);
+  }
+  BufferedPacket& packet = packets_[num_packets_];
+  packet.length_ = length;
+  memcpy(&packet.peer_address_, peer_address.sockAddr(), peer_address.sockAddrLen());
+  packet.peer_address_length_ = peer_address.sockAddrLen();
+  if (local_ip == nullptr) {
+    packet.self_address_ = absl::nullopt;
+  } else if (local_ip->version() == Network::Address::IpVersion::v4) {
+    packet.self_address_.emplace(Network::Address::IpVersion::v4, local_ip->ipv4()->address());
+  } else {
+    packet.self_address_.emplace(Network::Address::IpVersion::v6, local_ip->ipv6()->address());
+  }
+  ++num_packets_;
+  buffered_bytes_ += length;
+  stats_.internal_buffer_size_.set(buffered_bytes_);
+
+  if (!flush_callback_->enabled()) {
+    flush_callback_->scheduleCallbackCurrentIteration();
+  }
+  return {/*rc=*/length, /*err=*/Api::IoError::none()};
+}
+
+void UdpGsoMmsgBatchWriter::setWritable() {
+  write_blocked_ = false;
+  if (num_packets_ > 0 && !flush_callback_->enabled()) {
+    flush_callback_->scheduleCallbackCurrentIteration();
+  }
+}
+
+Network::UdpPacketWriterBuffer
+UdpGsoMmsgBatchWriter::getNextWriteLocation(const Network::Address::Ip* /*local_ip*/,
+                                            const Network::Address::Instance& /*peer_address*/) {
+  if (write_blocked_ || num_packets_ == MaxBufferedPackets) {
+    return {nullptr, 0, nullptr};
+  }
+  return {reinterpret_cast<uint8_t*>(packetSlot(num_packets_)), Network::UdpMaxOutgoingPacketSize,
+          nullptr};
+}
+
+Api::IoCallUint64Result UdpGsoMmsgBatchWriter::flush() {
+  if (num_packets_ == 0 || write_blocked_) {
+    return {/*rc=*/0, /*err=*/write_blocked_ ? Network::IoSocketError::getIoSocketEagainError()
+                                             : Api::IoError::none()};
+  }
+  const uint32_t num_messages = buildMessages();
+  uint32_t messages_done = 0;
+  uint32_t packets_done = 0;
+  uint64_t bytes_sent = 0;
+  while (messages_done < num_messages) {
+    const Api::SysCallIntResult result = Api::OsSysCallsSingleton::get().sendmmsg(
+        io_handle_.fdDoNotUse(), messages_.data() + messages_done, num_messages - messages_done,
+        0);
+    if (result.return_value_ <= 0) {
+      if (result.errno_ == SOCKET_ERROR_AGAIN) {
+        write_blocked_ = true;
+        break;
+      }
+      // The first remaining message can't be sent. Its packets are lost, as they would be if the
+      // network dropped them, and their connections retransmit them.
+      ENVOY_LOG_MISC(debug, "sendmmsg failed with error {}, dropping {} packets", result.errno_,
+                     packets_per_message_[messages_done]);
+      packets_done += packets_per_message_[messages_done];
+      ++messages_done;
+      continue;
+    }
+    uint32_t packets_sent = 0;
+    for (int i = 0; i < result.return_value_; ++i) {
+      packets_sent += packets_per_message_[messages_done + i];
+      bytes_sent += messages_[messages_done + i].msg_len;
+    }
+    stats_.pkts_sent_per_batch_.recordValue(packets_sent);
+    packets_done += packets_sent;
+    messages_done += result.return_value_;
+  }
+  dropPackets(packets_done);
+  stats_.total_bytes_sent_.add(bytes_sent);
+  stats_.internal_buffer_size_.set(buffered_bytes_);
+
+  if (write_blocked_) {
+    return {/*rc=*/bytes_sent, /*err=*/Network::IoSocketError::getIoSocketEagainError()};
+  }
+  return {/*rc=*/bytes_sent, /*err=*/Api::IoError::none()};
+}
+
+bool UdpGsoMmsgBatchWriter::sameAddresses(const BufferedPacket& lhs, const BufferedPacket& rhs) {
+  return lhs.self_address_ == rhs.self_address_ &&
+         lhs.peer_address_length_ == rhs.peer_address_length_ &&
+         memcmp(&lhs.peer_address_, &rhs.peer_address_, lhs.peer_address_length_) == 0;
+}
+
+uint32_t UdpGsoMmsgBatchWriter::buildMessages() {
+  uint32_t num_messages = 0;
+  uint32_t first = 0;
+  while (first < num_packets_) {
+    const BufferedPacket& first_packet = packets_[first];
+    // All the segments of a message but the last one have the size of the first one, and the last
+    // one may be shorter.
+    const uint64_t segment_size = first_packet.length_;
+    uint64_t message_bytes = segment_size;
+    uint32_t num_segments = 1;
+    while (gso_supported_ && first + num_segments < num_packets_ &&
+           num_segments < MaxSegmentsPerMessage &&
+           packets_[first + num_segments - 1].length_ == segment_size) {
+      const BufferedPacket& next = packets_[first + num_segments];
+      if (next.length_ > segment_size || message_bytes + next.length_ > MaxBytesPerMessage ||
+          !sameAddresses(first_packet, next)) {
+        break;
+      }
+      message_bytes += next.length_;
+      ++num_segments;
+    }
+
+    for (uint32_t i = first; i < first + num_segments; ++i) {
+      iovecs_[i].iov_base = packetSlot(i);
+      iovecs_[i].iov_len = packets_[i].length_;
+    }
+    msghdr& message = messages_[num_messages].msg_hdr;
+    message.msg_name = &packets_[first].peer_address_;
+    message.msg_namelen = first_packet.peer_address_length_;
+    message.msg_iov = &iovecs_[first];
+    message.msg_iovlen = num_segments;
+    message.msg_flags = 0;
+    buildControlMessages(message, control_buffers_[num_messages].data(), first_packet,
+                         num_segments);
+    messages_[num_messages].msg_len = 0;
+    packets_per_message_[num_messages] = num_segments;
+    ++num_messages;
+    first += num_segments;
+  }
+  return num_messages;
+}
+
+void UdpGsoMmsgBatchWriter::buildControlMessages(msghdr& message, char* control_buffer,
+                                                 const BufferedPacket& first_packet,
+                                                 uint32_t num_segments) {
+  size_t control_length = 0;
+  if (first_packet.self_address_.has_value()) {
+    control_length += first_packet.self_address_->first == Network::Address::IpVersion::v4
+                          ? CMSG_SPACE(sizeof(in_pktinfo))
+                          : CMSG_SPACE(sizeof(in6_pktinfo));
+  }
+  if (num_segments > 1) {
+    control_length += CMSG_SPACE(sizeof(uint16_t));
+  }
+  if (control_length == 0) {
+    message.msg_control = nullptr;
+    message.msg_controllen = 0;
+    return;
+  }
+  memset(control_buffer, 0, control_length);
+  message.msg_control = control_buffer;
+  message.msg_controllen = control_length;
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  if (first_packet.self_address_.has_value()) {
+    if (first_packet.self_address_->first == Network::Address::IpVersion::v4) {
+      cmsg->cmsg_level = IPPROTO_IP;
+      cmsg->cmsg_type = IP_PKTINFO;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+      auto* pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+      pktinfo->ipi_spec_dst.s_addr = static_cast<uint32_t>(first_packet.self_address_->second);
+    } else {
+      cmsg->cmsg_level = IPPROTO_IPV6;
+      cmsg->cmsg_type = IPV6_PKTINFO;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+      auto* pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+      safeMemcpyUnsafeDst(pktinfo->ipi6_addr.s6_addr, &first_packet.self_address_->second);
+    }
+    cmsg = CMSG_NXTHDR(&message, cmsg);
+  }
+  if (num_segments > 1) {
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    const uint16_t segment_size = first_packet.length_;
+    safeMemcpyUnsafeDst(CMSG_DATA(cmsg), &segment_size);
+  }
+}
+
+void UdpGsoMmsgBatchWriter::dropPackets(uint32_t num_packets) {
+  ASSERT(num_packets <= num_packets_);
+  const uint32_t num_remaining = num_packets_ - num_packets;
+  if (num_remaining > 0 && num_packets > 0) {
+    memmove(packetSlot(0), packetSlot(num_packets),
+            num_remaining * Network::UdpMaxOutgoingPacketSize);
+    std::move(packets_.begin() + num_packets, packets_.begin() + num_packets_, packets_.begin());
+  }
+  num_packets_ = num_remaining;
+  buffered_bytes_ = 0;
+  for (uint32_t i = 0; i < num_packets_; ++i) {
+    buffered_bytes_ += packets_[i].length_;
+  }
+}
+
+Network::UdpPacketWriterPtr
+UdpGsoMmsgBatchWriterFactory::createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                    Stats::Scope& scope,
+                                                    Event::Dispatcher& dispatcher) {
+  return std::make_unique<UdpGsoMmsgBatchWriter>(io_handle, scope, dispatcher);
+}
+
+} // namespace Quic
+} // namespace Envoy
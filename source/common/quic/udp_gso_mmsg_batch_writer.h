@@ -0,0 +1,112 @@
+#pragma once
+
+#include "source/common/quic/udp_gso_batch_writer.h"
+
+#if UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
+
+#include <array>
+#include <memory>
+
+#include "envoy/common/platform.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+
+#include "absl/numeric/int128.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Quic {
+
+/**
+ * UdpPacketWriter implementation which buffers the packets that all the connections of a worker
+ * write during an event loop iteration, and sends them at the end of the iteration with a single
+ * sendmmsg() system call. Consecutive packets with the same source and destination addresses are
+ * sent as one message, which the kernel splits into segments of the size of its first packet
+ * with UDP generic segmentation offload (GSO).
+ *
+ * The writer doesn't report itself as being in batch mode: QUIC connections flush a batch mode
+ * writer at the end of each of their writes, which with paced connections often carry one or two
+ * packets only, whereas this writer only flushes when its buffer is full, or at the end of the
+ * event loop iteration.
+ */
+class UdpGsoMmsgBatchWriter : public Network::UdpPacketWriter {
+public:
+  // The most packets that the writer buffers before it sends them.
+  static constexpr uint32_t MaxBufferedPackets = 128;
+  // The most segments and bytes that the kernel accepts in a message with UDP_SEGMENT.
+  static constexpr uint32_t MaxSegmentsPerMessage = 64;
+  static constexpr uint64_t MaxBytesPerMessage = 65507;
+
+  UdpGsoMmsgBatchWriter(Network::IoHandle& io_handle, Stats::Scope& scope,
+                        Event::Dispatcher& dispatcher);
+
+  // Network::UdpPacketWriter
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer,
+                                      const Network::Address::Ip* local_ip,
+                                      const Network::Address::Instance& peer_address) override;
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override;
+  uint64_t getMaxPacketSize(const Network::Address::Instance& /*peer_address*/) const override {
+    return Network::UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return false; }
+  Network::UdpPacketWriterBuffer
+  getNextWriteLocation(const Network::Address::Ip* local_ip,
+                       const Network::Address::Instance& peer_address) override;
+  Api::IoCallUint64Result flush() override;
+
+private:
+  struct BufferedPacket {
+    uint64_t length_;
+    sockaddr_storage peer_address_;
+    socklen_t peer_address_length_;
+    // The source address to send the packet from, or nullopt to let the kernel pick it.
+    absl::optional<std::pair<Network::Address::IpVersion, absl::uint128>> self_address_;
+  };
+
+  // Control message space for the source address and the segment size of a message.
+  static constexpr size_t ControlBufferSize =
+      CMSG_SPACE(sizeof(in6_pktinfo)) + CMSG_SPACE(sizeof(uint16_t));
+
+  char* packetSlot(uint32_t index) {
+    return packet_data_.get() + index * Network::UdpMaxOutgoingPacketSize;
+  }
+  static bool sameAddresses(const BufferedPacket& lhs, const BufferedPacket& rhs);
+  // Fills in the messages for the buffered packets and returns their number.
+  uint32_t buildMessages();
+  void buildControlMessages(msghdr& message, char* control_buffer,
+                            const BufferedPacket& first_packet, uint32_t num_segments);
+  // Forgets the first num_packets buffered packets, which have been sent or dropped.
+  void dropPackets(uint32_t num_packets);
+
+  Network::IoHandle& io_handle_;
+  UdpGsoBatchWriterStats stats_;
+  const bool gso_supported_;
+  Event::SchedulableCallbackPtr flush_callback_;
+  bool write_blocked_{false};
+
+  std::unique_ptr<char[]> packet_data_;
+  std::array<BufferedPacket, MaxBufferedPackets> packets_;
+  uint32_t num_packets_{0};
+  uint64_t buffered_bytes_{0};
+
+  // Scratch space for sendmmsg(), with at most one message per packet.
+  std::array<mmsghdr, MaxBufferedPackets> messages_;
+  std::array<uint32_t, MaxBufferedPackets> packets_per_message_;
+  std::array<iovec, MaxBufferedPackets> iovecs_;
+  alignas(cmsghdr) std::array<std::array<char, ControlBufferSize>, MaxBufferedPackets>
+      control_buffers_;
+};
+
+class UdpGsoMmsgBatchWriterFactory : public Network::UdpPacketWriterFactory {
+public:
+  Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                    Stats::Scope& scope,
+                                                    Event::Dispatcher& dispatcher) override;
+};
+
+} // namespace Quic
+} // namespace Envoy
+
+#endif // UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
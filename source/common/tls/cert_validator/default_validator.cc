@@ -97,7 +97,7 @@ absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_
           }
         }
         if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
+          addCrl(store, item->crl);
           has_crl = true;
         }
       }
@@ -144,7 +144,7 @@ absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_
       X509_STORE_set_flags(store, X509_V_FLAG_PARTIAL_CHAIN);
       for (const X509_INFO* item : list.get()) {
         if (item->crl) {
-          X509_STORE_add_crl(store, item->crl);
+          addCrl(store, item->crl);
         }
       }
       X509_STORE_set_flags(store, config_->onlyVerifyLeafCertificateCrl()
@@ -196,9 +196,33 @@ absl::StatusOr<int> DefaultCertValidator::initializeSslContexts(std::vector<SSL_
     }
   }
 
+  if (verify_trusted_ca_ && config_->verifiedChainCacheSize() > 0) {
+    verified_chain_cache_ = std::make_unique<VerifiedChainCache>(
+        config_->verifiedChainCacheSize(), context_.timeSource());
+  }
+
   return verify_mode;
 }
 
+void DefaultCertValidator::addCrl(X509_STORE* store, X509_CRL* crl) {
+  X509_STORE_add_crl(store, crl);
+  const absl::optional<SystemTime> next_update = Utility::getNextUpdateTime(*crl);
+  if (next_update.has_value() &&
+      (!crl_next_update_.has_value() || *next_update < *crl_next_update_)) {
+    crl_next_update_ = next_update;
+  }
+}
+
+SystemTime DefaultCertValidator::verifiedChainExpiration(X509_STORE_CTX* ctx) const {
+  SystemTime expiration = crl_next_update_.value_or(SystemTime::max());
+  if (!config_->allowExpiredCertificate()) {
+    for (const X509* cert : X509_STORE_CTX_get0_chain(ctx)) {
+      expiration = std::min(expiration, Utility::getExpirationTime(*cert));
+    }
+  }
+  return expiration;
+}
+
 bool DefaultCertValidator::verifyCertAndUpdateStatus(
     X509* leaf_cert, absl::string_view sni,
     const Network::TransportSocketOptions* transport_socket_options,
@@ -312,39 +336,55 @@ ValidationResults DefaultCertValidator::doVerifyCertChain(
   X509* leaf_cert = sk_X509_value(&cert_chain, 0);
   ASSERT(leaf_cert);
   if (verify_trusted_ca_) {
-    X509_STORE* verify_store = SSL_CTX_get_cert_store(&ssl_ctx);
-    ASSERT(verify_store);
-    bssl::UniquePtr<X509_STORE_CTX> ctx(X509_STORE_CTX_new());
-    if (!ctx || !X509_STORE_CTX_init(ctx.get(), verify_store, leaf_cert, &cert_chain) ||
-        // We need to inherit the verify parameters. These can be determined by
-        // the context: if it's a server it will verify SSL client certificates or
-        // vice versa.
-        !X509_STORE_CTX_set_default(ctx.get(), is_server ? "ssl_client" : "ssl_server") ||
-        // Anything non-default in "param" should overwrite anything in the ctx.
-        !X509_VERIFY_PARAM_set1(X509_STORE_CTX_get0_param(ctx.get()),
-                                SSL_CTX_get0_param(&ssl_ctx))) {
-      OPENSSL_PUT_ERROR(SSL, ERR_R_X509_LIB);
-      const char* error = "verify cert failed: init and setup X509_STORE_CTX";
-      stats_.fail_verify_error_.inc();
-      ENVOY_LOG(debug, error);
-      return {ValidationResults::ValidationStatus::Failed,
-              Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt, error};
+    std::string cache_key;
+    bool verified = false;
+    if (verified_chain_cache_ != nullptr) {
+      cache_key = VerifiedChainCache::key(cert_chain, is_server);
+      verified = verified_chain_cache_->lookup(cache_key);
+      if (verified) {
+        stats_.verified_chain_cache_hit_.inc();
+      } else {
+        stats_.verified_chain_cache_miss_.inc();
+      }
     }
-    const bool verify_succeeded = (X509_verify_cert(ctx.get()) == 1);
-
-    if (!verify_succeeded) {
-      const std::string error =
-          absl::StrCat("verify cert failed: ", Utility::getX509VerificationErrorInfo(ctx.get()));
-      stats_.fail_verify_error_.inc();
-      ENVOY_LOG(debug, error);
-      if (allow_untrusted_certificate_) {
-        return ValidationResults{ValidationResults::ValidationStatus::Successful,
-                                 Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt,
-                                 absl::nullopt};
+    if (!verified) {
+      X509_STORE* verify_store = SSL_CTX_get_cert_store(&ssl_ctx);
+      ASSERT(verify_store);
+      bssl::UniquePtr<X509_STORE_CTX> ctx(X509_STORE_CTX_new());
+      if (!ctx || !X509_STORE_CTX_init(ctx.get(), verify_store, leaf_cert, &cert_chain) ||
+          // We need to inherit the verify parameters. These can be determined by
+          // the context: if it's a server it will verify SSL client certificates or
+          // vice versa.
+          !X509_STORE_CTX_set_default(ctx.get(), is_server ? "ssl_client" : "ssl_server") ||
+          // Anything non-default in "param" should overwrite anything in the ctx.
+          !X509_VERIFY_PARAM_set1(X509_STORE_CTX_get0_param(ctx.get()),
+                                  SSL_CTX_get0_param(&ssl_ctx))) {
+        OPENSSL_PUT_ERROR(SSL, ERR_R_X509_LIB);
+        const char* error = "verify cert failed: init and setup X509_STORE_CTX";
+        stats_.fail_verify_error_.inc();
+        ENVOY_LOG(debug, error);
+        return {ValidationResults::ValidationStatus::Failed,
+                Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt, error};
+      }
+      const bool verify_succeeded = (X509_verify_cert(ctx.get()) == 1);
+
+      if (!verify_succeeded) {
+        const std::string error =
+            absl::StrCat("verify cert failed: ", Utility::getX509VerificationErrorInfo(ctx.get()));
+        stats_.fail_verify_error_.inc();
+        ENVOY_LOG(debug, error);
+        if (allow_untrusted_certificate_) {
+          return ValidationResults{ValidationResults::ValidationStatus::Successful,
+                                   Envoy::Ssl::ClientValidationStatus::Failed, absl::nullopt,
+                                   absl::nullopt};
+        }
+        return {ValidationResults::ValidationStatus::Failed,
+                Envoy::Ssl::ClientValidationStatus::Failed,
+                SSL_alert_from_verify_result(X509_STORE_CTX_get_error(ctx.get())), error};
+      }
+      if (verified_chain_cache_ != nullptr) {
+        verified_chain_cache_->insert(cache_key, verifiedChainExpiration(ctx.get()));
       }
-      return {ValidationResults::ValidationStatus::Failed,
-              Envoy::Ssl::ClientValidationStatus::Failed,
-              SSL_alert_from_verify_result(X509_STORE_CTX_get_error(ctx.get())), error};
     }
     detailed_status = Envoy::Ssl::ClientValidationStatus::Validated;
   }
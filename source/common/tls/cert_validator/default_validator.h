@@ -21,6 +21,7 @@
 #include "source/common/stats/symbol_table.h"
 #include "source/common/tls/cert_validator/cert_validator.h"
 #include "source/common/tls/cert_validator/san_matcher.h"
+#include "source/common/tls/cert_validator/verified_chain_cache.h"
 #include "source/common/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -109,6 +110,10 @@ private:
                                  Envoy::Ssl::ClientValidationStatus& detailed_status,
                                  std::string* error_details, uint8_t* out_alert);
 
+  // Returns the time until which a chain that was verified by ctx keeps verifying.
+  SystemTime verifiedChainExpiration(X509_STORE_CTX* ctx) const;
+  void addCrl(X509_STORE* store, X509_CRL* crl);
+
   const Envoy::Ssl::CertificateValidationContextConfig* config_;
   SslStats& stats_;
   Server::Configuration::CommonFactoryContext& context_;
@@ -121,6 +126,9 @@ private:
   bool allow_untrusted_certificate_{false};
   bool verify_trusted_ca_{false};
   const bool auto_sni_san_match_{false};
+  // The earliest next update time of the CRLs.
+  absl::optional<SystemTime> crl_next_update_;
+  VerifiedChainCachePtr verified_chain_cache_;
 };
 
 DECLARE_FACTORY(DefaultCertValidatorFactory);
@@ -0,0 +1,56 @@
+#include "source/common/tls/cert_validator/verified_chain_cache.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/tls/utility.h"
+
+#include "openssl/sha.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+VerifiedChainCache::VerifiedChainCache(uint32_t max_entries, TimeSource& time_source)
+    : time_source_(time_source), entries_(max_entries) {}
+
+std::string VerifiedChainCache::key(STACK_OF(X509)& cert_chain, bool is_server) {
+  bssl::ScopedEVP_MD_CTX md;
+  int rc = EVP_DigestInit(md.get(), EVP_sha256());
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  // A chain is verified for a different purpose by server and client contexts.
+  rc = EVP_DigestUpdate(md.get(), &is_server, sizeof(is_server));
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  for (X509* cert : &cert_chain) {
+    // The certificates keep their received encoding, so this does not re-encode them.
+    uint8_t* der = nullptr;
+    const int der_length = i2d_X509(cert, &der);
+    RELEASE_ASSERT(der_length > 0, Utility::getLastCryptoError().value_or(""));
+    // Length prefixes keep the boundaries of the certificates in the digest.
+    const uint32_t length = der_length;
+    rc = EVP_DigestUpdate(md.get(), &length, sizeof(length)) &&
+         EVP_DigestUpdate(md.get(), der, der_length);
+    OPENSSL_free(der);
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+  }
+
+  std::string key(SHA256_DIGEST_LENGTH, '\0');
+  unsigned key_length;
+  rc = EVP_DigestFinal(md.get(), reinterpret_cast<uint8_t*>(key.data()), &key_length);
+  RELEASE_ASSERT(rc == 1 && key_length == SHA256_DIGEST_LENGTH,
+                 Utility::getLastCryptoError().value_or(""));
+  return key;
+}
+
+bool VerifiedChainCache::lookup(absl::string_view key) {
+  const SystemTime now = time_source_.systemTime();
+  return entries_.lookup(key, [now](SystemTime& expiration) { return expiration > now; });
+}
+
+void VerifiedChainCache::insert(absl::string_view key, SystemTime expiration) {
+  entries_.insert(key, expiration);
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+
+#include "source/common/common/sharded_lru_cache.h"
+
+#include "absl/strings/string_view.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A bounded cache of the certificate chains that a validator verified against its trusted CAs and
+ * CRLs, so that the chain that many peers present is only verified once. The cache belongs to a
+ * validator, whose CAs and CRLs do not change, and is shared by all the workers. An entry expires
+ * when the chain would no longer verify, i.e. when one of its certificates or one of the CRLs
+ * expires. The least recently used chains are evicted once the cache holds max_entries of them.
+ */
+class VerifiedChainCache {
+public:
+  VerifiedChainCache(uint32_t max_entries, TimeSource& time_source);
+
+  /**
+   * @return the key of a chain presented by a peer, a digest of its certificates.
+   */
+  static std::string key(STACK_OF(X509)& cert_chain, bool is_server);
+
+  /**
+   * @return whether the chain of the key was verified and has not expired since.
+   */
+  bool lookup(absl::string_view key);
+
+  /**
+   * Remembers that the chain of the key was verified, until the given time.
+   */
+  void insert(absl::string_view key, SystemTime expiration);
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  TimeSource& time_source_;
+  // The expiration times of the chains.
+  ShardedLruCache<std::string, SystemTime> entries_;
+};
+
+using VerifiedChainCachePtr = std::unique_ptr<VerifiedChainCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
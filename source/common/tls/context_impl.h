@@ -93,6 +93,21 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return whether the record layer of the connections is handed to the kernel after the
+   * handshake.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
+  /**
+   * @return the dynamic record sizing settings of the connections, or nullopt if the connections
+   * write records as large as possible.
+   */
+  const absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing>&
+  dynamicRecordSizing() const {
+    return dynamic_record_sizing_;
+  }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -173,6 +188,8 @@ protected:
   const Network::Address::IpList tls_keylog_local_;
   const Network::Address::IpList tls_keylog_remote_;
   AccessLog::AccessLogFileSharedPtr tls_keylog_file_;
+  bool kernel_tls_offload_{};
+  absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
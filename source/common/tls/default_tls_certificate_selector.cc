@@ -12,7 +12,10 @@ DefaultTlsCertificateSelector::DefaultTlsCertificateSelector(
     : server_ctx_(dynamic_cast<ServerContextImpl&>(selector_ctx)),
       tls_contexts_(selector_ctx.getTlsContexts()), ocsp_staple_policy_(config.ocspStaplePolicy()),
       full_scan_certs_on_sni_mismatch_(config.fullScanCertsOnSNIMismatch()) {
-  for (auto& ctx : tls_contexts_) {
+  server_names_map_.reserve(tls_contexts_.size());
+  for (size_t i = 0; i < tls_contexts_.size(); i++) {
+    const auto& ctx = tls_contexts_[i];
+    contexts_by_curve_[ctx.ec_group_curve_name_].push_back(i);
     if (ctx.cert_chain_ == nullptr) {
       continue;
     }
@@ -20,7 +23,6 @@ DefaultTlsCertificateSelector::DefaultTlsCertificateSelector(
     const int pkey_id = EVP_PKEY_id(public_key.get());
     // Load DNS SAN entries and Subject Common Name as server name patterns after certificate
     // chain loaded, and populate ServerNamesMap which will be used to match SNI.
-    has_rsa_ |= (pkey_id == EVP_PKEY_RSA);
     populateServerNamesMap(ctx, pkey_id);
   }
 };
@@ -31,36 +33,30 @@ void DefaultTlsCertificateSelector::populateServerNamesMap(const Ssl::TlsContext
     return;
   }
 
-  auto populate = [&](const std::string& sn) {
-    std::string sn_pattern = sn;
+  auto populate = [&](absl::string_view sn) {
+    absl::string_view sn_pattern = sn;
     if (absl::StartsWith(sn, "*.")) {
       sn_pattern = sn.substr(1);
     }
-    PkeyTypesMap pkey_types_map;
-    // Multiple certs with different key type are allowed for one server name pattern.
-    auto sn_match = server_names_map_.try_emplace(sn_pattern, pkey_types_map).first;
-    auto pt_match = sn_match->second.find(pkey_id);
-    if (pt_match != sn_match->second.end()) {
-      // When there are duplicate names, prefer the earlier one.
-      //
-      // If all of the SANs in a certificate are unused due to duplicates, it could be useful
-      // to issue a warning, but that would require additional tracking that hasn't been
-      // implemented.
-      return;
-    }
-    sn_match->second.emplace(
-        std::pair<int, std::reference_wrapper<const Ssl::TlsContext>>(pkey_id, ctx));
+    // Multiple certs with different key type are allowed for one server name pattern. When there
+    // are duplicate names, prefer the earlier one, which try_emplace() keeps.
+    //
+    // If all of the SANs in a certificate are unused due to duplicates, it could be useful
+    // to issue a warning, but that would require additional tracking that hasn't been
+    // implemented.
+    server_names_map_[sn_pattern].try_emplace(pkey_id, ctx);
   };
 
   bssl::UniquePtr<GENERAL_NAMES> san_names(static_cast<GENERAL_NAMES*>(
       X509_get_ext_d2i(ctx.cert_chain_.get(), NID_subject_alt_name, nullptr, nullptr)));
   if (san_names != nullptr) {
-    auto dns_sans = Utility::getSubjectAltNames(*ctx.cert_chain_, GEN_DNS);
     // https://www.rfc-editor.org/rfc/rfc6066#section-3
     // Currently, the only server names supported are DNS hostnames, so we
     // only save dns san entries to match SNI.
-    for (const auto& san : dns_sans) {
-      populate(san);
+    for (const GENERAL_NAME* san : san_names.get()) {
+      if (san->type == GEN_DNS) {
+        populate(Utility::generalNameAsString(san));
+      }
     }
   } else {
     // https://www.rfc-editor.org/rfc/rfc6125#section-6.4.4
@@ -162,6 +158,21 @@ Ssl::OcspStapleAction DefaultTlsCertificateSelector::ocspStapleAction(const Ssl:
   PANIC_DUE_TO_CORRUPT_ENUM;
 }
 
+size_t DefaultTlsCertificateSelector::firstContextWithCurve(int curve_nid,
+                                                           bool client_ocsp_capable) {
+  auto it = contexts_by_curve_.find(curve_nid);
+  if (it == contexts_by_curve_.end()) {
+    return tls_contexts_.size();
+  }
+  for (const size_t index : it->second) {
+    if (ocspStapleAction(tls_contexts_[index], client_ocsp_capable) !=
+        Ssl::OcspStapleAction::Fail) {
+      return index;
+    }
+  }
+  return tls_contexts_.size();
+}
+
 std::pair<const Ssl::TlsContext&, Ssl::OcspStapleAction>
 DefaultTlsCertificateSelector::findTlsContext(absl::string_view sni,
                                               const Ssl::CurveNIDVector& client_ecdsa_capabilities,
@@ -264,15 +275,21 @@ DefaultTlsCertificateSelector::findTlsContext(absl::string_view sni,
   // Full scan certs if SNI is not provided by client;
   // Full scan certs if client provides SNI but no cert matches to it,
   // it requires full_scan_certs_on_sni_mismatch is enabled.
+  //
+  // The scan selects the first cert that complies with the OCSP policy and has one of the curves
+  // of the client, or else the first such RSA cert. Rather than going through all certs, only the
+  // certs of these curves are looked at, in order.
   if (selected_ctx == nullptr) {
-    candidate_ctx = nullptr;
-    // Skip loop when there is no cert compatible to key type
-    if (client_ecdsa_capable || (!client_ecdsa_capable && has_rsa_)) {
-      for (const auto& ctx : tls_contexts_) {
-        if (selected(ctx)) {
-          break;
-        }
-      }
+    size_t index = tls_contexts_.size();
+    for (const int curve_nid : client_ecdsa_capabilities) {
+      index = std::min(index, firstContextWithCurve(curve_nid, client_ocsp_capable));
+    }
+    if (index == tls_contexts_.size()) {
+      index = firstContextWithCurve(Ssl::EC_CURVE_INVALID_NID, client_ocsp_capable);
+    }
+    if (index < tls_contexts_.size()) {
+      selected_ctx = &tls_contexts_[index];
+      ocsp_staple_action = ocspStapleAction(*selected_ctx, client_ocsp_capable);
     }
     tail_select(false);
   }
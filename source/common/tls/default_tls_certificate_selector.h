@@ -47,12 +47,20 @@ private:
 
   Ssl::OcspStapleAction ocspStapleAction(const Ssl::TlsContext& ctx, bool client_ocsp_capable);
 
+  // Returns the index of the first context with a certificate of the given curve, or
+  // Ssl::EC_CURVE_INVALID_NID for RSA, that complies with the OCSP policy. Returns the number of
+  // contexts if there is none.
+  size_t firstContextWithCurve(int curve_nid, bool client_ocsp_capable);
+
   // ServerContext own this selector, it's safe to use itself here.
   ServerContextImpl& server_ctx_;
   const std::vector<Ssl::TlsContext>& tls_contexts_;
 
   ServerNamesMap server_names_map_;
-  bool has_rsa_{false};
+  // The indexes of the contexts by the curve of their certificate, in the order of the contexts.
+  // This lets a context be selected without SNI without scanning all of the contexts, which may be
+  // many thousands.
+  absl::flat_hash_map<int, std::vector<size_t>> contexts_by_curve_;
 
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
   bool full_scan_certs_on_sni_mismatch_;
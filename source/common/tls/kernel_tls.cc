@@ -0,0 +1,281 @@
+#include "source/common/tls/kernel_tls.h"
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "openssl/hkdf.h"
+#include "openssl/mem.h"
+#include "openssl/span.h"
+
+#ifdef __linux__
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr size_t MaxKeyLength = 32;
+constexpr size_t NonceLength = 12;
+
+// The traffic key of one direction of a connection. The nonce is laid out as the kernel expects
+// it, the salt followed by the IV.
+struct TrafficKey {
+  ~TrafficKey() { OPENSSL_cleanse(this, sizeof(*this)); }
+
+  std::array<uint8_t, MaxKeyLength> key_{};
+  std::array<uint8_t, NonceLength> nonce_{};
+  uint64_t sequence_{};
+};
+
+struct Cipher {
+  uint16_t type_;
+  size_t key_length_;
+  size_t salt_length_;
+};
+
+absl::optional<Cipher> kernelCipher(const SSL_CIPHER* cipher) {
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    return Cipher{TLS_CIPHER_AES_GCM_128, TLS_CIPHER_AES_GCM_128_KEY_SIZE,
+                  TLS_CIPHER_AES_GCM_128_SALT_SIZE};
+  case NID_aes_256_gcm:
+    return Cipher{TLS_CIPHER_AES_GCM_256, TLS_CIPHER_AES_GCM_256_KEY_SIZE,
+                  TLS_CIPHER_AES_GCM_256_SALT_SIZE};
+  case NID_chacha20_poly1305:
+    return Cipher{TLS_CIPHER_CHACHA20_POLY1305, TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE,
+                  TLS_CIPHER_CHACHA20_POLY1305_SALT_SIZE};
+  default:
+    return absl::nullopt;
+  }
+}
+
+void storeBigEndian(uint8_t* out, uint64_t value) {
+  for (int i = 7; i >= 0; i--) {
+    out[i] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+// HKDF-Expand-Label with an empty context, RFC 8446 section 7.1.
+bool hkdfExpandLabel(uint8_t* out, size_t out_length, const EVP_MD* digest,
+                     bssl::Span<const uint8_t> secret, absl::string_view label) {
+  const std::string full_label = absl::StrCat("tls13 ", label);
+  std::vector<uint8_t> info = {static_cast<uint8_t>(out_length >> 8),
+                               static_cast<uint8_t>(out_length),
+                               static_cast<uint8_t>(full_label.size())};
+  info.insert(info.end(), full_label.begin(), full_label.end());
+  info.push_back(0);
+  return HKDF_expand(out, out_length, digest, secret.data(), secret.size(), info.data(),
+                     info.size()) == 1;
+}
+
+// The traffic key and IV of TLSv1.3 are derived from the traffic secret, RFC 8446 section 7.3.
+bool tls13TrafficKey(const SSL_CIPHER* ssl_cipher, const Cipher& cipher,
+                     bssl::Span<const uint8_t> secret, uint64_t sequence, TrafficKey& key) {
+  const EVP_MD* digest = SSL_CIPHER_get_handshake_digest(ssl_cipher);
+  key.sequence_ = sequence;
+  return digest != nullptr &&
+         hkdfExpandLabel(key.key_.data(), cipher.key_length_, digest, secret, "key") &&
+         hkdfExpandLabel(key.nonce_.data(), NonceLength, digest, secret, "iv");
+}
+
+// The traffic keys of TLSv1.2 come from the key block, which holds the client and server write
+// keys followed by their fixed IVs for the AEAD ciphers, RFC 5246 section 6.3.
+bool tls12TrafficKeys(SSL* ssl, const Cipher& cipher, TrafficKey& read_key,
+                      TrafficKey& write_key) {
+  // AES-GCM has a 4 byte fixed IV, the salt, and an 8 byte explicit nonce that BoringSSL sets to
+  // the sequence number. ChaCha20-Poly1305 has a 12 byte fixed IV.
+  const size_t fixed_iv_length = cipher.salt_length_ == 0 ? NonceLength : cipher.salt_length_;
+  std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl));
+  if (key_block.size() != 2 * (cipher.key_length_ + fixed_iv_length) ||
+      SSL_generate_key_block(ssl, key_block.data(), key_block.size()) != 1) {
+    return false;
+  }
+
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + cipher.key_length_;
+  const uint8_t* client_iv = server_key + cipher.key_length_;
+  const uint8_t* server_iv = client_iv + fixed_iv_length;
+  const auto set_key = [&](TrafficKey& key, const uint8_t* cipher_key, const uint8_t* fixed_iv,
+                           uint64_t sequence) {
+    memcpy(key.key_.data(), cipher_key, cipher.key_length_);
+    memcpy(key.nonce_.data(), fixed_iv, fixed_iv_length);
+    if (fixed_iv_length < NonceLength) {
+      storeBigEndian(key.nonce_.data() + fixed_iv_length, sequence);
+    }
+    key.sequence_ = sequence;
+  };
+  const bool is_server = SSL_is_server(ssl);
+  set_key(read_key, is_server ? client_key : server_key, is_server ? client_iv : server_iv,
+          SSL_get_read_sequence(ssl));
+  set_key(write_key, is_server ? server_key : client_key, is_server ? server_iv : client_iv,
+          SSL_get_write_sequence(ssl));
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  return true;
+}
+
+template <class CryptoInfo>
+Api::SysCallIntResult setCryptoInfo(Network::IoHandle& io_handle, int direction, uint16_t version,
+                                    uint16_t cipher_type, const TrafficKey& key) {
+  static_assert(sizeof(CryptoInfo::key) <= MaxKeyLength);
+  static_assert(sizeof(CryptoInfo::salt) + sizeof(CryptoInfo::iv) == NonceLength);
+  CryptoInfo info{};
+  info.info.version = version;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key.key_.data(), sizeof(info.key));
+  memcpy(info.salt, key.nonce_.data(), sizeof(info.salt));
+  memcpy(info.iv, key.nonce_.data() + sizeof(info.salt), sizeof(info.iv));
+  storeBigEndian(info.rec_seq, key.sequence_);
+  const Api::SysCallIntResult result = io_handle.setOption(SOL_TLS, direction, &info, sizeof(info));
+  OPENSSL_cleanse(&info, sizeof(info));
+  return result;
+}
+
+Api::SysCallIntResult setTrafficKey(Network::IoHandle& io_handle, int direction, uint16_t version,
+                                    const Cipher& cipher, const TrafficKey& key) {
+  switch (cipher.type_) {
+  case TLS_CIPHER_AES_GCM_128:
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_128>(io_handle, direction, version,
+                                                         cipher.type_, key);
+  case TLS_CIPHER_AES_GCM_256:
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_256>(io_handle, direction, version,
+                                                         cipher.type_, key);
+  default:
+    return setCryptoInfo<tls12_crypto_info_chacha20_poly1305>(io_handle, direction, version,
+                                                              cipher.type_, key);
+  }
+}
+
+} // namespace
+
+absl::Status enable(SSL* ssl, Network::IoHandle& io_handle) {
+  const uint16_t version = SSL_version(ssl);
+  if (version != TLS1_2_VERSION && version != TLS1_3_VERSION) {
+    return absl::FailedPreconditionError(
+        absl::StrCat("unsupported TLS version ", SSL_get_version(ssl)));
+  }
+  const SSL_CIPHER* ssl_cipher = SSL_get_current_cipher(ssl);
+  const absl::optional<Cipher> cipher = kernelCipher(ssl_cipher);
+  if (!cipher.has_value()) {
+    return absl::FailedPreconditionError(
+        absl::StrCat("unsupported cipher ", SSL_CIPHER_get_name(ssl_cipher)));
+  }
+  // The kernel only sees the records that are still in the socket.
+  if (SSL_has_pending(ssl) || SSL_in_early_data(ssl)) {
+    return absl::FailedPreconditionError("records are buffered by BoringSSL");
+  }
+
+  TrafficKey read_key;
+  TrafficKey write_key;
+  bool derived;
+  if (version == TLS1_3_VERSION) {
+    bssl::Span<const uint8_t> read_secret;
+    bssl::Span<const uint8_t> write_secret;
+    derived = bssl::SSL_get_traffic_secrets(ssl, &read_secret, &write_secret) &&
+              tls13TrafficKey(ssl_cipher, *cipher, read_secret, SSL_get_read_sequence(ssl),
+                              read_key) &&
+              tls13TrafficKey(ssl_cipher, *cipher, write_secret, SSL_get_write_sequence(ssl),
+                              write_key);
+  } else {
+    derived = tls12TrafficKeys(ssl, *cipher, read_key, write_key);
+  }
+  if (!derived) {
+    return absl::FailedPreconditionError("failed to derive the traffic keys");
+  }
+
+  static constexpr char Ulp[] = "tls";
+  Api::SysCallIntResult result = io_handle.setOption(IPPROTO_TCP, TCP_ULP, Ulp, sizeof(Ulp));
+  if (result.return_value_ != 0) {
+    return absl::FailedPreconditionError(
+        absl::StrCat("failed to attach the TLS ULP: ", errorDetails(result.errno_)));
+  }
+  // The socket behaves as a plain TCP socket until a direction has a key, so the connection can
+  // still fall back to BoringSSL if the kernel rejects the first one.
+  result = setTrafficKey(io_handle, TLS_RX, version, *cipher, read_key);
+  if (result.return_value_ != 0) {
+    return absl::FailedPreconditionError(
+        absl::StrCat("failed to set the receive key: ", errorDetails(result.errno_)));
+  }
+  result = setTrafficKey(io_handle, TLS_TX, version, *cipher, write_key);
+  if (result.return_value_ != 0) {
+    return absl::InternalError(
+        absl::StrCat("failed to set the transmit key: ", errorDetails(result.errno_)));
+  }
+  return absl::OkStatus();
+}
+
+Api::SysCallSizeResult read(Network::IoHandle& io_handle, Buffer::RawSlice slice,
+                            uint8_t& record_type) {
+  iovec iov{slice.mem_, slice.len_};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().recvmsg(io_handle.fdDoNotUse(), &message, 0);
+
+  record_type = ApplicationDataRecordType;
+  const cmsghdr* cmsg = result.return_value_ > 0 ? CMSG_FIRSTHDR(&message) : nullptr;
+  if (cmsg != nullptr && cmsg->cmsg_level == SOL_TLS && cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+    record_type = *CMSG_DATA(cmsg);
+  }
+  return result;
+}
+
+Api::SysCallSizeResult sendCloseNotify(Network::IoHandle& io_handle) {
+  // A close_notify alert has the warning level, RFC 5246 section 7.2.1.
+  uint8_t alert[] = {SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY};
+  iovec iov{alert, sizeof(alert)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))]{};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = AlertRecordType;
+  return Api::OsSysCallsSingleton::get().sendmsg(io_handle.fdDoNotUse(), &message, 0);
+}
+
+#else
+
+absl::Status enable(SSL*, Network::IoHandle&) {
+  return absl::FailedPreconditionError("kernel TLS is only supported on Linux");
+}
+
+Api::SysCallSizeResult read(Network::IoHandle&, Buffer::RawSlice, uint8_t&) {
+  return {-1, SOCKET_ERROR_NOT_SUP};
+}
+
+Api::SysCallSizeResult sendCloseNotify(Network::IoHandle&) { return {-1, SOCKET_ERROR_NOT_SUP}; }
+
+#endif
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
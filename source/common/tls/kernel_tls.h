@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/network/io_handle.h"
+
+#include "absl/status/status.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+// The TLS record content types, RFC 8446 section 5.1.
+constexpr uint8_t AlertRecordType = 21;
+constexpr uint8_t HandshakeRecordType = 22;
+constexpr uint8_t ApplicationDataRecordType = 23;
+
+/**
+ * Hands the record layer of an established TLS connection to the Linux kernel TLS ULP, so that
+ * the kernel encrypts what is written to the socket and decrypts what is read from it. This is
+ * supported for TLSv1.2 and TLSv1.3 with the AES-GCM and ChaCha20-Poly1305 ciphers, once
+ * BoringSSL has no record of the connection buffered.
+ * @param ssl the connection, whose handshake is complete.
+ * @param io_handle the TCP socket of the connection.
+ * @return OK if the kernel took over both directions. A FailedPrecondition error if the kernel
+ * took over neither, in which case the connection keeps using BoringSSL. Any other error if the
+ * kernel took over only one direction, in which case the connection can't be used anymore.
+ */
+absl::Status enable(SSL* ssl, Network::IoHandle& io_handle);
+
+/**
+ * Reads the plaintext of the next records of a socket whose receive direction was handed to the
+ * kernel. The records read at once all have the same type.
+ * @param io_handle the socket.
+ * @param slice receives the plaintext.
+ * @param record_type receives the type of the records that were read.
+ * @return the number of bytes read, 0 at the end of the stream, or an error.
+ */
+Api::SysCallSizeResult read(Network::IoHandle& io_handle, Buffer::RawSlice slice,
+                            uint8_t& record_type);
+
+/**
+ * Sends a close_notify alert on a socket whose transmit direction was handed to the kernel.
+ */
+Api::SysCallSizeResult sendCloseNotify(Network::IoHandle& io_handle);
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,262 @@
+#include "source/common/tls/private_key/batched_private_key_provider.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+PrivateKeyOperation::PrivateKeyOperation(Type type, uint16_t signature_algorithm,
+                                         const uint8_t* in, size_t in_len,
+                                         Ssl::PrivateKeyConnectionCallbacks& callbacks)
+    : type_(type), signature_algorithm_(signature_algorithm), input_(in, in + in_len),
+      callbacks_(&callbacks) {}
+
+void PrivateKeyOperation::complete() {
+  done_ = true;
+  if (callbacks_ != nullptr) {
+    callbacks_->onPrivateKeyMethodComplete();
+  }
+}
+
+PrivateKeyThreadPool::PrivateKeyThreadPool(uint32_t num_threads,
+                                           Thread::ThreadFactory& thread_factory) {
+  ENVOY_LOG(debug, "starting {} threads for batched private key operations", num_threads);
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads_.push_back(thread_factory.createThread([this]() -> void { threadRoutine(); },
+                                                   Thread::Options{"PrivateKeyOps"}));
+  }
+}
+
+PrivateKeyThreadPool::~PrivateKeyThreadPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void PrivateKeyThreadPool::post(std::function<void()> task) {
+  absl::MutexLock lock(&mutex_);
+  tasks_.push_back(std::move(task));
+}
+
+void PrivateKeyThreadPool::threadRoutine() {
+  const auto ready = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return shutdown_ || !tasks_.empty();
+  };
+  while (true) {
+    std::function<void()> task;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(&ready));
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+PrivateKeyThreadPoolSharedPtr
+PrivateKeyThreadPoolRegistry::getOrCreate(uint32_t num_threads,
+                                          Thread::ThreadFactory& thread_factory) {
+  absl::MutexLock lock(&mutex_);
+  std::weak_ptr<PrivateKeyThreadPool>& entry = pools_[num_threads];
+  PrivateKeyThreadPoolSharedPtr pool = entry.lock();
+  if (pool == nullptr) {
+    pool = std::make_shared<PrivateKeyThreadPool>(num_threads, thread_factory);
+    entry = pool;
+  }
+  return pool;
+}
+
+PrivateKeyOperationQueue::PrivateKeyOperationQueue(uint32_t max_batch_size,
+                                                   std::chrono::milliseconds max_batch_delay,
+                                                   PrivateKeyBatchProcessorSharedPtr processor,
+                                                   PrivateKeyThreadPoolSharedPtr thread_pool,
+                                                   Event::Dispatcher& dispatcher)
+    : max_batch_size_(max_batch_size), max_batch_delay_(max_batch_delay),
+      processor_(std::move(processor)), thread_pool_(std::move(thread_pool)),
+      worker_(std::make_shared<WorkerHandle>(dispatcher)),
+      timer_(dispatcher.createTimer([this]() -> void { flush(); })) {}
+
+PrivateKeyOperationQueue::~PrivateKeyOperationQueue() {
+  absl::MutexLock lock(&worker_->mutex_);
+  worker_->dispatcher_ = nullptr;
+}
+
+void PrivateKeyOperationQueue::add(PrivateKeyOperationSharedPtr operation) {
+  batch_.push_back(std::move(operation));
+  if (batch_.size() >= max_batch_size_) {
+    timer_->disableTimer();
+    flush();
+  } else if (batch_.size() == 1) {
+    timer_->enableTimer(max_batch_delay_);
+  }
+}
+
+void PrivateKeyOperationQueue::flush() {
+  ENVOY_LOG(trace, "processing a batch of {} private key operations", batch_.size());
+  thread_pool_->post([processor = processor_, worker = worker_,
+                      batch = std::move(batch_)]() mutable -> void {
+    processor->process(batch);
+    absl::MutexLock lock(&worker->mutex_);
+    if (worker->dispatcher_ != nullptr) {
+      worker->dispatcher_->post([batch = std::move(batch)]() -> void {
+        for (const PrivateKeyOperationSharedPtr& operation : batch) {
+          operation->complete();
+        }
+      });
+    }
+  });
+  batch_.clear();
+}
+
+BatchedPrivateKeyConnection::BatchedPrivateKeyConnection(
+    Ssl::PrivateKeyConnectionCallbacks& callbacks, PrivateKeyOperationQueue& queue)
+    : callbacks_(callbacks), queue_(queue) {}
+
+BatchedPrivateKeyConnection::~BatchedPrivateKeyConnection() {
+  if (operation_ != nullptr) {
+    operation_->cancel();
+  }
+}
+
+ssl_private_key_result_t BatchedPrivateKeyConnection::start(PrivateKeyOperation::Type type,
+                                                            uint16_t signature_algorithm,
+                                                            const uint8_t* in, size_t in_len) {
+  operation_ =
+      std::make_shared<PrivateKeyOperation>(type, signature_algorithm, in, in_len, callbacks_);
+  queue_.add(operation_);
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t BatchedPrivateKeyConnection::complete(uint8_t* out, size_t* out_len,
+                                                               size_t max_out) {
+  if (operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  // The handshake may be driven again before the batch of the operation is processed.
+  if (!operation_->done()) {
+    return ssl_private_key_retry;
+  }
+
+  PrivateKeyOperationSharedPtr operation = std::move(operation_);
+  if (!operation->success_ || operation->output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::copy(operation->output_.begin(), operation->output_.end(), out);
+  *out_len = operation->output_.size();
+  return ssl_private_key_success;
+}
+
+namespace {
+
+BatchedPrivateKeyConnection* getConnection(SSL* ssl, int key_type) {
+  return static_cast<BatchedPrivateKeyConnection*>(
+      SSL_get_ex_data(ssl, BatchedPrivateKeyMethodProvider::connectionIndex(key_type)));
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  BatchedPrivateKeyConnection* connection =
+      getConnection(ssl, SSL_get_signature_algorithm_key_type(signature_algorithm));
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->start(PrivateKeyOperation::Type::Sign, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t*, size_t*, size_t, const uint8_t* in,
+                                           size_t in_len) {
+  BatchedPrivateKeyConnection* connection = getConnection(ssl, EVP_PKEY_RSA);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->start(PrivateKeyOperation::Type::Decrypt, 0, in, in_len);
+}
+
+// BoringSSL calls complete() on the provider of the certificate it selected, which is the only one
+// with an operation in progress.
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  for (int key_type : {EVP_PKEY_RSA, EVP_PKEY_EC}) {
+    BatchedPrivateKeyConnection* connection = getConnection(ssl, key_type);
+    if (connection != nullptr && connection->inProgress()) {
+      return connection->complete(out, out_len, max_out);
+    }
+  }
+  return ssl_private_key_failure;
+}
+
+int createIndex() {
+  int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+  return index;
+}
+
+int rsaConnectionIndex() { CONSTRUCT_ON_FIRST_USE(int, createIndex()); }
+
+int ecConnectionIndex() { CONSTRUCT_ON_FIRST_USE(int, createIndex()); }
+
+} // namespace
+
+int BatchedPrivateKeyMethodProvider::connectionIndex(int key_type) {
+  return key_type == EVP_PKEY_RSA ? rsaConnectionIndex() : ecConnectionIndex();
+}
+
+BatchedPrivateKeyMethodProvider::BatchedPrivateKeyMethodProvider(
+    PrivateKeyBatchProcessorSharedPtr processor, PrivateKeyThreadPoolSharedPtr thread_pool,
+    uint32_t max_batch_size, std::chrono::milliseconds max_batch_delay,
+    ThreadLocal::SlotAllocator& tls)
+    : processor_(std::move(processor)), connection_index_(connectionIndex(processor_->keyType())),
+      method_(std::make_shared<SSL_PRIVATE_KEY_METHOD>()),
+      tls_(ThreadLocal::TypedSlot<PrivateKeyOperationQueue>::makeUnique(tls)) {
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+
+  // A queue per worker batches the operations of its connections without locking.
+  tls_->set([processor = processor_, thread_pool = std::move(thread_pool), max_batch_size,
+             max_batch_delay](Event::Dispatcher& dispatcher) {
+    return std::make_shared<PrivateKeyOperationQueue>(max_batch_size, max_batch_delay, processor,
+                                                      thread_pool, dispatcher);
+  });
+}
+
+void BatchedPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher&) {
+  if (SSL_get_ex_data(ssl, connection_index_) != nullptr) {
+    throw EnvoyException(
+        "Not registering the batched private key provider twice for the same key type");
+  }
+  ASSERT(tls_->currentThreadRegistered(), "Current thread needs to be registered.");
+  SSL_set_ex_data(ssl, connection_index_,
+                  new BatchedPrivateKeyConnection(cb, tls_->get().ref()));
+}
+
+void BatchedPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  delete static_cast<BatchedPrivateKeyConnection*>(SSL_get_ex_data(ssl, connection_index_));
+  SSL_set_ex_data(ssl, connection_index_, nullptr);
+}
+
+bool BatchedPrivateKeyMethodProvider::checkFips() { return processor_->checkFips(); }
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/private_key/private_key_callbacks.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A private key operation of a handshake. The operation is created and completed on the worker of
+ * the connection, and performed in between on a thread of the pool.
+ */
+class PrivateKeyOperation {
+public:
+  enum class Type { Sign, Decrypt };
+
+  PrivateKeyOperation(Type type, uint16_t signature_algorithm, const uint8_t* in, size_t in_len,
+                      Ssl::PrivateKeyConnectionCallbacks& callbacks);
+
+  /**
+   * Marks the operation as done and resumes the handshake, unless it was cancelled. Called on the
+   * worker.
+   */
+  void complete();
+
+  /**
+   * Stops the operation from resuming the handshake, when the connection is closed while the
+   * operation is in a batch. Called on the worker.
+   */
+  void cancel() { callbacks_ = nullptr; }
+
+  bool done() const { return done_; }
+
+  const Type type_;
+  // The signature algorithm of a signing operation.
+  const uint16_t signature_algorithm_;
+  const std::vector<uint8_t> input_;
+  // Set by the batch processor. Only read on the worker once the operation is done.
+  std::vector<uint8_t> output_;
+  bool success_{};
+
+private:
+  Ssl::PrivateKeyConnectionCallbacks* callbacks_;
+  bool done_{};
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+using PrivateKeyOperationBatch = std::vector<PrivateKeyOperationSharedPtr>;
+
+/**
+ * Performs batches of private key operations. Implementations may process the operations of a
+ * batch together, e.g. with multi-buffer instructions or an accelerator. Batches are processed on
+ * the threads of the pool, so process() may be called concurrently.
+ */
+class PrivateKeyBatchProcessor {
+public:
+  virtual ~PrivateKeyBatchProcessor() = default;
+
+  /**
+   * Performs the operations of a batch, setting their output and success.
+   */
+  virtual void process(const PrivateKeyOperationBatch& batch) PURE;
+
+  /**
+   * @return whether the key and the processing are FIPS compliant.
+   */
+  virtual bool checkFips() PURE;
+
+  /**
+   * @return the type of the key, EVP_PKEY_RSA or EVP_PKEY_EC.
+   */
+  virtual int keyType() const PURE;
+};
+
+using PrivateKeyBatchProcessorSharedPtr = std::shared_ptr<PrivateKeyBatchProcessor>;
+
+/**
+ * A fixed number of threads that run the batches of all the workers.
+ */
+class PrivateKeyThreadPool : Logger::Loggable<Logger::Id::connection> {
+public:
+  PrivateKeyThreadPool(uint32_t num_threads, Thread::ThreadFactory& thread_factory);
+  // Runs the tasks that are already queued and joins the threads.
+  ~PrivateKeyThreadPool() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  void post(std::function<void()> task) ABSL_LOCKS_EXCLUDED(mutex_);
+
+private:
+  void threadRoutine() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using PrivateKeyThreadPoolSharedPtr = std::shared_ptr<PrivateKeyThreadPool>;
+
+/**
+ * The thread pools of the batched private key providers, shared by the providers with the same
+ * number of threads, such as the providers of the certificates of a listener and the providers
+ * rebuilt on a secret update.
+ */
+class PrivateKeyThreadPoolRegistry : public Singleton::Instance {
+public:
+  PrivateKeyThreadPoolSharedPtr getOrCreate(uint32_t num_threads,
+                                            Thread::ThreadFactory& thread_factory);
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<uint32_t, std::weak_ptr<PrivateKeyThreadPool>>
+      pools_ ABSL_GUARDED_BY(mutex_);
+};
+
+using PrivateKeyThreadPoolRegistrySharedPtr = std::shared_ptr<PrivateKeyThreadPoolRegistry>;
+
+/**
+ * The private key operations of the connections of a worker that are waiting for a batch. The
+ * queue is handed to the thread pool when it holds max_batch_size operations, or max_batch_delay
+ * after the first operation was queued, and the operations of the batch are completed on the
+ * worker once the batch is processed.
+ */
+class PrivateKeyOperationQueue : public ThreadLocal::ThreadLocalObject,
+                                 Logger::Loggable<Logger::Id::connection> {
+public:
+  PrivateKeyOperationQueue(uint32_t max_batch_size, std::chrono::milliseconds max_batch_delay,
+                           PrivateKeyBatchProcessorSharedPtr processor,
+                           PrivateKeyThreadPoolSharedPtr thread_pool,
+                           Event::Dispatcher& dispatcher);
+  ~PrivateKeyOperationQueue() override;
+
+  void add(PrivateKeyOperationSharedPtr operation);
+
+private:
+  // Lets the threads of the pool post processed batches to the worker for as long as its
+  // dispatcher is running. The queue is destroyed on the worker before its dispatcher.
+  struct WorkerHandle {
+    explicit WorkerHandle(Event::Dispatcher& dispatcher) : dispatcher_(&dispatcher) {}
+
+    absl::Mutex mutex_;
+    Event::Dispatcher* dispatcher_ ABSL_GUARDED_BY(mutex_);
+  };
+  using WorkerHandleSharedPtr = std::shared_ptr<WorkerHandle>;
+
+  void flush();
+
+  const uint32_t max_batch_size_;
+  const std::chrono::milliseconds max_batch_delay_;
+  PrivateKeyBatchProcessorSharedPtr processor_;
+  PrivateKeyThreadPoolSharedPtr thread_pool_;
+  WorkerHandleSharedPtr worker_;
+  Event::TimerPtr timer_;
+  PrivateKeyOperationBatch batch_;
+};
+
+/**
+ * The private key operation of a connection, stored in the ex_data of its SSL.
+ */
+class BatchedPrivateKeyConnection {
+public:
+  BatchedPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& callbacks,
+                              PrivateKeyOperationQueue& queue);
+  ~BatchedPrivateKeyConnection();
+
+  ssl_private_key_result_t start(PrivateKeyOperation::Type type, uint16_t signature_algorithm,
+                                 const uint8_t* in, size_t in_len);
+  ssl_private_key_result_t complete(uint8_t* out, size_t* out_len, size_t max_out);
+  bool inProgress() const { return operation_ != nullptr; }
+
+private:
+  Ssl::PrivateKeyConnectionCallbacks& callbacks_;
+  PrivateKeyOperationQueue& queue_;
+  PrivateKeyOperationSharedPtr operation_;
+};
+
+/**
+ * A private key method provider that takes the private key operations of handshakes off the
+ * workers, and performs them in batches on a thread pool with a PrivateKeyBatchProcessor.
+ */
+class BatchedPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider,
+                                        Logger::Loggable<Logger::Id::connection> {
+public:
+  BatchedPrivateKeyMethodProvider(PrivateKeyBatchProcessorSharedPtr processor,
+                                  PrivateKeyThreadPoolSharedPtr thread_pool,
+                                  uint32_t max_batch_size,
+                                  std::chrono::milliseconds max_batch_delay,
+                                  ThreadLocal::SlotAllocator& tls);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  bool isAvailable() override { return true; }
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override {
+    return method_;
+  }
+
+  // The connections of the providers of RSA and ECDSA keys are stored at different indexes, so
+  // that a context can have a certificate of each type with this provider.
+  static int connectionIndex(int key_type);
+
+private:
+  PrivateKeyBatchProcessorSharedPtr processor_;
+  const int connection_index_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  ThreadLocal::TypedSlotPtr<PrivateKeyOperationQueue> tls_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
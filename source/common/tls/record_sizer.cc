@@ -0,0 +1,29 @@
+#include "source/common/tls/record_sizer.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+uint64_t RecordSizer::recordSize() {
+  if (bytes_written_ > 0 &&
+      time_source_.monotonicTime() - last_write_time_ >= config_.idle_timeout_) {
+    bytes_written_ = 0;
+  }
+  if (bytes_written_ >= config_.small_record_bytes_) {
+    return MaxRecordSize;
+  }
+  return std::min<uint64_t>(config_.small_record_size_, MaxRecordSize);
+}
+
+void RecordSizer::onRecordWritten(uint64_t bytes) {
+  bytes_written_ += bytes;
+  last_write_time_ = time_source_.monotonicTime();
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/ssl/context_config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Chooses the size of the TLS records that a connection writes, following its dynamic record
+ * sizing settings. A connection writes small records until it wrote the configured number of
+ * bytes, and full size records afterwards. It goes back to small records once it was idle for the
+ * configured duration.
+ */
+class RecordSizer {
+public:
+  // The largest plaintext that a record can carry, RFC 8446 section 5.1.
+  static constexpr uint64_t MaxRecordSize = 16384;
+
+  RecordSizer(const Ssl::ServerContextConfig::DynamicRecordSizing& config, TimeSource& time_source)
+      : config_(config), time_source_(time_source) {}
+
+  /**
+   * @return the size of the plaintext of the next record to write.
+   */
+  uint64_t recordSize();
+
+  /**
+   * Accounts for a record that was written.
+   * @param bytes the size of the plaintext of the record.
+   */
+  void onRecordWritten(uint64_t bytes);
+
+private:
+  const Ssl::ServerContextConfig::DynamicRecordSizing config_;
+  TimeSource& time_source_;
+  // The number of bytes written since the start of the connection or its last idle period.
+  uint64_t bytes_written_{};
+  MonotonicTime last_write_time_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -79,6 +79,18 @@ bool getStatelessSessionResumptionDisabled(
   }
 }
 
+absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing> getDynamicRecordSizing(
+    const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext& config) {
+  if (!config.has_dynamic_record_sizing()) {
+    return absl::nullopt;
+  }
+  const auto& sizing = config.dynamic_record_sizing();
+  return Ssl::ServerContextConfig::DynamicRecordSizing{
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, small_record_size, 1400),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, small_record_bytes, 1024 * 1024),
+      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(sizing, idle_timeout, 1000))};
+}
+
 } // namespace
 
 const unsigned ServerContextConfigImpl::DEFAULT_MIN_VERSION = TLS1_2_VERSION;
@@ -125,9 +137,13 @@ ServerContextConfigImpl::ServerContextConfigImpl(
           getTlsSessionTicketKeysConfigProvider(factory_context, config, creation_status)),
       disable_stateless_session_resumption_(getStatelessSessionResumptionDisabled(config)),
       disable_stateful_session_resumption_(config.disable_stateful_session_resumption()),
+      shared_session_cache_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, shared_session_cache_size, 0)),
       full_scan_certs_on_sni_mismatch_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, full_scan_certs_on_sni_mismatch, false)),
-      prefer_client_ciphers_(config.prefer_client_ciphers()) {
+      prefer_client_ciphers_(config.prefer_client_ciphers()),
+      kernel_tls_offload_(config.kernel_tls_offload()),
+      dynamic_record_sizing_(getDynamicRecordSizing(config)) {
   SET_AND_RETURN_IF_NOT_OK(creation_status, creation_status);
   if (session_ticket_keys_provider_ != nullptr) {
     // Validate tls session ticket keys early to reject bad sds updates.
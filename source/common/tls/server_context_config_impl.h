@@ -39,9 +39,14 @@ public:
   bool disableStatefulSessionResumption() const override {
     return disable_stateful_session_resumption_;
   }
+  uint32_t sharedSessionCacheSize() const override { return shared_session_cache_size_; }
 
   bool fullScanCertsOnSNIMismatch() const override { return full_scan_certs_on_sni_mismatch_; }
   bool preferClientCiphers() const override { return prefer_client_ciphers_; }
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
+  const absl::optional<DynamicRecordSizing>& dynamicRecordSizing() const override {
+    return dynamic_record_sizing_;
+  }
 
   Ssl::TlsCertificateSelectorFactory tlsCertificateSelectorFactory() const override;
 
@@ -75,8 +80,11 @@ private:
   absl::optional<std::chrono::seconds> session_timeout_;
   const bool disable_stateless_session_resumption_;
   const bool disable_stateful_session_resumption_;
+  const uint32_t shared_session_cache_size_;
   bool full_scan_certs_on_sni_mismatch_;
   const bool prefer_client_ciphers_;
+  const bool kernel_tls_offload_;
+  const absl::optional<DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 } // namespace Tls
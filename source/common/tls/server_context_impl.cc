@@ -13,6 +13,7 @@
 #include "envoy/admin/v3/certs.pb.h"
 #include "envoy/common/exception.h"
 #include "envoy/common/platform.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/ssl/ssl_socket_extended_info.h"
 #include "envoy/stats/scope.h"
 #include "envoy/type/matcher/v3/string.pb.h"
@@ -27,6 +28,7 @@
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/stats/utility.h"
 #include "source/common/tls/cert_validator/factory.h"
+#include "source/common/tls/session_cache.h"
 #include "source/common/tls/stats.h"
 #include "source/common/tls/utility.h"
 
@@ -68,6 +70,21 @@ Ssl::CurveNIDVector getClientCurveNIDSupported(CBS& cbs) {
   return cnsv;
 }
 
+SINGLETON_MANAGER_REGISTRATION(tls_session_cache_registry);
+
+namespace {
+
+// The registry is pinned, as the contexts only hold the caches it hands out. Otherwise it would be
+// destroyed after each lookup, and a rebuilt context would not find the cache of its predecessor.
+SessionCacheRegistrySharedPtr
+getSessionCacheRegistry(Server::Configuration::CommonFactoryContext& factory_context) {
+  return factory_context.singletonManager().getTyped<SessionCacheRegistry>(
+      SINGLETON_MANAGER_REGISTERED_NAME(tls_session_cache_registry),
+      [] { return std::make_shared<SessionCacheRegistry>(); }, true);
+}
+
+} // namespace
+
 int ServerContextImpl::alpnSelectCallback(const unsigned char** out, unsigned char* outlen,
                                           const unsigned char* in, unsigned int inlen) {
   // Currently this uses the standard selection algorithm in priority order.
@@ -108,6 +125,8 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   }
   // If creation failed, do not create the selector.
   tls_certificate_selector_ = config.tlsCertificateSelectorFactory()(config, *this);
+  kernel_tls_offload_ = config.kernelTlsOffload();
+  dynamic_record_sizing_ = config.dynamicRecordSizing();
 
   if (config.tlsCertificates().empty() && !config.capabilities().provides_certificates) {
     creation_status =
@@ -135,6 +154,15 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
         });
   }
 
+  SessionCacheSharedPtr session_cache;
+  if (config.sharedSessionCacheSize() > 0 && !config.disableStatefulSessionResumption() &&
+      !config.capabilities().handles_session_resumption) {
+    const absl::string_view session_id_context(reinterpret_cast<const char*>(session_id.data()),
+                                               session_id.size());
+    session_cache = getSessionCacheRegistry(factory_context_)
+                        ->getOrCreate(session_id_context, config.sharedSessionCacheSize());
+  }
+
   const auto tls_certificates = config.tlsCertificates();
 
   for (uint32_t i = 0; i < tls_certificates.size(); ++i) {
@@ -180,6 +208,8 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
 
     if (config.disableStatefulSessionResumption()) {
       SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    } else if (session_cache != nullptr) {
+      SessionCache::attach(session_cache, ctx.ssl_ctx_.get());
     }
 
     if (config.sessionTimeout() && !config.capabilities().handles_session_resumption) {
@@ -0,0 +1,96 @@
+#include "source/common/tls/session_cache.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+absl::string_view sessionId(const SSL_SESSION* session) {
+  unsigned int length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &length);
+  return {reinterpret_cast<const char*>(id), length};
+}
+
+} // namespace
+
+SessionCache::SessionCache(uint32_t max_entries) : sessions_(max_entries) {}
+
+int SessionCache::sslCtxIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int ssl_ctx_index = SSL_CTX_get_ex_new_index(
+        0, nullptr, nullptr, nullptr,
+        [](void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+          delete static_cast<SessionCacheSharedPtr*>(ptr);
+        });
+    RELEASE_ASSERT(ssl_ctx_index >= 0, "");
+    return ssl_ctx_index;
+  }());
+}
+
+SessionCache& SessionCache::fromSslCtx(const SSL_CTX* ctx) {
+  auto* cache = static_cast<SessionCacheSharedPtr*>(SSL_CTX_get_ex_data(ctx, sslCtxIndex()));
+  ASSERT(cache != nullptr);
+  return **cache;
+}
+
+void SessionCache::attach(SessionCacheSharedPtr cache, SSL_CTX* ctx) {
+  int rc = SSL_CTX_set_ex_data(ctx, sslCtxIndex(), new SessionCacheSharedPtr(std::move(cache)));
+  RELEASE_ASSERT(rc == 1, "");
+
+  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_sess_set_new_cb(ctx, [](SSL* ssl, SSL_SESSION* session) -> int {
+    fromSslCtx(SSL_get_SSL_CTX(ssl)).insert(session);
+    // The cache takes its own reference.
+    return 0;
+  });
+  SSL_CTX_sess_set_get_cb(
+      ctx, [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+        // The caller takes the reference returned by lookup().
+        *out_copy = 0;
+        return fromSslCtx(SSL_get_SSL_CTX(ssl))
+            .lookup({reinterpret_cast<const char*>(id), static_cast<size_t>(id_len)})
+            .release();
+      });
+}
+
+void SessionCache::insert(SSL_SESSION* session) {
+  const absl::string_view id = sessionId(session);
+  if (id.empty()) {
+    return;
+  }
+  SSL_SESSION_up_ref(session);
+  sessions_.insert(id, bssl::UniquePtr<SSL_SESSION>(session));
+}
+
+bssl::UniquePtr<SSL_SESSION> SessionCache::lookup(absl::string_view session_id) {
+  bssl::UniquePtr<SSL_SESSION> session;
+  sessions_.lookup(session_id, [&session](bssl::UniquePtr<SSL_SESSION>& cached) {
+    SSL_SESSION_up_ref(cached.get());
+    session.reset(cached.get());
+    return true;
+  });
+  return session;
+}
+
+SessionCacheSharedPtr SessionCacheRegistry::getOrCreate(absl::string_view session_id_context,
+                                                        uint32_t max_entries) {
+  absl::MutexLock lock(&mutex_);
+  absl::erase_if(caches_, [](const auto& entry) { return entry.second.expired(); });
+  std::weak_ptr<SessionCache>& entry = caches_[session_id_context];
+  SessionCacheSharedPtr cache = entry.lock();
+  if (cache == nullptr) {
+    cache = std::make_shared<SessionCache>(max_entries);
+    entry = cache;
+  }
+  return cache;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/singleton/instance.h"
+
+#include "source/common/common/sharded_lru_cache.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+class SessionCache;
+using SessionCacheSharedPtr = std::shared_ptr<SessionCache>;
+
+/**
+ * A bounded cache of the TLS sessions established by server contexts, used for session ID
+ * resumption instead of the internal cache of each SSL_CTX. It is shared by all the workers, and
+ * by the contexts that replace each other on secret updates, so that a context rebuild does not
+ * force all the clients into full handshakes. The least recently used sessions are evicted once
+ * the cache holds max_entries of them.
+ */
+class SessionCache {
+public:
+  explicit SessionCache(uint32_t max_entries);
+
+  /**
+   * Makes the SSL_CTX store its server sessions in the cache, which it keeps alive.
+   */
+  static void attach(SessionCacheSharedPtr cache, SSL_CTX* ctx);
+
+  void insert(SSL_SESSION* session);
+
+  /**
+   * @return the session with the ID, or nullptr if it is not cached. Expired sessions are left to
+   * be evicted, as the server checks the session lifetime itself.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view session_id);
+
+  size_t size() const { return sessions_.size(); }
+
+private:
+  static int sslCtxIndex();
+  static SessionCache& fromSslCtx(const SSL_CTX* ctx);
+
+  // The sessions, keyed by their ID.
+  ShardedLruCache<std::string, bssl::UniquePtr<SSL_SESSION>> sessions_;
+};
+
+/**
+ * The session caches of the process, keyed by the session context ID of the server contexts that
+ * share them. The session context ID covers the certificate identities and the server names of a
+ * context, so a rebuilt context with the same ones reuses the cache of the context it replaces.
+ */
+class SessionCacheRegistry : public Singleton::Instance {
+public:
+  SessionCacheSharedPtr getOrCreate(absl::string_view session_id_context, uint32_t max_entries);
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<SessionCache>> caches_ ABSL_GUARDED_BY(mutex_);
+};
+
+using SessionCacheRegistrySharedPtr = std::shared_ptr<SessionCacheRegistry>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -5,8 +5,10 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/empty_string.h"
 #include "source/common/common/hex.h"
+#include "source/common/common/utility.h"
 #include "source/common/http/headers.h"
 #include "source/common/tls/io_handle_bio.h"
+#include "source/common/tls/kernel_tls.h"
 #include "source/common/tls/ssl_handshaker.h"
 #include "source/common/tls/utility.h"
 
@@ -83,6 +85,11 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
   BIO* bio = BIO_new_io_handle(&callbacks_->ioHandle());
   SSL_set_bio(rawSsl(), bio, bio);
   SSL_set_ex_data(rawSsl(), ContextImpl::sslSocketIndex(), static_cast<void*>(callbacks_));
+
+  if (ctx_->dynamicRecordSizing().has_value()) {
+    record_sizer_.emplace(ctx_->dynamicRecordSizing().value(),
+                          callbacks_->connection().dispatcher().timeSource());
+  }
 }
 
 SslSocket::ReadResult SslSocket::sslReadIntoSlice(Buffer::RawSlice& slice) {
@@ -117,6 +124,10 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (kernel_tls_) {
+    return kernelTlsRead(read_buffer);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -172,6 +183,70 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
+Network::IoResult SslSocket::kernelTlsRead(Buffer::Instance& read_buffer) {
+  bool keep_reading = true;
+  bool end_stream = false;
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  while (keep_reading) {
+    uint64_t bytes_read_this_iteration = 0;
+    Buffer::Reservation reservation = read_buffer.reserveForRead();
+    for (uint64_t i = 0; i < reservation.numSlices() && keep_reading; i++) {
+      uint8_t* mem = static_cast<uint8_t*>(reservation.slices()[i].mem_);
+      size_t remaining = reservation.slices()[i].len_;
+      while (remaining > 0) {
+        uint8_t record_type;
+        const Api::SysCallSizeResult result =
+            KernelTls::read(callbacks_->ioHandle(), {mem, remaining}, record_type);
+        ENVOY_CONN_LOG(trace, "kernel tls read returns: {}", callbacks_->connection(),
+                       result.return_value_);
+        if (result.return_value_ > 0 && record_type == KernelTls::ApplicationDataRecordType) {
+          mem += result.return_value_;
+          remaining -= result.return_value_;
+          bytes_read_this_iteration += result.return_value_;
+          continue;
+        }
+
+        keep_reading = false;
+        if (result.return_value_ == 0) {
+          // Non-graceful shutdown by closing the underlying socket.
+          end_stream = true;
+        } else if (result.return_value_ < 0) {
+          if (result.errno_ != SOCKET_ERROR_AGAIN) {
+            ENVOY_CONN_LOG(debug, "kernel tls read error: {}", callbacks_->connection(),
+                           errorDetails(result.errno_));
+            action = PostIoAction::Close;
+          }
+        } else if (record_type == KernelTls::AlertRecordType && result.return_value_ == 2 &&
+                   mem[1] == SSL_AD_CLOSE_NOTIFY) {
+          // Graceful shutdown using close_notify TLS alert.
+          end_stream = true;
+        } else {
+          // Any other alert is fatal, and post-handshake messages such as a TLSv1.3 key update
+          // can't be processed once BoringSSL no longer has the traffic keys.
+          failure_reason_ = absl::StrCat("TLS_error:|kernel TLS received a record of type ",
+                                         static_cast<int>(record_type), ":TLS_error_end");
+          ctx_->stats().connection_error_.inc();
+          action = PostIoAction::Close;
+        }
+        break;
+      }
+    }
+
+    reservation.commit(bytes_read_this_iteration);
+    if (bytes_read_this_iteration > 0 && callbacks_->shouldDrainReadBuffer()) {
+      callbacks_->setTransportSocketIsReadable();
+      keep_reading = false;
+    }
+
+    bytes_read += bytes_read_this_iteration;
+  }
+
+  ENVOY_CONN_LOG(trace, "kernel tls read {} bytes", callbacks_->connection(), bytes_read);
+
+  return {action, bytes_read, end_stream};
+}
+
 void SslSocket::onPrivateKeyMethodComplete() { resumeHandshake(); }
 
 void SslSocket::resumeHandshake() {
@@ -190,6 +265,9 @@ void SslSocket::resumeHandshake() {
 Network::Connection& SslSocket::connection() const { return callbacks_->connection(); }
 
 void SslSocket::onSuccess(SSL* ssl) {
+  if (ctx_->kernelTlsOffload() && !enableKernelTls(ssl)) {
+    return;
+  }
   ctx_->logHandshake(ssl);
   if (callbacks_->connection().streamInfo().upstreamInfo()) {
     callbacks_->connection()
@@ -204,6 +282,29 @@ void SslSocket::onSuccess(SSL* ssl) {
   callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 }
 
+bool SslSocket::enableKernelTls(SSL* ssl) {
+  const absl::Status status = KernelTls::enable(ssl, callbacks_->ioHandle());
+  if (status.ok()) {
+    ENVOY_CONN_LOG(debug, "TLS record layer handed to the kernel", callbacks_->connection());
+    ctx_->stats().kernel_tls_offload_.inc();
+    kernel_tls_ = true;
+    return true;
+  }
+
+  ENVOY_CONN_LOG(debug, "TLS record layer kept in userspace: {}", callbacks_->connection(),
+                 status.message());
+  ctx_->stats().kernel_tls_offload_fallback_.inc();
+  if (absl::IsFailedPrecondition(status)) {
+    return true;
+  }
+  // The kernel only took over the receive direction, so the connection can't go on.
+  failure_reason_ = absl::StrCat("TLS_error:|kernel TLS: ", status.message(), ":TLS_error_end");
+  ctx_->stats().connection_error_.inc();
+  callbacks_->connection().close(Network::ConnectionCloseType::NoFlush,
+                                 "kernel_tls_offload_failed");
+  return false;
+}
+
 void SslSocket::onFailure() { drainErrorQueue(); }
 
 PostIoAction SslSocket::doHandshake() { return info_->doHandshake(); }
@@ -263,12 +364,16 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_) {
+    return kernelTlsWrite(write_buffer, end_stream);
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = std::min(write_buffer.length(), recordSize());
   }
 
   uint64_t total_bytes_written = 0;
@@ -286,7 +391,10 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      if (record_sizer_.has_value()) {
+        record_sizer_->onRecordWritten(rc);
+      }
+      bytes_to_write = std::min(write_buffer.length(), recordSize());
     } else {
       int err = SSL_get_error(rawSsl(), rc);
       ENVOY_CONN_LOG(trace, "ssl error occurred while write: {}", callbacks_->connection(),
@@ -313,6 +421,35 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::recordSize() {
+  return record_sizer_.has_value() ? record_sizer_->recordSize() : RecordSizer::MaxRecordSize;
+}
+
+Network::IoResult SslSocket::kernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    // The kernel splits the plaintext into records as it encrypts it.
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel tls write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        break;
+      }
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+    ENVOY_CONN_LOG(trace, "kernel tls write returns: {}", callbacks_->connection(),
+                   result.return_value_);
+    total_bytes_written += result.return_value_;
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(info_->state() == Ssl::SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -321,20 +458,27 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(rawSsl());
-    if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
-      // Windows operate under `EmulatedEdge`. These are level events that are artificially
-      // made to behave like edge events. And if the rc is 0 then in that case we want read
-      // activation resumption. This code is protected with an `constexpr` if, to minimize the tax
-      // on POSIX systems that operate in Edge events.
-      if (rc == 0) {
-        // See https://www.openssl.org/docs/manmaster/man3/SSL_shutdown.html
-        // if return value is 0,  Call SSL_read() to do a bidirectional shutdown.
-        callbacks_->setTransportSocketIsReadable();
+    if (kernel_tls_) {
+      // BoringSSL no longer has the traffic keys, so the kernel sends the close_notify alert.
+      const Api::SysCallSizeResult result = KernelTls::sendCloseNotify(callbacks_->ioHandle());
+      ENVOY_CONN_LOG(debug, "kernel tls shutdown: rc={}", callbacks_->connection(),
+                     result.return_value_);
+    } else {
+      int rc = SSL_shutdown(rawSsl());
+      if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
+        // Windows operate under `EmulatedEdge`. These are level events that are artificially
+        // made to behave like edge events. And if the rc is 0 then in that case we want read
+        // activation resumption. This code is protected with an `constexpr` if, to minimize the tax
+        // on POSIX systems that operate in Edge events.
+        if (rc == 0) {
+          // See https://www.openssl.org/docs/manmaster/man3/SSL_shutdown.html
+          // if return value is 0,  Call SSL_read() to do a bidirectional shutdown.
+          callbacks_->setTransportSocketIsReadable();
+        }
       }
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
+      drainErrorQueue();
     }
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
-    drainErrorQueue();
     info_->setState(Ssl::SocketState::ShutdownSent);
   }
 }
@@ -16,6 +16,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/network/transport_socket_options_impl.h"
 #include "source/common/tls/context_impl.h"
+#include "source/common/tls/record_sizer.h"
 #include "source/common/tls/ssl_handshaker.h"
 #include "source/common/tls/utility.h"
 
@@ -93,6 +94,13 @@ private:
   };
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
+  // Hands the record layer to the kernel, and returns false if this closed the connection.
+  bool enableKernelTls(SSL* ssl);
+  Network::IoResult kernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult kernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
+  // The size of the plaintext of the next record that doWrite() passes to SSL_write().
+  uint64_t recordSize();
+
   Network::PostIoAction doHandshake();
   void drainErrorQueue();
   void shutdownSsl();
@@ -104,6 +112,10 @@ private:
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
+  // Whether the kernel encrypts and decrypts the records instead of BoringSSL.
+  bool kernel_tls_{};
+  // Set if the context enables dynamic record sizing.
+  absl::optional<RecordSizer> record_sizer_;
 
   SslHandshakerImplSharedPtr info_;
 };
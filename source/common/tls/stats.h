@@ -21,6 +21,10 @@ namespace Tls {
   COUNTER(ocsp_staple_omitted)                                                                     \
   COUNTER(ocsp_staple_responses)                                                                   \
   COUNTER(ocsp_staple_requests)                                                                    \
+  COUNTER(verified_chain_cache_hit)                                                                \
+  COUNTER(verified_chain_cache_miss)                                                               \
+  COUNTER(kernel_tls_offload)                                                                      \
+  COUNTER(kernel_tls_offload_fallback)                                                             \
   COUNTER(was_key_usage_invalid)
 
 /**
@@ -138,6 +138,13 @@ SystemTime getValidFrom(const X509& cert);
  */
 SystemTime getExpirationTime(const X509& cert);
 
+/**
+ * Returns the time when this CRL is due to be superseded.
+ * @param crl the certificate revocation list.
+ * @return the next update time of the CRL, or absl::nullopt if it has none.
+ */
+absl::optional<SystemTime> getNextUpdateTime(const X509_CRL& crl);
+
 /**
  * Returns the last crypto error from ERR_get_error(), or `absl::nullopt`
  * if the error stack is empty.
@@ -16,7 +16,11 @@ FileAccessLog::FileAccessLog(const Filesystem::FilePathAndType& access_log_file_
 
 void FileAccessLog::emitLog(const Formatter::HttpFormatterContext& context,
                             const StreamInfo::StreamInfo& stream_info) {
-  log_file_->write(formatter_->formatWithContext(context, stream_info));
+  // Lines are formatted into a per-thread buffer which keeps its capacity between lines.
+  static thread_local std::string log_line;
+  log_line.clear();
+  formatter_->appendWithContext(context, stream_info, log_line);
+  log_file_->write(log_line);
 }
 
 } // namespace File
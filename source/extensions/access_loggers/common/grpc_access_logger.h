@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 
 #include "envoy/config/core/v3/config_source.pb.h"
@@ -113,7 +114,10 @@ public:
           flush();
           flush_timer_->enableTimer(buffer_flush_interval_msec_);
         })),
-        max_buffer_size_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384)) {
+        buffer_size_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384)),
+        max_buffer_size_bytes_(std::max<uint64_t>(
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffer_size_bytes, 0), buffer_size_bytes_)),
+        batch_size_bytes_(buffer_size_bytes_) {
     flush_timer_->enableTimer(buffer_flush_interval_msec_);
     if (access_log_prefix.has_value()) {
       stats_ = std::make_unique<GrpcAccessLoggerStats>(GrpcAccessLoggerStats{
@@ -127,7 +131,7 @@ public:
     }
     approximate_message_size_bytes_ += entry.ByteSizeLong();
     addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
+    if (approximate_message_size_bytes_ >= batch_size_bytes_) {
       flush();
     }
   }
@@ -135,7 +139,7 @@ public:
   void log(TcpLogProto&& entry) override {
     approximate_message_size_bytes_ += entry.ByteSizeLong();
     addEntry(std::move(entry));
-    if (approximate_message_size_bytes_ >= max_buffer_size_bytes_) {
+    if (approximate_message_size_bytes_ >= batch_size_bytes_) {
       flush();
     }
   }
@@ -165,6 +169,13 @@ private:
       // Clear the message regardless of the success.
       approximate_message_size_bytes_ = 0;
       clearMessage();
+      // The stream is keeping up again, so shrink batches back towards the configured size to
+      // bound how long entries wait to be sent.
+      batch_size_bytes_ = std::max(batch_size_bytes_ / 2, buffer_size_bytes_);
+    } else {
+      // The stream is backed up. Rather than retrying on every new entry, wait for the batch to
+      // grow so that the collector gets fewer and larger messages once it has caught up.
+      batch_size_bytes_ = std::min(batch_size_bytes_ * 2, max_buffer_size_bytes_);
     }
   }
 
@@ -177,7 +188,7 @@ private:
   // [1]https://github.com/envoyproxy/envoy/blob/cd5ef906026160ec2cd766d8d18217e668c256d8/source/extensions/access_loggers/common/grpc_access_logger.h#L287.
   // [2]https://github.com/envoyproxy/envoy/blob/cd5ef906026160ec2cd766d8d18217e668c256d8/source/extensions/access_loggers/common/grpc_access_logger.h#L126
   bool canLogMore() {
-    if (max_buffer_size_bytes_ == 0 || approximate_message_size_bytes_ < max_buffer_size_bytes_) {
+    if (buffer_size_bytes_ == 0 || approximate_message_size_bytes_ < max_buffer_size_bytes_) {
       incLogsWrittenStats();
       return true;
     }
@@ -204,7 +215,12 @@ private:
 
   const std::chrono::milliseconds buffer_flush_interval_msec_;
   const Event::TimerPtr flush_timer_;
+  const uint64_t buffer_size_bytes_;
+  // Entries are dropped once this many bytes are buffered.
   const uint64_t max_buffer_size_bytes_;
+  // Entries are flushed once this many bytes are buffered. Adapts between buffer_size_bytes_ and
+  // max_buffer_size_bytes_ depending on whether the stream accepts the batches.
+  uint64_t batch_size_bytes_;
   uint64_t approximate_message_size_bytes_ = 0;
   std::unique_ptr<GrpcAccessLoggerStats> stats_ = nullptr;
 };
@@ -0,0 +1,62 @@
+#include "source/extensions/access_loggers/file/binary_access_log_impl.h"
+
+#include "source/common/protobuf/protobuf.h"
+#include "source/extensions/access_loggers/common/grpc_access_log_utils.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+
+BinaryFileAccessLog::BinaryFileAccessLog(
+    const Filesystem::FilePathAndType& access_log_file_info, AccessLog::FilterPtr&& filter,
+    const envoy::extensions::access_loggers::file::v3::FileAccessLog::BinaryFormat& config,
+    AccessLog::AccessLogManager& log_manager)
+    : ImplBase(std::move(filter)) {
+  auto file_or_error = log_manager.createAccessLog(access_log_file_info);
+  THROW_IF_NOT_OK_REF(file_or_error.status());
+  log_file_ = file_or_error.value();
+
+  for (const auto& header : config.additional_request_headers_to_log()) {
+    request_headers_to_log_.emplace_back(header);
+  }
+  for (const auto& header : config.additional_response_headers_to_log()) {
+    response_headers_to_log_.emplace_back(header);
+  }
+  for (const auto& header : config.additional_response_trailers_to_log()) {
+    response_trailers_to_log_.emplace_back(header);
+  }
+}
+
+void BinaryFileAccessLog::appendDelimited(const Protobuf::Message& entry, std::string& output) {
+  const uint32_t size = static_cast<uint32_t>(entry.ByteSizeLong());
+  const size_t start = output.size();
+  output.resize(start + Protobuf::io::CodedOutputStream::VarintSize32(size) + size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(output.data() + start);
+  target = Protobuf::io::CodedOutputStream::WriteVarint32ToArray(size, target);
+  // ByteSizeLong() above cached the sizes of all the sub-messages.
+  entry.SerializeWithCachedSizesToArray(target);
+}
+
+void BinaryFileAccessLog::emitLog(const Formatter::HttpFormatterContext& context,
+                                  const StreamInfo::StreamInfo& stream_info) {
+  envoy::data::accesslog::v3::HTTPAccessLogEntry log_entry;
+  GrpcCommon::Utility::extractCommonAccessLogProperties(
+      *log_entry.mutable_common_properties(), context.requestHeaders(), stream_info,
+      common_config_, context.accessLogType());
+  GrpcCommon::Utility::extractHttpAccessLogProperties(log_entry, context, stream_info,
+                                                      request_headers_to_log_,
+                                                      response_headers_to_log_,
+                                                      response_trailers_to_log_);
+
+  // Records are serialized into a per-thread buffer which keeps its capacity between entries.
+  static thread_local std::string record;
+  record.clear();
+  appendDelimited(log_entry, record);
+  log_file_->write(record);
+}
+
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/file/v3/file.pb.h"
+#include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
+
+#include "source/extensions/access_loggers/common/access_log_base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+
+/**
+ * Access log Instance that writes HTTP log entries to a file as length-delimited binary protos.
+ * Entries are built from the stream info and headers directly rather than through a substitution
+ * formatter, so no text is rendered on the logging path.
+ */
+class BinaryFileAccessLog : public Common::ImplBase {
+public:
+  BinaryFileAccessLog(
+      const Filesystem::FilePathAndType& access_log_file_info, AccessLog::FilterPtr&& filter,
+      const envoy::extensions::access_loggers::file::v3::FileAccessLog::BinaryFormat& config,
+      AccessLog::AccessLogManager& log_manager);
+
+  /**
+   * Serializes an entry prefixed with its length as a varint and appends it to output.
+   */
+  static void appendDelimited(const Protobuf::Message& entry, std::string& output);
+
+private:
+  // Common::ImplBase
+  void emitLog(const Formatter::HttpFormatterContext& context,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  AccessLog::AccessLogFileSharedPtr log_file_;
+  // Left empty, as filter state objects and custom tags are not configurable for binary logs.
+  const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig common_config_;
+  std::vector<Http::LowerCaseString> request_headers_to_log_;
+  std::vector<Http::LowerCaseString> response_headers_to_log_;
+  std::vector<Http::LowerCaseString> response_trailers_to_log_;
+};
+
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -13,6 +13,7 @@
 #include "source/common/formatter/substitution_formatter.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/extensions/access_loggers/common/file_access_log_impl.h"
+#include "source/extensions/access_loggers/file/binary_access_log_impl.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -26,6 +27,7 @@ FileAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config,
   const auto& fal_config = MessageUtil::downcastAndValidate<
       const envoy::extensions::access_loggers::file::v3::FileAccessLog&>(
       config, context.messageValidationVisitor());
+  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, fal_config.path()};
   Formatter::FormatterPtr formatter;
 
   switch (fal_config.access_log_format_case()) {
@@ -60,6 +62,11 @@ FileAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config,
         Formatter::SubstitutionFormatStringUtils::fromProtoConfig(fal_config.log_format(), context),
         Formatter::FormatterBasePtr<Formatter::HttpFormatterContext>);
     break;
+  case envoy::extensions::access_loggers::file::v3::FileAccessLog::AccessLogFormatCase::
+      kBinaryFormat:
+    return std::make_shared<BinaryFileAccessLog>(
+        file_info, std::move(filter), fal_config.binary_format(),
+        context.serverFactoryContext().accessLogManager());
   case envoy::extensions::access_loggers::file::v3::FileAccessLog::AccessLogFormatCase::
       ACCESS_LOG_FORMAT_NOT_SET:
     formatter = THROW_OR_RETURN_VALUE(
@@ -68,7 +75,6 @@ FileAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config,
     break;
   }
 
-  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, fal_config.path()};
   return std::make_shared<FileAccessLog>(file_info, std::move(filter), std::move(formatter),
                                          context.serverFactoryContext().accessLogManager());
 }
@@ -7,7 +7,7 @@
 #include "source/common/config/utility.h"
 #include "source/common/network/utility.h"
 #include "source/common/stream_info/utility.h"
-#include "source/extensions/access_loggers/grpc/grpc_access_log_utils.h"
+#include "source/extensions/access_loggers/common/grpc_access_log_utils.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -380,6 +380,12 @@ EXTENSIONS = {
 
     "envoy.tls.cert_validator.spiffe":                  "//source/extensions/transport_sockets/tls/cert_validator/spiffe:config",
 
+    #
+    # TLS private key providers
+    #
+
+    "envoy.tls.key_providers.batched":                  "//source/extensions/private_key_providers/batched:config",
+
     #
     # HTTP header formatters
     #
@@ -174,7 +174,7 @@ public:
     if (value_ == nullptr || !key.IsString()) {
       return {};
     }
-    auto str = std::string(key.StringOrDie().value());
+    const absl::string_view str = key.StringOrDie().value();
     if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.consistent_header_validation")) {
       if (!Http::HeaderUtility::headerNameIsValid(str)) {
         // Reject key if it is an invalid header string
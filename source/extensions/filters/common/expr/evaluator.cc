@@ -1,5 +1,8 @@
 #include "source/extensions/filters/common/expr/evaluator.h"
 
+#include <array>
+#include <cstddef>
+
 #include "envoy/common/exception.h"
 #include "envoy/singleton/manager.h"
 
@@ -30,30 +33,28 @@ const ActivationLookupTable& getActivationTokens() {
 #undef _PAIR
 }
 
-} // namespace
-
-absl::optional<CelValue> StreamActivation::FindValue(absl::string_view name,
-                                                     Protobuf::Arena* arena) const {
-  const auto& tokens = getActivationTokens();
-  const auto token = tokens.find(name);
-  if (token == tokens.end()) {
-    return {};
-  }
-  if (token->second == ActivationToken::XDS) {
+// Creates the value of a top level attribute.
+absl::optional<CelValue> createValue(ActivationToken token, Protobuf::Arena* arena,
+                                     const LocalInfo::LocalInfo* local_info,
+                                     const StreamInfo::StreamInfo* activation_info,
+                                     const Http::RequestHeaderMap* request_headers,
+                                     const Http::ResponseHeaderMap* response_headers,
+                                     const Http::ResponseTrailerMap* response_trailers) {
+  if (token == ActivationToken::XDS) {
     return CelValue::CreateMap(
-        Protobuf::Arena::Create<XDSWrapper>(arena, *arena, activation_info_, local_info_));
+        Protobuf::Arena::Create<XDSWrapper>(arena, *arena, activation_info, local_info));
   }
-  if (activation_info_ == nullptr) {
+  if (activation_info == nullptr) {
     return {};
   }
-  const StreamInfo::StreamInfo& info = *activation_info_;
-  switch (token->second) {
+  const StreamInfo::StreamInfo& info = *activation_info;
+  switch (token) {
   case ActivationToken::Request:
     return CelValue::CreateMap(
-        Protobuf::Arena::Create<RequestWrapper>(arena, *arena, activation_request_headers_, info));
+        Protobuf::Arena::Create<RequestWrapper>(arena, *arena, request_headers, info));
   case ActivationToken::Response:
     return CelValue::CreateMap(Protobuf::Arena::Create<ResponseWrapper>(
-        arena, *arena, activation_response_headers_, activation_response_trailers_, info));
+        arena, *arena, response_headers, response_trailers, info));
   case ActivationToken::Connection:
     return CelValue::CreateMap(Protobuf::Arena::Create<ConnectionWrapper>(arena, *arena, info));
   case ActivationToken::Upstream:
@@ -79,6 +80,58 @@ absl::optional<CelValue> StreamActivation::FindValue(absl::string_view name,
   return {};
 }
 
+// The activation of a single evaluate() call, which is created on the stack and only ever used
+// with the arena of the evaluation. The value of each top level attribute is created once on the
+// arena, however many times the expression references it.
+class EvaluationActivation : public StreamActivation {
+public:
+  using StreamActivation::StreamActivation;
+
+  absl::optional<CelValue> FindValue(absl::string_view name,
+                                     Protobuf::Arena* arena) const override {
+    const auto& tokens = getActivationTokens();
+    const auto token = tokens.find(name);
+    if (token == tokens.end()) {
+      return {};
+    }
+    ASSERT(arena_ == nullptr || arena_ == arena);
+    arena_ = arena;
+    auto& value = values_[static_cast<size_t>(token->second)];
+    if (!value.has_value()) {
+      value = createValue(token->second, arena, local_info_, activation_info_,
+                          activation_request_headers_, activation_response_headers_,
+                          activation_response_trailers_);
+    }
+    return *value;
+  }
+
+private:
+#define _COUNT(_t) +1
+  static constexpr size_t NumActivationTokens = 0 ACTIVATION_TOKENS(_COUNT);
+#undef _COUNT
+
+  mutable Protobuf::Arena* arena_{};
+  mutable std::array<absl::optional<absl::optional<CelValue>>, NumActivationTokens> values_;
+};
+
+// Evaluations of boolean conditions rarely need more than this much arena memory, which is then
+// taken from the stack instead of the heap.
+constexpr size_t InitialArenaBlockSize = 1024;
+
+} // namespace
+
+absl::optional<CelValue> StreamActivation::FindValue(absl::string_view name,
+                                                     Protobuf::Arena* arena) const {
+  const auto& tokens = getActivationTokens();
+  const auto token = tokens.find(name);
+  if (token == tokens.end()) {
+    return {};
+  }
+  return createValue(token->second, arena, local_info_, activation_info_,
+                     activation_request_headers_, activation_response_headers_,
+                     activation_response_trailers_);
+}
+
 void StreamActivation::resetActivation() const {
   local_info_ = nullptr;
   activation_info_ = nullptr;
@@ -148,9 +201,9 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
                                   const Http::RequestHeaderMap* request_headers,
                                   const Http::ResponseHeaderMap* response_headers,
                                   const Http::ResponseTrailerMap* response_trailers) {
-  auto activation =
-      createActivation(local_info, info, request_headers, response_headers, response_trailers);
-  auto eval_status = expr.Evaluate(*activation, &arena);
+  const EvaluationActivation activation(local_info, info, request_headers, response_headers,
+                                        response_trailers);
+  auto eval_status = expr.Evaluate(activation, &arena);
   if (!eval_status.ok()) {
     return {};
   }
@@ -160,7 +213,8 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
 
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::RequestHeaderMap& headers) {
-  Protobuf::Arena arena;
+  alignas(std::max_align_t) char initial_block[InitialArenaBlockSize];
+  Protobuf::Arena arena(initial_block, sizeof(initial_block));
   auto eval_status = Expr::evaluate(expr, arena, nullptr, info, &headers, nullptr, nullptr);
   if (!eval_status.has_value()) {
     return false;
@@ -1,5 +1,6 @@
 #include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 
@@ -169,12 +170,60 @@ bool AtomicTokenBucket::consume(double factor) {
   return token_bucket_.consume(cb) != 0.0;
 }
 
+DynamicDescriptorCache::DynamicDescriptorCache(uint32_t max_entries, uint32_t max_tokens,
+                                               uint32_t tokens_per_fill,
+                                               std::chrono::milliseconds fill_interval,
+                                               TimeSource& time_source)
+    : max_tokens_(max_tokens), tokens_per_fill_(tokens_per_fill), fill_interval_(fill_interval),
+      time_source_(time_source), buckets_(max_entries) {}
+
+RateLimitTokenBucketSharedPtr
+DynamicDescriptorCache::getOrCreate(const RateLimit::LocalDescriptor& descriptor) {
+  // Requests that already hold an evicted bucket keep it alive until they complete.
+  return buckets_.getOrCreate(descriptor, [this]() -> RateLimitTokenBucketSharedPtr {
+    return std::make_shared<AtomicTokenBucket>(max_tokens_, tokens_per_fill_, fill_interval_,
+                                               time_source_);
+  });
+}
+
+bool LocalRateLimiterImpl::WildcardDescriptor::matches(
+    const RateLimit::LocalDescriptor& request_descriptor) const {
+  // The keys already match, as the wildcard descriptors are indexed by them.
+  ASSERT(KeysEqual()(descriptor_, request_descriptor));
+  for (size_t i = 0; i < descriptor_.entries_.size(); i++) {
+    const std::string& value = descriptor_.entries_[i].value_;
+    if (!value.empty() && value != request_descriptor.entries_[i].value_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t LocalRateLimiterImpl::KeysHash::operator()(
+    const RateLimit::LocalDescriptor& descriptor) const {
+  size_t hash = descriptor.entries_.size();
+  for (const RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+    hash = absl::HashOf(hash, entry.key_);
+  }
+  return hash;
+}
+
+bool LocalRateLimiterImpl::KeysEqual::operator()(const RateLimit::LocalDescriptor& a,
+                                                 const RateLimit::LocalDescriptor& b) const {
+  return std::equal(
+      a.entries_.begin(), a.entries_.end(), b.entries_.begin(), b.entries_.end(),
+      [](const RateLimit::DescriptorEntry& lhs, const RateLimit::DescriptorEntry& rhs) {
+        return lhs.key_ == rhs.key_;
+      });
+}
+
 LocalRateLimiterImpl::LocalRateLimiterImpl(
     const std::chrono::milliseconds fill_interval, const uint32_t max_tokens,
     const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
     const Protobuf::RepeatedPtrField<
         envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
-    bool always_consume_default_token_bucket, ShareProviderSharedPtr shared_provider)
+    bool always_consume_default_token_bucket, ShareProviderSharedPtr shared_provider,
+    uint32_t max_dynamic_descriptors)
     : fill_timer_(fill_interval > std::chrono::milliseconds(0)
                       ? dispatcher.createTimer([this] { onFillTimer(); })
                       : nullptr),
@@ -225,6 +274,21 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     // Save the multiplicative factor to control the descriptor refill frequency.
     const auto per_descriptor_multiplier = per_descriptor_fill_interval / fill_interval;
 
+    const bool wildcard =
+        std::any_of(new_descriptor.entries_.begin(), new_descriptor.entries_.end(),
+                    [](const RateLimit::DescriptorEntry& entry) { return entry.value_.empty(); });
+    if (wildcard && max_dynamic_descriptors > 0) {
+      // The buckets of the request descriptors are created as they are seen, and always refill
+      // lazily so that no timer has to visit them.
+      auto& wildcards = wildcard_descriptors_[new_descriptor];
+      wildcards.push_back({std::move(new_descriptor),
+                           std::make_unique<DynamicDescriptorCache>(
+                               max_dynamic_descriptors, per_descriptor_max_tokens,
+                               per_descriptor_tokens_per_fill, per_descriptor_fill_interval,
+                               time_source_)});
+      continue;
+    }
+
     RateLimitTokenBucketSharedPtr per_descriptor_token_bucket;
     if (no_timer_based_rate_limit_token_bucket_) {
       per_descriptor_token_bucket = std::make_shared<AtomicTokenBucket>(
@@ -269,21 +333,53 @@ void LocalRateLimiterImpl::onFillTimer() {
   fill_timer_->enableTimer(default_token_bucket_->fillInterval());
 }
 
+RateLimitTokenBucketSharedPtr LocalRateLimiterImpl::findWildcardBucket(
+    const RateLimit::LocalDescriptor& request_descriptor) const {
+  auto iter = wildcard_descriptors_.find(request_descriptor);
+  if (iter == wildcard_descriptors_.end()) {
+    return nullptr;
+  }
+  for (const WildcardDescriptor& wildcard : iter->second) {
+    if (wildcard.matches(request_descriptor)) {
+      return wildcard.buckets_->getOrCreate(request_descriptor);
+    }
+  }
+  return nullptr;
+}
+
 LocalRateLimiterImpl::Result LocalRateLimiterImpl::requestAllowed(
     absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const {
 
   // In most cases the request descriptors has only few elements. We use a inlined vector to
   // avoid heap allocation.
   absl::InlinedVector<RateLimitTokenBucket*, 8> matched_descriptors;
+  // Holds the matched buckets of the dynamic descriptor caches, as other workers may evict them.
+  absl::InlinedVector<RateLimitTokenBucketSharedPtr, 2> dynamic_buckets;
 
   // Find all matched descriptors.
   for (const auto& request_descriptor : request_descriptors) {
     auto iter = descriptors_.find(request_descriptor);
     if (iter != descriptors_.end()) {
       matched_descriptors.push_back(iter->second.get());
+    } else if (!wildcard_descriptors_.empty()) {
+      if (RateLimitTokenBucketSharedPtr bucket = findWildcardBucket(request_descriptor)) {
+        matched_descriptors.push_back(bucket.get());
+        dynamic_buckets.push_back(std::move(bucket));
+      }
     }
   }
 
+  // Returns the context of a matched bucket. Only the dynamic buckets need to be owned, as the
+  // others live as long as the limiter.
+  const auto context = [&dynamic_buckets](const RateLimitTokenBucket* bucket) {
+    for (const RateLimitTokenBucketSharedPtr& dynamic_bucket : dynamic_buckets) {
+      if (dynamic_bucket.get() == bucket) {
+        return std::shared_ptr<const TokenBucketContext>(dynamic_bucket);
+      }
+    }
+    return std::shared_ptr<const TokenBucketContext>(std::shared_ptr<void>(), bucket);
+  };
+
   if (matched_descriptors.size() > 1) {
     // Sort the matched descriptors by token bucket fill rate to ensure the descriptor with the
     // smallest fill rate is consumed first.
@@ -301,7 +397,7 @@ LocalRateLimiterImpl::Result LocalRateLimiterImpl::requestAllowed(
     if (!descriptor->consume(share_factor)) {
       // If the request is forbidden by a descriptor, return the result and the descriptor
       // token bucket.
-      return {false, makeOptRefFromPtr<TokenBucketContext>(descriptor)};
+      return {false, context(descriptor)};
     }
   }
 
@@ -310,18 +406,17 @@ LocalRateLimiterImpl::Result LocalRateLimiterImpl::requestAllowed(
     if (const bool result = default_token_bucket_->consume(share_factor); !result) {
       // If the request is forbidden by the default token bucket, return the result and the
       // default token bucket.
-      return {false, makeOptRefFromPtr<TokenBucketContext>(default_token_bucket_.get())};
+      return {false, context(default_token_bucket_.get())};
     }
 
     // If the request is allowed then return the result the token bucket. The descriptor
     // token bucket will be selected as priority if it exists.
-    return {true, makeOptRefFromPtr<TokenBucketContext>(matched_descriptors.empty()
-                                                            ? default_token_bucket_.get()
-                                                            : matched_descriptors[0])};
+    return {true, context(matched_descriptors.empty() ? default_token_bucket_.get()
+                                                      : matched_descriptors[0])};
   };
 
   ASSERT(!matched_descriptors.empty());
-  return {true, makeOptRefFromPtr<TokenBucketContext>(matched_descriptors[0])};
+  return {true, context(matched_descriptors[0])};
 }
 
 } // namespace LocalRateLimit
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 #include <ratio>
 
 #include "envoy/event/dispatcher.h"
@@ -10,10 +11,13 @@
 #include "envoy/singleton/instance.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "source/common/common/sharded_lru_cache.h"
 #include "source/common/common/thread_synchronizer.h"
 #include "source/common/common/token_bucket_impl.h"
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -129,11 +133,39 @@ private:
   AtomicTokenBucketImpl token_bucket_;
 };
 
+/**
+ * Bounded cache of the token buckets created for the request descriptors that match a wildcard
+ * descriptor. Tokens are consumed without holding the lock of the cache. The least recently used
+ * buckets are evicted once the cache holds max_entries of them.
+ */
+class DynamicDescriptorCache {
+public:
+  DynamicDescriptorCache(uint32_t max_entries, uint32_t max_tokens, uint32_t tokens_per_fill,
+                         std::chrono::milliseconds fill_interval, TimeSource& time_source);
+
+  /**
+   * @return the token bucket of the descriptor, which is created full if it is not cached.
+   */
+  RateLimitTokenBucketSharedPtr getOrCreate(const RateLimit::LocalDescriptor& descriptor);
+
+  size_t size() const { return buckets_.size(); }
+
+private:
+  const uint32_t max_tokens_;
+  const uint32_t tokens_per_fill_;
+  const std::chrono::milliseconds fill_interval_;
+  TimeSource& time_source_;
+  ShardedLruCache<RateLimit::LocalDescriptor, RateLimitTokenBucketSharedPtr,
+                  RateLimit::LocalDescriptor::Hash, RateLimit::LocalDescriptor::Equal>
+      buckets_;
+};
+
 class LocalRateLimiterImpl {
 public:
   struct Result {
     bool allowed{};
-    OptRef<const TokenBucketContext> token_bucket_context{};
+    // Owns the token bucket if it may be evicted from the dynamic descriptor cache.
+    std::shared_ptr<const TokenBucketContext> token_bucket_context{};
   };
 
   LocalRateLimiterImpl(
@@ -142,19 +174,42 @@ public:
       const Protobuf::RepeatedPtrField<
           envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
       bool always_consume_default_token_bucket = true,
-      ShareProviderSharedPtr shared_provider = nullptr);
+      ShareProviderSharedPtr shared_provider = nullptr, uint32_t max_dynamic_descriptors = 0);
   ~LocalRateLimiterImpl();
 
   Result requestAllowed(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
 
 private:
+  // A configured descriptor with blank values, which match any value. Each distinct request
+  // descriptor it matches gets its own token bucket.
+  struct WildcardDescriptor {
+    bool matches(const RateLimit::LocalDescriptor& request_descriptor) const;
+
+    RateLimit::LocalDescriptor descriptor_;
+    std::unique_ptr<DynamicDescriptorCache> buckets_;
+  };
+
+  // Hashes and compares descriptors by their keys only, to index the wildcard descriptors by the
+  // keys of the request descriptors they may match.
+  struct KeysHash {
+    size_t operator()(const RateLimit::LocalDescriptor& descriptor) const;
+  };
+  struct KeysEqual {
+    bool operator()(const RateLimit::LocalDescriptor& a, const RateLimit::LocalDescriptor& b) const;
+  };
+
   void onFillTimer();
+  RateLimitTokenBucketSharedPtr
+  findWildcardBucket(const RateLimit::LocalDescriptor& request_descriptor) const;
 
   RateLimitTokenBucketSharedPtr default_token_bucket_;
 
   const Event::TimerPtr fill_timer_;
   TimeSource& time_source_;
   RateLimit::LocalDescriptor::Map<RateLimitTokenBucketSharedPtr> descriptors_;
+  absl::flat_hash_map<RateLimit::LocalDescriptor, std::vector<WildcardDescriptor>, KeysHash,
+                      KeysEqual>
+      wildcard_descriptors_;
   // Refill counter is incremented per each refill timer hit.
   uint64_t refill_counter_{0};
 
@@ -0,0 +1,71 @@
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+CompressionThreadPool::CompressionThreadPool(Thread::ThreadFactory& thread_factory,
+                                             Event::Dispatcher& main_thread_dispatcher,
+                                             uint32_t num_threads)
+    : main_thread_dispatcher_(main_thread_dispatcher) {
+  threads_.reserve(num_threads);
+  while (threads_.size() < num_threads) {
+    threads_.push_back(
+        thread_factory.createThread([this]() { work(); }, Thread::Options{"compressor"}));
+  }
+}
+
+CompressionThreadPool::~CompressionThreadPool() {
+  {
+    absl::MutexLock lock(&mu_);
+    terminating_ = true;
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void CompressionThreadPool::post(std::function<void()> task) {
+  absl::MutexLock lock(&mu_);
+  tasks_.push(std::move(task));
+}
+
+void CompressionThreadPool::releaseOnMainThread(std::shared_ptr<void> object) {
+  main_thread_dispatcher_.post([object = std::move(object)]() {});
+}
+
+void CompressionThreadPool::work() {
+  const auto has_work = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return !tasks_.empty() || terminating_;
+  };
+  while (true) {
+    std::function<void()> task;
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(&has_work));
+      if (tasks_.empty()) {
+        ENVOY_LOG(debug, "compression thread terminating");
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+CompressionThreadPoolSharedPtr CompressionThreadPoolRegistry::getOrCreate(uint32_t num_threads) {
+  absl::MutexLock lock(&mu_);
+  CompressionThreadPoolSharedPtr& pool = pools_[num_threads];
+  if (pool == nullptr) {
+    pool = std::make_shared<CompressionThreadPool>(thread_factory_, main_thread_dispatcher_,
+                                                   num_threads);
+  }
+  return pool;
+}
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+/**
+ * A pool of threads which compress response body chunks for the compressor filter, so that
+ * compressing large responses doesn't delay the other streams of the workers.
+ *
+ * The class is final, as the threads may still be running during the destructor - this is fine
+ * so long as no class members or vtable entries have yet been destroyed, which can be guaranteed
+ * if the class is final.
+ */
+class CompressionThreadPool final : public Logger::Loggable<Logger::Id::filter> {
+public:
+  CompressionThreadPool(Thread::ThreadFactory& thread_factory,
+                        Event::Dispatcher& main_thread_dispatcher, uint32_t num_threads);
+
+  /**
+   * The destructor blocks until the queued tasks have run and the threads are joined.
+   */
+  ~CompressionThreadPool();
+
+  /**
+   * Runs a task on one of the threads of the pool. The tasks run in the order they are posted.
+   * @param task supplies the task to run.
+   */
+  void post(std::function<void()> task);
+
+  /**
+   * Releases an object held by a task on the main thread rather than on the threads of the pool,
+   * for objects which must be destroyed on the thread of an event loop.
+   * @param object supplies the object to release.
+   */
+  void releaseOnMainThread(std::shared_ptr<void> object);
+
+private:
+  // The function that runs on the threads.
+  void work();
+
+  Event::Dispatcher& main_thread_dispatcher_;
+  absl::Mutex mu_;
+  std::queue<std::function<void()>> tasks_ ABSL_GUARDED_BY(mu_);
+  bool terminating_ ABSL_GUARDED_BY(mu_) = false;
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using CompressionThreadPoolSharedPtr = std::shared_ptr<CompressionThreadPool>;
+
+/**
+ * The compression thread pools of the server, so that the filters configured with the same number
+ * of threads share a pool rather than each starting threads of their own.
+ *
+ * The registry holds the pools until it is destroyed, as a pinned singleton, on the main thread at
+ * shutdown. The threads are thus never joined on a worker thread, which may drop the last
+ * reference to a filter config.
+ */
+class CompressionThreadPoolRegistry : public Singleton::Instance {
+public:
+  CompressionThreadPoolRegistry(Thread::ThreadFactory& thread_factory,
+                                Event::Dispatcher& main_thread_dispatcher)
+      : thread_factory_(thread_factory), main_thread_dispatcher_(main_thread_dispatcher) {}
+
+  CompressionThreadPoolSharedPtr getOrCreate(uint32_t num_threads);
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  absl::Mutex mu_;
+  absl::flat_hash_map<uint32_t, CompressionThreadPoolSharedPtr> pools_ ABSL_GUARDED_BY(mu_);
+};
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -3,6 +3,7 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/utility.h"
+#include "source/common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -30,6 +31,10 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Respons
 // Default minimum length of an upstream response that allows compression.
 const uint64_t DefaultMinimumContentLength = 30;
 
+// Defaults of the thread pool that compresses large response chunks.
+const uint32_t DefaultOffloadNumThreads = 1;
+const uint32_t DefaultOffloadMinChunkSize = 65536;
+
 // Default content types will be used if any is provided by the user.
 const std::vector<std::string>& defaultContentEncoding() {
   CONSTRUCT_ON_FIRST_USE(std::vector<std::string>, {"text/html",
@@ -73,6 +78,8 @@ void compressAndUpdateStats(const Compression::Compressor::CompressorPtr& compre
 
 } // namespace
 
+SINGLETON_MANAGER_REGISTRATION(compression_thread_pool_registry);
+
 CompressorFilterConfig::DirectionConfig::DirectionConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig&
         proto_config,
@@ -86,6 +93,8 @@ CompressorFilterConfig::DirectionConfig::DirectionConfig(
 CompressorFilterConfig::CompressorFilterConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
     const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    Singleton::Manager& singleton_manager, Thread::ThreadFactory& thread_factory,
+    Event::Dispatcher& main_thread_dispatcher,
     Compression::Compressor::CompressorFactoryPtr compressor_factory)
     : common_stats_prefix_(fmt::format("{}compressor.{}.{}", stats_prefix,
                                        proto_config.compressor_library().name(),
@@ -94,7 +103,19 @@ CompressorFilterConfig::CompressorFilterConfig(
       response_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
       content_encoding_(compressor_factory->contentEncoding()),
       compressor_factory_(std::move(compressor_factory)),
-      choose_first_(proto_config.choose_first()) {}
+      choose_first_(proto_config.choose_first()),
+      compression_thread_pool_(
+          response_direction_config_.offloadNumThreads() > 0
+              ? singleton_manager
+                    .getTyped<CompressionThreadPoolRegistry>(
+                        SINGLETON_MANAGER_REGISTERED_NAME(compression_thread_pool_registry),
+                        [&thread_factory, &main_thread_dispatcher] {
+                          return std::make_shared<CompressionThreadPoolRegistry>(
+                              thread_factory, main_thread_dispatcher);
+                        },
+                        true)
+                    ->getOrCreate(response_direction_config_.offloadNumThreads())
+              : nullptr) {}
 
 StringUtil::CaseUnorderedSet CompressorFilterConfig::DirectionConfig::contentTypeSet(
     const Protobuf::RepeatedPtrField<std::string>& types) {
@@ -130,6 +151,15 @@ CompressorFilterConfig::ResponseDirectionConfig::ResponseDirectionConfig(
           proto_config.has_response_direction_config()
               ? proto_config.response_direction_config().remove_accept_encoding_header()
               : proto_config.remove_accept_encoding_header()),
+      offload_num_threads_(
+          proto_config.response_direction_config().has_compression_offload()
+              ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+                    proto_config.response_direction_config().compression_offload(), num_threads,
+                    DefaultOffloadNumThreads)
+              : 0),
+      offload_min_chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.response_direction_config().compression_offload(), min_chunk_size,
+          DefaultOffloadMinChunkSize)),
       response_stats_{generateResponseStats(stats_prefix, scope)} {}
 
 const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig
@@ -309,7 +339,19 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (offloaded_compression_ != nullptr) {
+    // Buffer the data until the chunk being compressed on the thread pool is done, so that the
+    // chunks are compressed in order.
+    response_ended_ = end_stream;
+    return Http::FilterDataStatus::StopIterationAndWatermark;
+  }
   if (response_compressor_ != nullptr) {
+    if (config_->compressionThreadPool() != nullptr &&
+        data.length() >= config_->responseDirectionConfig().offloadMinChunkSize()) {
+      response_ended_ = end_stream;
+      offloadCompression(data, end_stream);
+      return Http::FilterDataStatus::StopIterationAndWatermark;
+    }
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
                            end_stream);
   }
@@ -317,6 +359,12 @@ Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool
 }
 
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
+  if (offloaded_compression_ != nullptr) {
+    // The compression library is told that the stream is ended once the chunk being compressed on
+    // the thread pool is done.
+    response_ended_ = true;
+    return Http::FilterTrailersStatus::StopIteration;
+  }
   if (response_compressor_ != nullptr) {
     Buffer::OwnedImpl empty_buffer;
     // The presence of trailers means the stream is ended, but encodeData()
@@ -329,6 +377,91 @@ Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTraile
   return Http::FilterTrailersStatus::Continue;
 }
 
+void CompressorFilter::onDestroy() {
+  if (offloaded_compression_ != nullptr) {
+    absl::MutexLock lock(&offloaded_compression_->mu_);
+    offloaded_compression_->filter_ = nullptr;
+  }
+}
+
+void CompressorFilter::offloadCompression(Buffer::Instance& data, bool end_stream) {
+  const auto& config = config_->responseDirectionConfig();
+  config.stats().total_uncompressed_bytes_.add(data.length());
+  config.responseStats().offloaded_chunks_.inc();
+
+  offloaded_compression_ =
+      std::make_shared<OffloadedCompression>(*this, encoder_callbacks_->dispatcher());
+  offloaded_compression_->compressor_ = std::move(response_compressor_);
+  // Copy the chunk rather than move its slices, so that the fragments it may reference are
+  // released on the worker thread which owns them.
+  offloaded_compression_->data_.add(data);
+  data.drain(data.length());
+  offloaded_compression_->end_stream_ = end_stream;
+
+  CompressionThreadPool& pool = *config_->compressionThreadPool();
+  pool.post([&pool, job = offloaded_compression_]() mutable {
+    bool stream_destroyed;
+    {
+      absl::MutexLock lock(&job->mu_);
+      stream_destroyed = job->filter_ == nullptr;
+    }
+    if (!stream_destroyed) {
+      job->compressor_->compress(job->data_, job->end_stream_
+                                                 ? Envoy::Compression::Compressor::State::Finish
+                                                 : Envoy::Compression::Compressor::State::Flush);
+      absl::MutexLock lock(&job->mu_);
+      if (job->filter_ != nullptr) {
+        // The worker thread can't destroy the stream, and so its dispatcher, before the lock is
+        // released. Nor can it release the job, which is moved to it, as it takes the lock first.
+        Event::Dispatcher& dispatcher = job->dispatcher_;
+        dispatcher.post([job = std::move(job)]() {
+          CompressorFilter* filter;
+          {
+            absl::MutexLock lock(&job->mu_);
+            filter = job->filter_;
+          }
+          if (filter != nullptr) {
+            filter->onOffloadedCompressionDone();
+          }
+        });
+      }
+    }
+    if (job != nullptr) {
+      // The stream was destroyed, so the job may hold the last reference to the filter config.
+      pool.releaseOnMainThread(std::move(job));
+    }
+  });
+}
+
+void CompressorFilter::onOffloadedCompressionDone() {
+  const std::shared_ptr<OffloadedCompression> job = std::move(offloaded_compression_);
+  response_compressor_ = std::move(job->compressor_);
+  const auto& config = config_->responseDirectionConfig();
+  config.stats().total_compressed_bytes_.add(job->data_.length());
+
+  // Insert the compressed chunk between the compressed data and the data received since the job
+  // was started, which the filter manager has buffered.
+  Buffer::OwnedImpl received;
+  encoder_callbacks_->modifyEncodingBuffer([this, &job, &received](Buffer::Instance& buffered) {
+    received.move(buffered);
+    buffered.move(received, compressed_buffered_length_);
+    compressed_buffered_length_ += job->data_.length();
+    buffered.move(job->data_);
+  });
+
+  if (!job->end_stream_ && received.length() >= config.offloadMinChunkSize()) {
+    offloadCompression(received, response_ended_);
+    return;
+  }
+  if (received.length() > 0 || (response_ended_ && !job->end_stream_)) {
+    compressAndUpdateStats(response_compressor_, config.stats(), received, response_ended_);
+    encoder_callbacks_->modifyEncodingBuffer(
+        [&received](Buffer::Instance& buffered) { buffered.move(received); });
+  }
+  compressed_buffered_length_ = 0;
+  encoder_callbacks_->continueEncoding();
+}
+
 bool CompressorFilter::hasCacheControlNoTransform(Http::ResponseHeaderMap& headers) const {
   const Http::HeaderEntry* cache_control = headers.getInline(cache_control_handle.handle());
   if (cache_control) {
@@ -1,13 +1,20 @@
 #pragma once
 
 #include "envoy/compression/compressor/factory.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
+#include "source/extensions/filters/http/compressor/compression_thread_pool.h"
 
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -39,6 +46,9 @@ namespace Compressor {
  *
  * "header_gzip" is specific to the gzip filter and is deprecated since it duplicates
  * "header_compressor_used".
+ *
+ * "offloaded_chunks" is a number of response body chunks compressed on the thread pool configured
+ * with "compression_offload" rather than on the worker thread.
  */
 #define RESPONSE_COMPRESSOR_STATS(COUNTER)                                                         \
   COUNTER(no_accept_header)                                                                        \
@@ -47,7 +57,8 @@ namespace Compressor {
   COUNTER(header_compressor_overshadowed)                                                          \
   COUNTER(header_wildcard)                                                                         \
   COUNTER(header_not_valid)                                                                        \
-  COUNTER(not_compressed_etag)
+  COUNTER(not_compressed_etag)                                                                     \
+  COUNTER(offloaded_chunks)
 
 /**
  * Struct definitions for compressor stats. @see stats_macros.h
@@ -121,6 +132,8 @@ public:
     const ResponseCompressorStats& responseStats() const { return response_stats_; }
     bool disableOnEtagHeader() const { return disable_on_etag_header_; }
     bool removeAcceptEncodingHeader() const { return remove_accept_encoding_header_; }
+    uint32_t offloadNumThreads() const { return offload_num_threads_; }
+    uint32_t offloadMinChunkSize() const { return offload_min_chunk_size_; }
 
   private:
     static ResponseCompressorStats generateResponseStats(const std::string& prefix,
@@ -135,6 +148,10 @@ public:
 
     const bool disable_on_etag_header_;
     const bool remove_accept_encoding_header_;
+    // The number of threads to compress response chunks on, or 0 if the compression isn't
+    // offloaded.
+    const uint32_t offload_num_threads_;
+    const uint32_t offload_min_chunk_size_;
     const ResponseCompressorStats response_stats_;
   };
 
@@ -142,9 +159,13 @@ public:
   CompressorFilterConfig(
       const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
       const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+      Singleton::Manager& singleton_manager, Thread::ThreadFactory& thread_factory,
+      Event::Dispatcher& main_thread_dispatcher,
       Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory);
 
   Envoy::Compression::Compressor::CompressorPtr makeCompressor();
+  // The pool to compress large response chunks on, or nullptr if the compression isn't offloaded.
+  CompressionThreadPool* compressionThreadPool() const { return compression_thread_pool_.get(); }
 
   const std::string contentEncoding() const { return content_encoding_; };
   bool chooseFirst() const { return choose_first_; };
@@ -159,6 +180,7 @@ private:
   const std::string content_encoding_;
   const Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory_;
   const bool choose_first_;
+  const CompressionThreadPoolSharedPtr compression_thread_pool_;
 };
 using CompressorFilterConfigSharedPtr = std::shared_ptr<CompressorFilterConfig>;
 
@@ -197,7 +219,38 @@ public:
   Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
   Http::FilterTrailersStatus encodeTrailers(Http::ResponseTrailerMap&) override;
 
+  // Http::StreamFilterBase
+  void onDestroy() override;
+
 private:
+  /**
+   * A response body chunk being compressed on the compression thread pool. The compressor of the
+   * response is moved to the job while it runs, and moved back once the worker thread is notified
+   * of its completion.
+   */
+  struct OffloadedCompression {
+    OffloadedCompression(CompressorFilter& filter, Event::Dispatcher& dispatcher)
+        : config_(filter.config_), dispatcher_(dispatcher), filter_(&filter) {}
+
+    // Keeps the compressor factory, which the compressor may reference, alive until the job is
+    // done, as the stream and the filter config may be destroyed while the chunk is compressed.
+    // The job is thus never released on the threads of the pool, but on the worker thread, or on
+    // the main thread once the stream is gone. Declared before the compressor so that the
+    // compressor is destroyed first.
+    const CompressorFilterConfigSharedPtr config_;
+    Envoy::Compression::Compressor::CompressorPtr compressor_;
+    // The chunk to compress, which holds the compressed chunk once the job is done.
+    Buffer::OwnedImpl data_;
+    bool end_stream_{};
+    Event::Dispatcher& dispatcher_;
+    absl::Mutex mu_;
+    // Reset when the stream is destroyed, so that the result of the job is discarded.
+    CompressorFilter* filter_ ABSL_GUARDED_BY(mu_);
+  };
+
+  void offloadCompression(Buffer::Instance& data, bool end_stream);
+  void onOffloadedCompressionDone();
+
   bool compressionEnabled(const CompressorFilterConfig::ResponseDirectionConfig& config,
                           const CompressorPerRouteFilterConfig* per_route_config) const;
   bool removeAcceptEncodingHeader(const CompressorFilterConfig::ResponseDirectionConfig& config,
@@ -235,6 +288,12 @@ private:
   Envoy::Compression::Compressor::CompressorPtr request_compressor_;
   const CompressorFilterConfigSharedPtr config_;
   std::unique_ptr<std::string> accept_encoding_;
+  // The response chunk being compressed on the thread pool, if any.
+  std::shared_ptr<OffloadedCompression> offloaded_compression_;
+  // The length of the compressed data at the front of the buffered response body while a chunk is
+  // being compressed on the thread pool. The rest of the buffered body isn't compressed yet.
+  uint64_t compressed_buffered_length_{0};
+  bool response_ended_{false};
 };
 
 } // namespace Compressor
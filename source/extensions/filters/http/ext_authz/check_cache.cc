@@ -0,0 +1,179 @@
+#include "source/extensions/filters/http/ext_authz/check_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+using Filters::Common::ExtAuthz::CheckStatus;
+using Filters::Common::ExtAuthz::Response;
+using Filters::Common::ExtAuthz::ResponsePtr;
+
+namespace {
+
+constexpr uint64_t DefaultTtlMs = 10000;
+constexpr uint32_t DefaultMaxEntries = 10000;
+// The longest TTL taken from the response metadata, one year, which keeps the expiry time of the
+// entries representable.
+constexpr double MaxTtlSeconds = 365 * 24 * 3600;
+
+} // namespace
+
+CheckCache::CheckCache(uint32_t max_entries, TimeSource& time_source)
+    : max_entries_(max_entries), time_source_(time_source) {}
+
+ResponsePtr CheckCache::lookup(const std::string& key) {
+  auto it = lru_map_.find(key);
+  if (it == lru_map_.end()) {
+    return nullptr;
+  }
+  LruList::iterator entry = it->second;
+  if (entry->expiry_time_ <= time_source_.monotonicTime()) {
+    lru_map_.erase(it);
+    lru_list_.erase(entry);
+    return nullptr;
+  }
+  lru_list_.splice(lru_list_.begin(), lru_list_, entry);
+  return std::make_unique<Response>(entry->response_);
+}
+
+bool CheckCache::join(const std::string& key, CoalescedCheckCallbacks& callbacks) {
+  auto [it, inserted] = in_flight_.try_emplace(key);
+  if (inserted) {
+    return false;
+  }
+  it->second.push_back(&callbacks);
+  return true;
+}
+
+void CheckCache::leave(const std::string& key, CoalescedCheckCallbacks& callbacks) {
+  auto it = in_flight_.find(key);
+  if (it != in_flight_.end()) {
+    it->second.remove(&callbacks);
+  }
+}
+
+void CheckCache::abandon(const std::string& key) {
+  auto it = in_flight_.find(key);
+  if (it == in_flight_.end()) {
+    return;
+  }
+  if (it->second.empty()) {
+    in_flight_.erase(it);
+    return;
+  }
+  CoalescedCheckCallbacks* next = it->second.front();
+  it->second.pop_front();
+  next->onCheckAbandoned();
+}
+
+void CheckCache::complete(const std::string& key, const Response& response,
+                          std::chrono::milliseconds ttl) {
+  if (response.status != CheckStatus::Error && ttl.count() > 0) {
+    const MonotonicTime expiry_time = time_source_.monotonicTime() + ttl;
+    auto it = lru_map_.find(key);
+    if (it != lru_map_.end()) {
+      it->second->response_ = response;
+      it->second->expiry_time_ = expiry_time;
+      lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+    } else {
+      lru_list_.emplace_front(key, response, expiry_time);
+      lru_map_[key] = lru_list_.begin();
+      if (lru_list_.size() > max_entries_) {
+        lru_map_.erase(lru_list_.back().key_);
+        lru_list_.pop_back();
+      }
+    }
+  }
+
+  auto it = in_flight_.find(key);
+  if (it == in_flight_.end()) {
+    return;
+  }
+  // Detach the waiters first, as their callbacks may start new calls for the same key.
+  std::list<CoalescedCheckCallbacks*> waiters = std::move(it->second);
+  in_flight_.erase(it);
+  for (CoalescedCheckCallbacks* waiter : waiters) {
+    waiter->onComplete(std::make_unique<Response>(response));
+  }
+}
+
+CheckCacheConfig::CheckCacheConfig(
+    const envoy::extensions::filters::http::ext_authz::v3::CheckCache& config,
+    ThreadLocal::SlotAllocator& tls)
+    : key_headers_(config.key_headers().begin(), config.key_headers().end()),
+      ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, ttl, DefaultTtlMs)),
+      ttl_metadata_key_(config.ttl_metadata_key()), tls_(tls) {
+  const uint32_t max_entries =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries);
+  tls_.set([max_entries](Event::Dispatcher& dispatcher) {
+    return std::make_shared<CheckCache>(max_entries, dispatcher.timeSource());
+  });
+}
+
+absl::optional<std::string>
+CheckCacheConfig::cacheKey(const Http::RequestHeaderMap& headers,
+                           const envoy::service::auth::v3::AttributeContext& attributes) const {
+  std::string key;
+  bool found = false;
+  for (const Http::LowerCaseString& name : key_headers_) {
+    // Prefix the values of each header with their count, and each value with its length, so that
+    // different splits of the same bytes across headers and values don't produce the same key.
+    const auto result = headers.get(name);
+    absl::StrAppend(&key, result.size(), "#");
+    for (size_t i = 0; i < result.size(); i++) {
+      const absl::string_view value = result[i]->value().getStringView();
+      absl::StrAppend(&key, value.size(), ":", value, ";");
+    }
+    found = found || !result.empty();
+  }
+  if (!found) {
+    return absl::nullopt;
+  }
+
+  // Routes with different context extensions, or streams with different metadata, may get
+  // different decisions for the same headers, so these are appended in full rather than hashed.
+  envoy::service::auth::v3::AttributeContext context;
+  *context.mutable_context_extensions() = attributes.context_extensions();
+  *context.mutable_metadata_context() = attributes.metadata_context();
+  *context.mutable_route_metadata_context() = attributes.route_metadata_context();
+  std::string serialized;
+  {
+    Protobuf::io::StringOutputStream stream(&serialized);
+    Protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.SetSerializationDeterministic(true);
+    context.SerializeToCodedStream(&coded_stream);
+  }
+  absl::StrAppend(&key, serialized.size(), "#", serialized);
+  return key;
+}
+
+std::chrono::milliseconds CheckCacheConfig::ttl(const Response& response) const {
+  if (!ttl_metadata_key_.empty()) {
+    const auto& fields = response.dynamic_metadata.fields();
+    const auto it = fields.find(ttl_metadata_key_);
+    if (it != fields.end() && it->second.kind_case() == ProtobufWkt::Value::kNumberValue) {
+      // The metadata comes from the authorization server, so the value may be of any size, or not
+      // a number at all.
+      const double seconds = it->second.number_value();
+      if (std::isnan(seconds) || seconds <= 0) {
+        return std::chrono::milliseconds(0);
+      }
+      return std::chrono::milliseconds(
+          static_cast<int64_t>(std::min(seconds, MaxTtlSeconds) * 1000));
+    }
+  }
+  return ttl_;
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
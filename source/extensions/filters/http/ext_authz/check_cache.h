@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/service/auth/v3/attribute_context.pb.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+/**
+ * Callbacks for a request that waits on a check call made on behalf of another request with the
+ * same cache key. The response of that call is delivered with onComplete().
+ */
+class CoalescedCheckCallbacks : public Filters::Common::ExtAuthz::RequestCallbacks {
+public:
+  /**
+   * Called when the request that was making the shared check call went away before the call
+   * completed. The callee must now make the call itself and report its response with
+   * CheckCache::complete().
+   */
+  virtual void onCheckAbandoned() PURE;
+};
+
+/**
+ * Per worker cache of authorization decisions. It also tracks the check calls in flight so that
+ * concurrent requests with the same cache key share a single call.
+ */
+class CheckCache : public ThreadLocal::ThreadLocalObject {
+public:
+  CheckCache(uint32_t max_entries, TimeSource& time_source);
+
+  /**
+   * @return a copy of the unexpired decision cached for the key, or nullptr if there is none.
+   */
+  Filters::Common::ExtAuthz::ResponsePtr lookup(const std::string& key);
+
+  /**
+   * Waits for the check call in flight for the key, if there is one.
+   * @return true if the callbacks will be called with the response of the call in flight, or false
+   *         if there is no such call. In the latter case the caller must make the call and report
+   *         its response with complete(), or call abandon() if it goes away before that.
+   */
+  bool join(const std::string& key, CoalescedCheckCallbacks& callbacks);
+
+  /**
+   * Stops waiting for the check call in flight for the key.
+   */
+  void leave(const std::string& key, CoalescedCheckCallbacks& callbacks);
+
+  /**
+   * Reports that the check call in flight for the key will not complete. The first waiter, if any,
+   * takes over making the call.
+   */
+  void abandon(const std::string& key);
+
+  /**
+   * Reports the response of the check call for the key. Decisions other than errors are cached for
+   * the given ttl, and every waiter is called with a copy of the response.
+   */
+  void complete(const std::string& key, const Filters::Common::ExtAuthz::Response& response,
+                std::chrono::milliseconds ttl);
+
+  size_t size() const { return lru_list_.size(); }
+
+private:
+  struct CacheEntry {
+    CacheEntry(const std::string& key, const Filters::Common::ExtAuthz::Response& response,
+               MonotonicTime expiry_time)
+        : key_(key), response_(response), expiry_time_(expiry_time) {}
+    std::string key_;
+    Filters::Common::ExtAuthz::Response response_;
+    MonotonicTime expiry_time_;
+  };
+  using LruList = std::list<CacheEntry>;
+
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  LruList lru_list_;
+  absl::flat_hash_map<std::string, LruList::iterator> lru_map_;
+  // The requests waiting on each check call in flight, keyed by cache key.
+  absl::flat_hash_map<std::string, std::list<CoalescedCheckCallbacks*>> in_flight_;
+};
+
+/**
+ * Configuration of the decision cache, shared by all the filter instances of a filter config.
+ */
+class CheckCacheConfig {
+public:
+  CheckCacheConfig(const envoy::extensions::filters::http::ext_authz::v3::CheckCache& config,
+                   ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * @param headers the request headers.
+   * @param attributes the attributes of the check request built for the request. Its context
+   *        extensions and metadata contexts are part of the key, as they come from the route and
+   *        the stream rather than from the key headers.
+   * @return the cache key of the request, or nullopt if the request has none of the key headers.
+   */
+  absl::optional<std::string>
+  cacheKey(const Http::RequestHeaderMap& headers,
+           const envoy::service::auth::v3::AttributeContext& attributes) const;
+
+  /**
+   * @return how long the decision in the response may be cached.
+   */
+  std::chrono::milliseconds ttl(const Filters::Common::ExtAuthz::Response& response) const;
+
+  /**
+   * @return the cache of the calling worker.
+   */
+  CheckCache& cache() { return *tls_; }
+
+private:
+  const std::vector<Http::LowerCaseString> key_headers_;
+  const std::chrono::milliseconds ttl_;
+  const std::string ttl_metadata_key_;
+  ThreadLocal::TypedSlot<CheckCache> tls_;
+};
+
+using CheckCacheConfigPtr = std::unique_ptr<CheckCacheConfig>;
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
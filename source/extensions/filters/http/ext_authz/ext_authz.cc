@@ -119,6 +119,10 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::ext_authz::v3
       charge_cluster_response_stats_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, charge_cluster_response_stats, true)),
       stats_(generateStats(stats_prefix, config.stat_prefix(), scope)),
+      check_cache_(config.has_check_cache()
+                       ? std::make_unique<CheckCacheConfig>(config.check_cache(),
+                                                            factory_context.threadLocal())
+                       : nullptr),
       ext_authz_ok_(pool_.add(createPoolStatName(config.stat_prefix(), "ok"))),
       ext_authz_denied_(pool_.add(createPoolStatName(config.stat_prefix(), "denied"))),
       ext_authz_error_(pool_.add(createPoolStatName(config.stat_prefix(), "error"))),
@@ -201,6 +205,57 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
     }
   }
 
+  // Store start time of ext_authz filter call
+  start_time_ = decoder_callbacks_->dispatcher().timeSource().monotonicTime();
+
+  state_ = State::Calling;
+  filter_return_ = FilterReturn::StopDecoding; // Don't let the filter chain continue as we are
+                                               // going to invoke check call.
+  cluster_ = decoder_callbacks_->clusterInfo();
+  initiating_call_ = true;
+  // The check request is built before the cache lookup, as the per-route context extensions and
+  // the metadata contexts it carries are part of the cache key.
+  buildCheckRequest(headers);
+  if (!checkFromCache(headers)) {
+    ENVOY_STREAM_LOG(trace, "ext_authz filter calling authorization server", *decoder_callbacks_);
+    client_->check(*this, check_request_, decoder_callbacks_->activeSpan(),
+                   decoder_callbacks_->streamInfo());
+  }
+  initiating_call_ = false;
+}
+
+bool Filter::checkFromCache(const Http::RequestHeaderMap& headers) {
+  // Requests whose body is sent to the authorization server are never cached, as the body may
+  // affect the decision.
+  if (config_->checkCache() == nullptr || buffer_data_) {
+    return false;
+  }
+  cache_key_ = config_->checkCache()->cacheKey(headers, check_request_.attributes());
+  if (!cache_key_.has_value()) {
+    return false;
+  }
+
+  CheckCache& cache = config_->checkCache()->cache();
+  Filters::Common::ExtAuthz::ResponsePtr response = cache.lookup(*cache_key_);
+  if (response != nullptr) {
+    ENVOY_STREAM_LOG(trace, "ext_authz filter using cached decision", *decoder_callbacks_);
+    stats_.check_cache_hit_.inc();
+    cache_key_.reset();
+    onComplete(std::move(response));
+    return true;
+  }
+  if (cache.join(*cache_key_, *this)) {
+    ENVOY_STREAM_LOG(trace, "ext_authz filter waiting on a check call in flight",
+                     *decoder_callbacks_);
+    stats_.check_coalesced_.inc();
+    coalesced_ = true;
+    return true;
+  }
+  stats_.check_cache_miss_.inc();
+  return false;
+}
+
+void Filter::buildCheckRequest(const Http::RequestHeaderMap& headers) {
   absl::optional<FilterConfigPerRoute> maybe_merged_per_route_config;
   for (const FilterConfigPerRoute& cfg :
        Http::Utility::getAllPerFilterConfig<FilterConfigPerRoute>(decoder_callbacks_)) {
@@ -240,19 +295,15 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
       config_->headersAsBytes(), config_->includePeerCertificate(), config_->includeTLSSession(),
       config_->destinationLabels(), config_->allowedHeadersMatcher(),
       config_->disallowedHeadersMatcher());
+}
 
+void Filter::onCheckAbandoned() {
+  // The request that was making the check call for this one went away, so make it instead. Its
+  // check request was already built before it joined the call.
+  coalesced_ = false;
   ENVOY_STREAM_LOG(trace, "ext_authz filter calling authorization server", *decoder_callbacks_);
-  // Store start time of ext_authz filter call
-  start_time_ = decoder_callbacks_->dispatcher().timeSource().monotonicTime();
-
-  state_ = State::Calling;
-  filter_return_ = FilterReturn::StopDecoding; // Don't let the filter chain continue as we are
-                                               // going to invoke check call.
-  cluster_ = decoder_callbacks_->clusterInfo();
-  initiating_call_ = true;
   client_->check(*this, check_request_, decoder_callbacks_->activeSpan(),
                  decoder_callbacks_->streamInfo());
-  initiating_call_ = false;
 }
 
 Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers, bool end_stream) {
@@ -452,7 +503,14 @@ void Filter::setEncoderFilterCallbacks(Http::StreamEncoderFilterCallbacks& callb
 void Filter::onDestroy() {
   if (state_ == State::Calling) {
     state_ = State::Complete;
+    if (coalesced_) {
+      config_->checkCache()->cache().leave(*cache_key_, *this);
+      return;
+    }
     client_->cancel();
+    if (cache_key_.has_value()) {
+      config_->checkCache()->cache().abandon(*cache_key_);
+    }
   }
 }
 
@@ -469,6 +527,11 @@ CheckResult Filter::validateAndCheckDecoderHeaderMutation(
 
 void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   state_ = State::Complete;
+  if (cache_key_.has_value() && !coalesced_) {
+    // Share the decision before it is modified below.
+    config_->checkCache()->cache().complete(*cache_key_, *response,
+                                            config_->checkCache()->ttl(*response));
+  }
   using Filters::Common::ExtAuthz::CheckStatus;
   Stats::StatName empty_stat_name;
 
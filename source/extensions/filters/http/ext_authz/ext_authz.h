@@ -19,12 +19,14 @@
 #include "source/common/common/utility.h"
 #include "source/common/http/codes.h"
 #include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/common/ext_authz/check_request_utils.h"
 #include "source/extensions/filters/common/ext_authz/ext_authz.h"
 #include "source/extensions/filters/common/ext_authz/ext_authz_grpc_impl.h"
 #include "source/extensions/filters/common/ext_authz/ext_authz_http_impl.h"
 #include "source/extensions/filters/common/mutation_rules/mutation_rules.h"
+#include "source/extensions/filters/http/ext_authz/check_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -43,7 +45,10 @@ namespace ExtAuthz {
   COUNTER(failure_mode_allowed)                                                                    \
   COUNTER(invalid)                                                                                 \
   COUNTER(ignored_dynamic_metadata)                                                                \
-  COUNTER(filter_state_name_collision)
+  COUNTER(filter_state_name_collision)                                                             \
+  COUNTER(check_cache_hit)                                                                         \
+  COUNTER(check_cache_miss)                                                                        \
+  COUNTER(check_coalesced)
 
 /**
  * Wrapper struct for ext_authz filter stats. @see stats_macros.h
@@ -206,6 +211,9 @@ public:
     return disallowed_headers_matcher_;
   }
 
+  // Returns nullptr if decisions are not cached.
+  CheckCacheConfig* checkCache() const { return check_cache_.get(); }
+
 private:
   static Http::Code toErrorCode(uint64_t status) {
     const auto code = static_cast<Http::Code>(status);
@@ -271,6 +279,8 @@ private:
   Filters::Common::ExtAuthz::MatcherSharedPtr allowed_headers_matcher_;
   Filters::Common::ExtAuthz::MatcherSharedPtr disallowed_headers_matcher_;
 
+  const CheckCacheConfigPtr check_cache_;
+
 public:
   // TODO(nezdolik): deprecate cluster scope stats counters in favor of filter scope stats
   // (ExtAuthzFilterStats stats_).
@@ -337,7 +347,7 @@ private:
  */
 class Filter : public Logger::Loggable<Logger::Id::ext_authz>,
                public Http::StreamFilter,
-               public Filters::Common::ExtAuthz::RequestCallbacks {
+               public CoalescedCheckCallbacks {
 public:
   Filter(const FilterConfigSharedPtr& config, Filters::Common::ExtAuthz::ClientPtr&& client)
       : config_(config), client_(std::move(client)), stats_(config->stats()) {}
@@ -364,6 +374,9 @@ public:
   // ExtAuthz::RequestCallbacks
   void onComplete(Filters::Common::ExtAuthz::ResponsePtr&&) override;
 
+  // CoalescedCheckCallbacks
+  void onCheckAbandoned() override;
+
 private:
   // Convenience function for the following:
   // 1. If `validate_mutations` is set to true, validate header key and value.
@@ -380,6 +393,10 @@ private:
   absl::optional<MonotonicTime> start_time_;
   void addResponseHeaders(Http::HeaderMap& header_map, const Http::HeaderVector& headers);
   void initiateCall(const Http::RequestHeaderMap& headers);
+  void buildCheckRequest(const Http::RequestHeaderMap& headers);
+  // Serves the check from the decision cache or a shared call in flight if possible. Returns false
+  // if the caller must make the check call.
+  bool checkFromCache(const Http::RequestHeaderMap& headers);
   void continueDecoding();
   bool isBufferFull(uint64_t num_bytes_processing) const;
   void updateLoggingInfo();
@@ -426,7 +443,15 @@ private:
   bool initiating_call_{};
   bool buffer_data_{};
   bool skip_check_{false};
-  envoy::service::auth::v3::CheckRequest check_request_{};
+  // The check request lives on a per-stream arena so that building its many header and metadata
+  // fields costs a few block allocations instead of one allocation per field.
+  Protobuf::Arena arena_;
+  envoy::service::auth::v3::CheckRequest& check_request_{
+      *Protobuf::Arena::Create<envoy::service::auth::v3::CheckRequest>(&arena_)};
+  // Set when the decision of this request may be cached or shared with other requests.
+  absl::optional<std::string> cache_key_;
+  // Whether this request waits on a check call made for another request.
+  bool coalesced_{};
 };
 
 } // namespace ExtAuthz
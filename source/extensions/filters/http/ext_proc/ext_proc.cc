@@ -202,6 +202,8 @@ FilterConfig::FilterConfig(const ExternalProcessor& config,
       grpc_service_(getFilterGrpcService(config)),
       send_body_without_waiting_for_header_response_(
           config.send_body_without_waiting_for_header_response()),
+      max_streamed_chunks_in_flight_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_streamed_chunks_in_flight, 0)),
       stats_(generateStats(stats_prefix, config.stat_prefix(), scope)),
       processing_mode_(config.processing_mode()),
       mutation_checker_(config.mutation_rules(), context.regexEngine()),
@@ -224,6 +224,8 @@ public:
     return send_body_without_waiting_for_header_response_;
   }
 
+  uint32_t maxStreamedChunksInFlight() const { return max_streamed_chunks_in_flight_; }
+
   const ExtProcFilterStats& stats() const { return stats_; }
 
   const envoy::extensions::filters::http::ext_proc::v3::ProcessingMode& processingMode() const {
@@ -297,6 +299,7 @@ private:
   const uint32_t max_message_timeout_ms_;
   const absl::optional<const envoy::config::core::v3::GrpcService> grpc_service_;
   const bool send_body_without_waiting_for_header_response_;
+  const uint32_t max_streamed_chunks_in_flight_;
 
   ExtProcFilterStats stats_;
   const envoy::extensions::filters::http::ext_proc::v3::ProcessingMode processing_mode_;
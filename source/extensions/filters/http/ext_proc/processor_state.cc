@@ -479,6 +479,25 @@ void ProcessorState::enqueueStreamingChunk(Buffer::Instance& data, bool end_stre
   }
 }
 
+bool ProcessorState::queueOverHighLimit() const {
+  if (chunk_queue_.bytesEnqueued() > bufferLimit()) {
+    return true;
+  }
+  // In STREAMED mode, also stop reading once the configured number of chunks are waiting for a
+  // response from the processor, so that a slow processor doesn't accumulate many small chunks.
+  const uint32_t window = filter_.config().maxStreamedChunksInFlight();
+  return body_mode_ == ProcessingMode::STREAMED && window > 0 && chunk_queue_.size() >= window;
+}
+
+bool ProcessorState::queueBelowLowLimit() const {
+  if (chunk_queue_.bytesEnqueued() >= bufferLimit() / 2) {
+    return false;
+  }
+  const uint32_t window = filter_.config().maxStreamedChunksInFlight();
+  return body_mode_ != ProcessingMode::STREAMED || window == 0 ||
+         chunk_queue_.size() <= window / 2;
+}
+
 QueuedChunkPtr ProcessorState::dequeueStreamingChunk(Buffer::OwnedImpl& out_data) {
   return chunk_queue_.pop(out_data);
 }
@@ -39,6 +39,7 @@ public:
   ChunkQueue(const ChunkQueue&) = delete;
   ChunkQueue& operator=(const ChunkQueue&) = delete;
   uint32_t bytesEnqueued() const { return bytes_enqueued_; }
+  size_t size() const { return queue_.size(); }
   bool empty() const { return queue_.empty(); }
   void push(Buffer::Instance& data, bool end_stream);
   void clear();
@@ -186,8 +187,8 @@ public:
   QueuedChunkPtr dequeueStreamingChunk(Buffer::OwnedImpl& out_data);
   // Consolidate all the chunks on the queue into a single one and return a reference.
   const QueuedChunk& consolidateStreamedChunks() { return chunk_queue_.consolidate(); }
-  bool queueOverHighLimit() const { return chunk_queue_.bytesEnqueued() > bufferLimit(); }
-  bool queueBelowLowLimit() const { return chunk_queue_.bytesEnqueued() < bufferLimit() / 2; }
+  bool queueOverHighLimit() const;
+  bool queueBelowLowLimit() const;
   bool shouldRemoveContentLength() const {
     // Always remove the content length in 3 cases below:
     // 1) STREAMED BodySendMode
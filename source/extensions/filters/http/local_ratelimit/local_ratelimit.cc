@@ -17,6 +17,31 @@ namespace Extensions {
 namespace HttpFilters {
 namespace LocalRateLimitFilter {
 
+namespace {
+
+constexpr uint32_t DefaultMaxDynamicDescriptors = 20;
+
+// Returns the descriptors followed by the wildcard descriptors. The limiter treats the empty entry
+// values, which only the wildcard descriptors can have, as matching any value.
+Protobuf::RepeatedPtrField<envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>
+descriptorsWithWildcards(
+    const envoy::extensions::filters::http::local_ratelimit::v3::LocalRateLimit& config) {
+  Protobuf::RepeatedPtrField<envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>
+      descriptors = config.descriptors();
+  for (const auto& wildcard : config.wildcard_descriptors()) {
+    auto* descriptor = descriptors.Add();
+    for (const auto& wildcard_entry : wildcard.entries()) {
+      auto* entry = descriptor->add_entries();
+      entry->set_key(wildcard_entry.key());
+      entry->set_value(wildcard_entry.value());
+    }
+    *descriptor->mutable_token_bucket() = wildcard.token_bucket();
+  }
+  return descriptors;
+}
+
+} // namespace
+
 const std::string& PerConnectionRateLimiter::key() {
   CONSTRUCT_ON_FIRST_USE(std::string, "per_connection_local_rate_limiter");
 }
@@ -30,7 +55,7 @@ FilterConfig::FilterConfig(
           PROTOBUF_GET_MS_OR_DEFAULT(config.token_bucket(), fill_interval, 0))),
       max_tokens_(config.token_bucket().max_tokens()),
       tokens_per_fill_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.token_bucket(), tokens_per_fill, 1)),
-      descriptors_(config.descriptors()),
+      descriptors_(descriptorsWithWildcards(config)),
       rate_limit_per_connection_(config.local_rate_limit_per_downstream_connection()),
       always_consume_default_token_bucket_(
           config.has_always_consume_default_token_bucket()
@@ -54,7 +79,7 @@ FilterConfig::FilterConfig(
           Envoy::Router::HeaderParser::configure(config.request_headers_to_add_when_not_enforced()),
           Router::HeaderParserPtr)),
       stage_(static_cast<uint64_t>(config.stage())),
-      has_descriptors_(!config.descriptors().empty()),
+      has_descriptors_(!descriptors_.empty()),
       enable_x_rate_limit_headers_(config.enable_x_ratelimit_headers() ==
                                    envoy::extensions::common::ratelimit::v3::DRAFT_VERSION_03),
       vh_rate_limits_(config.vh_rate_limits()),
@@ -77,7 +102,7 @@ FilterConfig::FilterConfig(
   THROW_IF_NOT_OK_REF(creation_status);
 
   if (rate_limit_config_->empty()) {
-    if (!config.descriptors().empty()) {
+    if (!descriptors_.empty()) {
       ENVOY_LOG_FIRST_N(
           warn, 20,
           "'descriptors' is set but only used by route configuration. Please configure the local "
@@ -109,7 +134,9 @@ FilterConfig::FilterConfig(
 
   rate_limiter_ = std::make_unique<Filters::Common::LocalRateLimit::LocalRateLimiterImpl>(
       fill_interval_, max_tokens_, tokens_per_fill_, dispatcher_, descriptors_,
-      always_consume_default_token_bucket_, std::move(share_provider));
+      always_consume_default_token_bucket_, std::move(share_provider),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_dynamic_descriptors,
+                                      DefaultMaxDynamicDescriptors));
 }
 
 Filters::Common::LocalRateLimit::LocalRateLimiterImpl::Result FilterConfig::requestAllowed(
@@ -165,8 +192,9 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
 
   auto result = requestAllowed(descriptors);
   // The global limiter, route limiter, or connection level limiter are all have longer life
-  // than the request, so we can safely store the token bucket context reference.
-  token_bucket_context_ = result.token_bucket_context;
+  // than the request. The context owns the token buckets of the dynamic descriptors, which may be
+  // evicted before the request completes.
+  token_bucket_context_ = std::move(result.token_bucket_context);
 
   if (result.allowed) {
     used_config_->stats().ok_.inc();
@@ -196,7 +224,7 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
 
 Http::FilterHeadersStatus Filter::encodeHeaders(Http::ResponseHeaderMap& headers, bool) {
   // We can never assume the decodeHeaders() was called before encodeHeaders().
-  if (used_config_->enableXRateLimitHeaders() && token_bucket_context_.has_value()) {
+  if (used_config_->enableXRateLimitHeaders() && token_bucket_context_ != nullptr) {
     headers.addReferenceKey(
         HttpFilters::Common::RateLimit::XRateLimitHeaders::get().XRateLimitLimit,
         token_bucket_context_->maxTokens());
@@ -25,7 +25,8 @@ Http::FilterFactoryCb RateLimitFilterConfig::createFilterFactoryFromProtoTyped(
   ASSERT(!proto_config.domain().empty());
   FilterConfigSharedPtr filter_config(new FilterConfig(proto_config, server_context.localInfo(),
                                                        context.scope(), server_context.runtime(),
-                                                       server_context.httpContext()));
+                                                       server_context.httpContext(),
+                                                       server_context.threadLocal()));
   const std::chrono::milliseconds timeout =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(proto_config, timeout, 20));
 
@@ -0,0 +1,117 @@
+#include "source/extensions/filters/http/ratelimit/quota_lease.h"
+
+#include <algorithm>
+
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+
+namespace {
+
+constexpr size_t MinSweepSize = 1024;
+
+} // namespace
+
+QuotaLeases::QuotaLeases(std::chrono::milliseconds lease_ttl, TimeSource& time_source)
+    : lease_ttl_(lease_ttl), time_source_(time_source), sweep_size_(MinSweepSize) {}
+
+QuotaLeases::Lease* QuotaLeases::find(const std::string& key, MonotonicTime now) {
+  auto it = leases_.find(key);
+  if (it == leases_.end()) {
+    return nullptr;
+  }
+  if (it->second.expiry_time_ <= now) {
+    leases_.erase(it);
+    return nullptr;
+  }
+  return &it->second;
+}
+
+QuotaLeases::Lease& QuotaLeases::renew(const std::string& key, MonotonicTime now) {
+  if (leases_.size() >= sweep_size_) {
+    absl::erase_if(leases_, [now](const auto& entry) { return entry.second.expiry_time_ <= now; });
+    sweep_size_ = std::max(MinSweepSize, 2 * leases_.size());
+  }
+  Lease& lease = leases_[key];
+  if (lease.expiry_time_ <= now) {
+    lease = Lease{};
+  }
+  lease.expiry_time_ = now + lease_ttl_;
+  return lease;
+}
+
+LeaseDecision QuotaLeases::consume(const std::string& key, uint64_t hits) {
+  Lease* lease = find(key, time_source_.monotonicTime());
+  if (lease != nullptr) {
+    if (lease->refused_) {
+      return LeaseDecision::PerRequest;
+    }
+    if (lease->remaining_ >= hits) {
+      lease->remaining_ -= hits;
+      return LeaseDecision::Allow;
+    }
+  }
+  // Only one lease call is in flight per key. Concurrent requests don't wait for it, as it may be
+  // refused, and fall back to a call for their own hits instead.
+  if (!pending_.insert(key).second) {
+    return LeaseDecision::PerRequest;
+  }
+  return LeaseDecision::Lease;
+}
+
+void QuotaLeases::onLeaseGranted(const std::string& key, uint64_t hits) {
+  pending_.erase(key);
+  Lease& lease = renew(key, time_source_.monotonicTime());
+  // A lease granted while leasing is refused, e.g. by a call that was in flight, ends the refusal.
+  lease.refused_ = false;
+  lease.remaining_ += hits;
+}
+
+void QuotaLeases::onLeaseRefused(const std::string& key) {
+  pending_.erase(key);
+  Lease& lease = renew(key, time_source_.monotonicTime());
+  lease.refused_ = true;
+  lease.remaining_ = 0;
+}
+
+void QuotaLeases::onLeaseAbandoned(const std::string& key) { pending_.erase(key); }
+
+QuotaLeaseConfig::QuotaLeaseConfig(
+    const envoy::extensions::filters::http::ratelimit::v3::RateLimit::QuotaLeasing& config,
+    ThreadLocal::SlotAllocator& tls)
+    : lease_size_(config.lease_size()), tls_(tls) {
+  const std::chrono::milliseconds lease_ttl(PROTOBUF_GET_MS_REQUIRED(config, lease_ttl));
+  tls_.set([lease_ttl](Event::Dispatcher& dispatcher) {
+    return std::make_shared<QuotaLeases>(lease_ttl, dispatcher.timeSource());
+  });
+}
+
+std::string
+QuotaLeaseConfig::leaseKey(absl::string_view domain,
+                           const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  // Prefix each string with its length, and each descriptor with its number of entries, so that
+  // different splits of the same bytes don't produce the same key.
+  std::string key = absl::StrCat(domain.size(), ":", domain);
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    absl::StrAppend(&key, "|", descriptor.entries_.size(), "#");
+    for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+      absl::StrAppend(&key, entry.key_.size(), ":", entry.key_, entry.value_.size(), ":",
+                      entry.value_);
+    }
+    if (descriptor.limit_.has_value()) {
+      absl::StrAppend(&key, "@", descriptor.limit_->requests_per_unit_, "/",
+                      static_cast<int>(descriptor.limit_->unit_));
+    }
+  }
+  return key;
+}
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
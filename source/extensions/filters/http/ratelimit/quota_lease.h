@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ratelimit/v3/rate_limit.pb.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+
+/**
+ * What a request must do to be rate limited when leasing is enabled.
+ */
+enum class LeaseDecision {
+  // The request was allowed with hits of a lease held by the worker.
+  Allow,
+  // The request must make a lease call, and report its result with onLeaseGranted(),
+  // onLeaseRefused() or onLeaseAbandoned().
+  Lease,
+  // A lease was recently refused, or the lease call for the key is in flight, so the request must
+  // make a call for its own hits.
+  PerRequest
+};
+
+/**
+ * Per worker leases of rate limit quota, keyed by the domain and descriptors of the requests they
+ * apply to.
+ */
+class QuotaLeases : public ThreadLocal::ThreadLocalObject {
+public:
+  QuotaLeases(std::chrono::milliseconds lease_ttl, TimeSource& time_source);
+
+  /**
+   * Spends the hits of a request from the lease for the key, if it holds enough of them. Otherwise
+   * the request is told to make the lease call for the key, unless that call is already in flight.
+   */
+  LeaseDecision consume(const std::string& key, uint64_t hits);
+
+  /**
+   * Adds the hits of a granted lease to the lease for the key, and restarts its ttl.
+   */
+  void onLeaseGranted(const std::string& key, uint64_t hits);
+
+  /**
+   * Drops the lease for the key, and makes the requests for the key fall back to a call per request
+   * for the lease ttl.
+   */
+  void onLeaseRefused(const std::string& key);
+
+  /**
+   * Reports that the lease call for the key failed or was cancelled, so that the next request that
+   * finds the lease spent makes a new one.
+   */
+  void onLeaseAbandoned(const std::string& key);
+
+  size_t size() const { return leases_.size(); }
+
+private:
+  struct Lease {
+    uint64_t remaining_{};
+    MonotonicTime expiry_time_;
+    bool refused_{};
+  };
+
+  // Returns the unexpired lease for the key, or nullptr if there is none.
+  Lease* find(const std::string& key, MonotonicTime now);
+  Lease& renew(const std::string& key, MonotonicTime now);
+
+  const std::chrono::milliseconds lease_ttl_;
+  TimeSource& time_source_;
+  absl::flat_hash_map<std::string, Lease> leases_;
+  // The keys with a lease call in flight.
+  absl::flat_hash_set<std::string> pending_;
+  // Expired leases are swept when the map grows to this size.
+  size_t sweep_size_;
+};
+
+/**
+ * Configuration of quota leasing, shared by all the filter instances of a filter config.
+ */
+class QuotaLeaseConfig {
+public:
+  QuotaLeaseConfig(
+      const envoy::extensions::filters::http::ratelimit::v3::RateLimit::QuotaLeasing& config,
+      ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * @return the key of the lease that applies to requests with the domain and descriptors.
+   */
+  static std::string leaseKey(absl::string_view domain,
+                              const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+
+  uint32_t leaseSize() const { return lease_size_; }
+
+  /**
+   * @return the leases of the calling worker.
+   */
+  QuotaLeases& leases() { return *tls_; }
+
+private:
+  const uint32_t lease_size_;
+  ThreadLocal::TypedSlot<QuotaLeases> tls_;
+};
+
+using QuotaLeaseConfigPtr = std::unique_ptr<QuotaLeaseConfig>;
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
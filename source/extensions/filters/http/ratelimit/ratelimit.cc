@@ -1,5 +1,6 @@
 #include "source/extensions/filters/http/ratelimit/ratelimit.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -89,12 +90,16 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
   const StreamInfo::UInt32Accessor* hits_addend_filter_state =
       callbacks_->streamInfo().filterState()->getDataReadOnly<StreamInfo::UInt32Accessor>(
           HitsAddendFilterStateKey);
-  double hits_addend = 0;
+  uint32_t hits_addend = 0;
   if (hits_addend_filter_state != nullptr) {
     hits_addend = hits_addend_filter_state->value();
   }
 
   if (!descriptors.empty()) {
+    hits_addend_ = hits_addend;
+    if (allowFromLease(descriptors, hits_addend)) {
+      return;
+    }
     state_ = State::Calling;
     initiating_call_ = true;
     client_->limit(*this, getDomain(), descriptors, callbacks_->activeSpan(),
@@ -103,6 +108,60 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
   }
 }
 
+bool Filter::allowFromLease(const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                            uint32_t& hits_addend) {
+  QuotaLeaseConfig* quota_leasing = config_->quotaLeasing();
+  if (quota_leasing == nullptr) {
+    return false;
+  }
+  // The rate limit service counts a hits_addend of zero as one hit.
+  const uint32_t hits = std::max<uint32_t>(hits_addend, 1);
+  std::string key = QuotaLeaseConfig::leaseKey(getDomain(), descriptors);
+  switch (quota_leasing->leases().consume(key, hits)) {
+  case LeaseDecision::Allow:
+    cluster_->statsScope().counterFromStatName(config_->statNames().leased_).inc();
+    return true;
+  case LeaseDecision::Lease:
+    lease_key_ = std::move(key);
+    lease_descriptors_ = descriptors;
+    hits_addend = std::max(quota_leasing->leaseSize(), hits);
+    return false;
+  case LeaseDecision::PerRequest:
+    return false;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+bool Filter::completeLeaseCall(Filters::Common::RateLimit::LimitStatus status) {
+  if (!lease_key_.has_value()) {
+    return false;
+  }
+  const std::string key = std::move(lease_key_.value());
+  lease_key_.reset();
+  QuotaLeaseConfig& quota_leasing = *config_->quotaLeasing();
+  const uint32_t hits = std::max<uint32_t>(hits_addend_, 1);
+  switch (status) {
+  case Filters::Common::RateLimit::LimitStatus::OK:
+    // This request spends its own hits from the lease.
+    quota_leasing.leases().onLeaseGranted(key, std::max(quota_leasing.leaseSize(), hits) - hits);
+    return false;
+  case Filters::Common::RateLimit::LimitStatus::Error:
+    quota_leasing.leases().onLeaseAbandoned(key);
+    return false;
+  case Filters::Common::RateLimit::LimitStatus::OverLimit:
+    break;
+  }
+  // The service may still have room for the hits of this request alone, so ask for them. The
+  // requests that follow make a call per request until the refusal expires.
+  cluster_->statsScope().counterFromStatName(config_->statNames().lease_refused_).inc();
+  quota_leasing.leases().onLeaseRefused(key);
+  const std::vector<Envoy::RateLimit::Descriptor> descriptors = std::move(lease_descriptors_);
+  lease_descriptors_.clear();
+  client_->limit(*this, getDomain(), descriptors, callbacks_->activeSpan(),
+                 callbacks_->streamInfo(), hits_addend_);
+  return true;
+}
+
 Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers, bool) {
   if (!config_->runtime().snapshot().featureEnabled("ratelimit.http_filter_enabled", 100)) {
     return Http::FilterHeadersStatus::Continue;
@@ -161,6 +220,10 @@ void Filter::onDestroy() {
   if (state_ == State::Calling) {
     state_ = State::Complete;
     client_->cancel();
+    if (lease_key_.has_value()) {
+      config_->quotaLeasing()->leases().onLeaseAbandoned(lease_key_.value());
+      lease_key_.reset();
+    }
   }
 }
 
@@ -170,6 +233,9 @@ void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
                       Http::RequestHeaderMapPtr&& request_headers_to_add,
                       const std::string& response_body,
                       Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) {
+  if (completeLeaseCall(status)) {
+    return;
+  }
   state_ = State::Complete;
   response_headers_to_add_ = std::move(response_headers_to_add);
   Http::HeaderMapPtr req_headers_to_add = std::move(request_headers_to_add);
@@ -12,6 +12,7 @@
 #include "envoy/ratelimit/ratelimit.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/assert.h"
@@ -19,6 +20,7 @@
 #include "source/common/router/header_parser.h"
 #include "source/extensions/filters/common/ratelimit/ratelimit.h"
 #include "source/extensions/filters/common/ratelimit/stat_names.h"
+#include "source/extensions/filters/http/ratelimit/quota_lease.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -42,7 +44,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::ratelimit::v3::RateLimit& config,
                const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-               Runtime::Loader& runtime, Http::Context& http_context)
+               Runtime::Loader& runtime, Http::Context& http_context,
+               ThreadLocal::SlotAllocator& tls)
       : domain_(config.domain()), stage_(static_cast<uint64_t>(config.stage())),
         request_type_(config.request_type().empty() ? stringToType("both")
                                                     : stringToType(config.request_type())),
@@ -61,7 +64,10 @@ public:
         response_headers_parser_(THROW_OR_RETURN_VALUE(
             Envoy::Router::HeaderParser::configure(config.response_headers_to_add()),
             Router::HeaderParserPtr)),
-        status_on_error_(toRatelimitServerErrorCode(config.status_on_error().code())) {}
+        status_on_error_(toRatelimitServerErrorCode(config.status_on_error().code())),
+        quota_leasing_(config.has_quota_leasing()
+                           ? std::make_unique<QuotaLeaseConfig>(config.quota_leasing(), tls)
+                           : nullptr) {}
   const std::string& domain() const { return domain_; }
   const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
   uint64_t stage() const { return stage_; }
@@ -79,6 +85,8 @@ public:
   Http::Code rateLimitedStatus() { return rate_limited_status_; }
   const Router::HeaderParser& responseHeadersParser() const { return *response_headers_parser_; }
   Http::Code statusOnError() const { return status_on_error_; }
+  // Returns the quota leasing configuration, or nullptr if leasing is disabled.
+  QuotaLeaseConfig* quotaLeasing() const { return quota_leasing_.get(); }
 
 private:
   static FilterRequestType stringToType(const std::string& request_type) {
@@ -123,6 +131,7 @@ private:
   const Http::Code rate_limited_status_;
   Router::HeaderParserPtr response_headers_parser_;
   const Http::Code status_on_error_;
+  const QuotaLeaseConfigPtr quota_leasing_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -185,6 +194,11 @@ public:
 
 private:
   void initiateCall(const Http::RequestHeaderMap& headers);
+  // Returns true if the request was allowed from a lease, or updates the hits to request otherwise.
+  bool allowFromLease(const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                      uint32_t& hits_addend);
+  // Returns true if a refused lease call was replaced by a call for the hits of the request.
+  bool completeLeaseCall(Filters::Common::RateLimit::LimitStatus status);
   void populateRateLimitDescriptors(const Router::RateLimitPolicy& rate_limit_policy,
                                     std::vector<Envoy::RateLimit::Descriptor>& descriptors,
                                     const Http::RequestHeaderMap& headers) const;
@@ -206,6 +220,10 @@ private:
   bool initiating_call_{};
   Http::ResponseHeaderMapPtr response_headers_to_add_;
   Http::RequestHeaderMap* request_headers_{};
+  // Set while the call in flight is a lease call for the lease with this key.
+  absl::optional<std::string> lease_key_;
+  std::vector<Envoy::RateLimit::Descriptor> lease_descriptors_;
+  uint32_t hits_addend_{};
 };
 
 } // namespace RateLimitFilter
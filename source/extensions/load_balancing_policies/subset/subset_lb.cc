@@ -1,6 +1,7 @@
 #include "source/extensions/load_balancing_policies/subset/subset_lb.h"
 
 #include <memory>
+#include <numeric>
 
 #include "envoy/common/optref.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -12,6 +13,8 @@
 #include "source/common/config/well_known_names.h"
 #include "source/common/protobuf/utility.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_set.h"
 
 namespace Envoy {
@@ -40,6 +43,122 @@ filterCriteriaBySelectors(const std::vector<SubsetSelectorPtr>& subset_selectors
   return nullptr;
 }
 
+/**
+ * Index of the host metadata values referenced by the subset selectors of a priority. Every
+ * distinct value of a selector key is hashed once per update and assigned a dense id, and the ids
+ * of each host are recorded by host position. Subsets are then formed by partitioning host
+ * positions by value id, rather than by copying and hashing the protobuf values of every host for
+ * every selector.
+ */
+class HostMetadataIndex {
+public:
+  struct KeyIndex {
+    // Distinct values of the key, addressed by value id.
+    std::vector<HashedValue> values_;
+    // Value ids of each host, addressed by host position. Empty if the host has no value for the
+    // key. A host may have several ids if list values are treated as any of their elements.
+    std::vector<absl::InlinedVector<uint32_t, 1>> host_values_;
+    // Value ids by value hash, used to intern the values of the key.
+    absl::flat_hash_map<std::size_t, absl::InlinedVector<uint32_t, 1>> ids_by_hash_;
+  };
+
+  HostMetadataIndex(const std::vector<SubsetSelectorPtr>& subset_selectors,
+                    const HostVector& hosts, bool list_as_any) {
+    for (const auto& subset_selector : subset_selectors) {
+      for (const auto& key : subset_selector->selectorKeys()) {
+        keys_[key].host_values_.resize(hosts.size());
+      }
+    }
+
+    for (uint32_t pos = 0; pos < hosts.size(); pos++) {
+      const auto metadata = hosts[pos]->metadata();
+      if (metadata == nullptr) {
+        continue;
+      }
+      const auto& filter_it =
+          metadata->filter_metadata().find(Config::MetadataFilters::get().ENVOY_LB);
+      if (filter_it == metadata->filter_metadata().end()) {
+        continue;
+      }
+
+      const auto& fields = filter_it->second.fields();
+      for (auto& [key, key_index] : keys_) {
+        const auto it = fields.find(key);
+        if (it == fields.end()) {
+          continue;
+        }
+
+        auto& host_values = key_index.host_values_[pos];
+        if (list_as_any && it->second.kind_case() == ProtobufWkt::Value::kListValue) {
+          for (const auto& v : it->second.list_value().values()) {
+            host_values.push_back(intern(key_index, v));
+          }
+        } else {
+          host_values.push_back(intern(key_index, it->second));
+        }
+      }
+    }
+  }
+
+  const KeyIndex* find(const std::string& key) const {
+    const auto it = keys_.find(key);
+    return it == keys_.end() || it->second.values_.empty() ? nullptr : &it->second;
+  }
+
+private:
+  uint32_t intern(KeyIndex& key_index, const ProtobufWkt::Value& value) {
+    auto& ids = key_index.ids_by_hash_[ValueUtil::hash(value)];
+    for (const uint32_t id : ids) {
+      if (ValueUtil::equal(key_index.values_[id].value(), value)) {
+        return id;
+      }
+    }
+    const uint32_t id = key_index.values_.size();
+    key_index.values_.emplace_back(value);
+    ids.push_back(id);
+    return id;
+  }
+
+  absl::flat_hash_map<std::string, KeyIndex> keys_;
+};
+
+using HostGroupCb = std::function<void(const SubsetLoadBalancer::SubsetMetadataRefs& kvs,
+                                       const std::vector<uint32_t>& positions)>;
+
+/**
+ * Recursively partitions the host positions by the value ids of each key, invoking cb once per
+ * distinct combination of values with the (sorted) host positions that have it.
+ */
+void forEachHostGroup(const std::vector<std::pair<absl::string_view,
+                                                  const HostMetadataIndex::KeyIndex*>>& keys,
+                      uint32_t idx, const std::vector<uint32_t>& positions,
+                      SubsetLoadBalancer::SubsetMetadataRefs& kvs, const HostGroupCb& cb) {
+  if (idx == keys.size()) {
+    cb(kvs, positions);
+    return;
+  }
+
+  const auto& [key, key_index] = keys[idx];
+  // Groups are kept in order of first appearance so that subsets are visited deterministically.
+  absl::flat_hash_map<uint32_t, uint32_t> group_by_value;
+  std::vector<std::pair<uint32_t, std::vector<uint32_t>>> groups;
+  for (const uint32_t pos : positions) {
+    for (const uint32_t value_id : key_index->host_values_[pos]) {
+      const auto [it, inserted] = group_by_value.try_emplace(value_id, groups.size());
+      if (inserted) {
+        groups.emplace_back(value_id, std::vector<uint32_t>());
+      }
+      groups[it->second].second.push_back(pos);
+    }
+  }
+
+  for (const auto& [value_id, group_positions] : groups) {
+    kvs.emplace_back(key, &key_index->values_[value_id]);
+    forEachHostGroup(keys, idx + 1, group_positions, kvs, cb);
+    kvs.pop_back();
+  }
+}
+
 } // namespace
 
 using HostPredicate = std::function<bool(const Host&)>;
@@ -469,35 +588,57 @@ void SubsetLoadBalancer::initLbSubsetEntryOnce(LbSubsetEntryPtr& entry, bool sin
   stats_.lb_subsets_created_.inc();
 }
 
-// Iterates all the hosts of specified priority, looking up an LbSubsetEntryPtr for each and add
-// hosts to related entry. Because the metadata of host can be updated inlined, we must evaluate
-// every hosts for every update.
+// Partitions all the hosts of specified priority by the metadata values of each selector's keys,
+// looking up an LbSubsetEntryPtr for each distinct combination of values and adding the matching
+// hosts to it. Because the metadata of host can be updated inlined, we must evaluate every hosts
+// for every update.
 void SubsetLoadBalancer::processSubsets(uint32_t priority, const HostVector& all_hosts) {
   absl::flat_hash_set<const LbSubsetEntry*> single_host_entries;
   uint64_t collision_count_of_single_host_entries{};
 
-  for (const auto& host : all_hosts) {
-    for (const auto& subset_selector : subset_selectors_) {
-      const auto& keys = subset_selector->selectorKeys();
-      // For each host, for each subset key, attempt to extract the metadata corresponding to the
-      // key from the host.
-      std::vector<SubsetMetadata> all_kvs = extractSubsetMetadata(keys, *host);
-      for (const auto& kvs : all_kvs) {
-        // The host has metadata for each key, find or create its subset.
-        auto entry = findOrCreateLbSubsetEntry(subsets_, kvs, 0);
-        initLbSubsetEntryOnce(entry, subset_selector->singleHostPerSubset());
-
-        if (entry->single_host_subset_) {
-          if (single_host_entries.contains(entry.get())) {
-            collision_count_of_single_host_entries++;
-            continue;
-          }
-          single_host_entries.emplace(entry.get());
-        }
+  const HostMetadataIndex index(subset_selectors_, all_hosts, list_as_any_);
+  std::vector<uint32_t> all_positions(all_hosts.size());
+  std::iota(all_positions.begin(), all_positions.end(), 0);
 
-        entry->lb_subset_->pushHost(priority, host);
+  std::vector<std::pair<absl::string_view, const HostMetadataIndex::KeyIndex*>> keys;
+  SubsetMetadataRefs kvs;
+  for (const auto& subset_selector : subset_selectors_) {
+    keys.clear();
+    for (const auto& key : subset_selector->selectorKeys()) {
+      const HostMetadataIndex::KeyIndex* key_index = index.find(key);
+      if (key_index == nullptr) {
+        // No host has a value for this key, so no host matches the selector.
+        break;
       }
+      keys.emplace_back(key, key_index);
     }
+    if (keys.size() != subset_selector->selectorKeys().size()) {
+      continue;
+    }
+
+    const bool single_host_per_subset = subset_selector->singleHostPerSubset();
+    auto add_hosts = [&](const SubsetMetadataRefs& group_kvs,
+                         const std::vector<uint32_t>& positions) {
+      // The hosts have metadata for each key, find or create their subset.
+      auto entry = findOrCreateLbSubsetEntry(subsets_, group_kvs, 0);
+      initLbSubsetEntryOnce(entry, single_host_per_subset);
+
+      if (entry->single_host_subset_) {
+        // Only the first host is kept, every other one is a collision.
+        if (!single_host_entries.emplace(entry.get()).second) {
+          collision_count_of_single_host_entries += positions.size();
+          return;
+        }
+        collision_count_of_single_host_entries += positions.size() - 1;
+        entry->lb_subset_->pushHost(priority, all_hosts[positions.front()]);
+        return;
+      }
+
+      for (const uint32_t pos : positions) {
+        entry->lb_subset_->pushHost(priority, all_hosts[pos]);
+      }
+    };
+    forEachHostGroup(keys, 0, all_positions, kvs, add_hosts);
   }
 
   // This stat isn't added to `ClusterTrafficStats` because it wouldn't be used for nearly all
@@ -532,69 +673,6 @@ bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host
       kvs, host.metadata().get(), Config::MetadataFilters::get().ENVOY_LB, list_as_any_);
 }
 
-// Iterates over subset_keys looking up values from the given host's metadata. Each key-value pair
-// is appended to kvs. Returns a non-empty value if the host has a value for each key.
-std::vector<SubsetLoadBalancer::SubsetMetadata>
-SubsetLoadBalancer::extractSubsetMetadata(const std::set<std::string>& subset_keys,
-                                          const Host& host) {
-  std::vector<SubsetMetadata> all_kvs;
-  if (!host.metadata()) {
-    return all_kvs;
-  }
-  const envoy::config::core::v3::Metadata& metadata = *host.metadata();
-  const auto& filter_it = metadata.filter_metadata().find(Config::MetadataFilters::get().ENVOY_LB);
-  if (filter_it == metadata.filter_metadata().end()) {
-    return all_kvs;
-  }
-
-  const auto& fields = filter_it->second.fields();
-  for (const auto& key : subset_keys) {
-    const auto it = fields.find(key);
-    if (it == fields.end()) {
-      all_kvs.clear();
-      break;
-    }
-
-    if (list_as_any_ && it->second.kind_case() == ProtobufWkt::Value::kListValue) {
-      // If the list of kvs is empty, we initialize one kvs for each value in the list.
-      // Otherwise, we branch the list of kvs by generating one new kvs per old kvs per
-      // new value.
-      //
-      // For example, two kvs (<a=1>, <a=2>) joined with the kv foo=[bar,baz] results in four kvs:
-      //   <a=1,foo=bar>
-      //   <a=1,foo=baz>
-      //   <a=2,foo=bar>
-      //   <a=2,foo=baz>
-      if (all_kvs.empty()) {
-        for (const auto& v : it->second.list_value().values()) {
-          all_kvs.emplace_back(SubsetMetadata({make_pair(key, v)}));
-        }
-      } else {
-        std::vector<SubsetMetadata> new_kvs;
-        for (const auto& kvs : all_kvs) {
-          for (const auto& v : it->second.list_value().values()) {
-            auto kv_copy = kvs;
-            kv_copy.emplace_back(make_pair(key, v));
-            new_kvs.emplace_back(kv_copy);
-          }
-        }
-        all_kvs = new_kvs;
-      }
-
-    } else {
-      if (all_kvs.empty()) {
-        all_kvs.emplace_back(SubsetMetadata({std::make_pair(key, it->second)}));
-      } else {
-        for (auto& kvs : all_kvs) {
-          kvs.emplace_back(std::make_pair(key, it->second));
-        }
-      }
-    }
-  }
-
-  return all_kvs;
-}
-
 std::string SubsetLoadBalancer::describeMetadata(const SubsetLoadBalancer::SubsetMetadata& kvs) {
   if (kvs.empty()) {
     return "<no metadata>";
@@ -615,16 +693,15 @@ std::string SubsetLoadBalancer::describeMetadata(const SubsetLoadBalancer::Subse
   return buf.str();
 }
 
-// Given a vector of key-values (from extractSubsetMetadata), recursively finds the matching
+// Given a vector of key-values (from a HostMetadataIndex), recursively finds the matching
 // LbSubsetEntryPtr.
 SubsetLoadBalancer::LbSubsetEntryPtr
-SubsetLoadBalancer::findOrCreateLbSubsetEntry(LbSubsetMap& subsets, const SubsetMetadata& kvs,
+SubsetLoadBalancer::findOrCreateLbSubsetEntry(LbSubsetMap& subsets, const SubsetMetadataRefs& kvs,
                                               uint32_t idx) {
   ASSERT(idx < kvs.size());
 
-  const std::string& name = kvs[idx].first;
-  const ProtobufWkt::Value& pb_value = kvs[idx].second;
-  const HashedValue value(pb_value);
+  const absl::string_view name = kvs[idx].first;
+  const HashedValue& value = *kvs[idx].second;
 
   LbSubsetEntryPtr entry;
 
@@ -646,7 +723,7 @@ SubsetLoadBalancer::findOrCreateLbSubsetEntry(LbSubsetMap& subsets, const Subset
       value_subset_map.emplace(value, entry);
     } else {
       ValueSubsetMap value_subset_map = {{value, entry}};
-      subsets.emplace(name, value_subset_map);
+      subsets.emplace(std::string(name), value_subset_map);
     }
   }
 
@@ -25,6 +25,7 @@
 #include "source/extensions/load_balancing_policies/subset/subset_lb_config.h"
 
 #include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -59,6 +60,8 @@ public:
 
   std::string childLoadBalancerName() const { return lb_config_.childLoadBalancerName(); }
   using SubsetMetadata = std::vector<std::pair<std::string, ProtobufWkt::Value>>;
+  // Lexically sorted key-values that reference interned values of a HostMetadataIndex.
+  using SubsetMetadataRefs = std::vector<std::pair<absl::string_view, const HashedValue*>>;
   static std::string describeMetadata(const SubsetMetadata& kvs);
 
 private:
@@ -357,13 +360,11 @@ private:
   LbSubsetEntryPtr
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
 
-  LbSubsetEntryPtr findOrCreateLbSubsetEntry(LbSubsetMap& subsets, const SubsetMetadata& kvs,
+  LbSubsetEntryPtr findOrCreateLbSubsetEntry(LbSubsetMap& subsets, const SubsetMetadataRefs& kvs,
                                              uint32_t idx);
   void forEachSubset(LbSubsetMap& subsets, std::function<void(LbSubsetEntryPtr&)> cb);
   void purgeEmptySubsets(LbSubsetMap& subsets);
 
-  std::vector<SubsetMetadata> extractSubsetMetadata(const std::set<std::string>& subset_keys,
-                                                    const Host& host);
   HostConstSharedPtr chooseHostWithMetadataFallbacks(LoadBalancerContext* context,
                                                      const MetadataFallbacks& metadata_fallbacks);
   const ProtobufWkt::Value* getMetadataFallbackList(LoadBalancerContext* context) const;
@@ -0,0 +1,80 @@
+#include "source/extensions/private_key_providers/batched/config.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "envoy/extensions/private_key_providers/batched/v3/batched.pb.h"
+#include "envoy/extensions/private_key_providers/batched/v3/batched.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/config/datasource.h"
+#include "source/common/config/utility.h"
+#include "source/common/protobuf/message_validator_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/common/tls/private_key/batched_private_key_provider.h"
+#include "source/extensions/private_key_providers/batched/software_batch_processor.h"
+
+#include "openssl/pem.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+
+using TransportSockets::Tls::BatchedPrivateKeyMethodProvider;
+using TransportSockets::Tls::PrivateKeyThreadPoolRegistry;
+using TransportSockets::Tls::PrivateKeyThreadPoolSharedPtr;
+
+SINGLETON_MANAGER_REGISTRATION(private_key_thread_pool_registry);
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+BatchedPrivateKeyMethodFactory::createPrivateKeyMethodProviderInstance(
+    const envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider& proto_config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  envoy::extensions::private_key_providers::batched::v3::BatchedPrivateKeyMethodConfig config;
+  THROW_IF_NOT_OK(Config::Utility::translateOpaqueConfig(
+      proto_config.typed_config(), ProtobufMessage::getNullValidationVisitor(), config));
+  MessageUtil::validate(config, factory_context.messageValidationVisitor());
+
+  Server::Configuration::ServerFactoryContext& server_context =
+      factory_context.serverFactoryContext();
+  const std::string private_key = THROW_OR_RETURN_VALUE(
+      Config::DataSource::read(config.private_key(), false, server_context.api()), std::string);
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey == nullptr) {
+    throw EnvoyException("Failed to read private key.");
+  }
+  if (EVP_PKEY_id(pkey.get()) != EVP_PKEY_RSA && EVP_PKEY_id(pkey.get()) != EVP_PKEY_EC) {
+    throw EnvoyException("Only RSA and ECDSA keys are supported by the batched private key "
+                         "provider.");
+  }
+
+  // The registry is pinned, as the providers only hold the pools it hands out. Otherwise it would
+  // be destroyed after each lookup, and each provider would start threads of its own.
+  const uint32_t num_threads = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, num_threads, std::max(1U, std::thread::hardware_concurrency()));
+  PrivateKeyThreadPoolSharedPtr thread_pool =
+      server_context.singletonManager()
+          .getTyped<PrivateKeyThreadPoolRegistry>(
+              SINGLETON_MANAGER_REGISTERED_NAME(private_key_thread_pool_registry),
+              [] { return std::make_shared<PrivateKeyThreadPoolRegistry>(); }, true)
+          ->getOrCreate(num_threads, server_context.api().threadFactory());
+
+  return std::make_shared<BatchedPrivateKeyMethodProvider>(
+      std::make_shared<SoftwarePrivateKeyBatchProcessor>(std::move(pkey)), std::move(thread_pool),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_size, 16),
+      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, max_batch_delay, 1)),
+      server_context.threadLocal());
+}
+
+REGISTER_FACTORY(BatchedPrivateKeyMethodFactory, Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
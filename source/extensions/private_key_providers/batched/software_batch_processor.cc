@@ -0,0 +1,90 @@
+#include "source/extensions/private_key_providers/batched/software_batch_processor.h"
+
+#include "openssl/err.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+
+using TransportSockets::Tls::PrivateKeyOperation;
+using TransportSockets::Tls::PrivateKeyOperationBatch;
+using TransportSockets::Tls::PrivateKeyOperationSharedPtr;
+
+SoftwarePrivateKeyBatchProcessor::SoftwarePrivateKeyBatchProcessor(bssl::UniquePtr<EVP_PKEY> pkey)
+    : pkey_(std::move(pkey)) {}
+
+void SoftwarePrivateKeyBatchProcessor::process(const PrivateKeyOperationBatch& batch) {
+  for (const PrivateKeyOperationSharedPtr& operation : batch) {
+    operation->success_ = operation->type_ == PrivateKeyOperation::Type::Sign
+                              ? sign(*operation)
+                              : decrypt(*operation);
+    if (!operation->success_) {
+      // Don't leave the errors of the operation to the next operation on this thread.
+      ERR_clear_error();
+    }
+  }
+}
+
+bool SoftwarePrivateKeyBatchProcessor::sign(PrivateKeyOperation& operation) {
+  const uint16_t signature_algorithm = operation.signature_algorithm_;
+  if (EVP_PKEY_id(pkey_.get()) != SSL_get_signature_algorithm_key_type(signature_algorithm)) {
+    return false;
+  }
+
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pctx,
+                          SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                          pkey_.get())) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1))) {
+    return false;
+  }
+
+  size_t out_len = 0;
+  if (!EVP_DigestSign(ctx.get(), nullptr, &out_len, operation.input_.data(),
+                      operation.input_.size())) {
+    return false;
+  }
+  operation.output_.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), operation.output_.data(), &out_len, operation.input_.data(),
+                      operation.input_.size())) {
+    return false;
+  }
+  operation.output_.resize(out_len);
+  return true;
+}
+
+bool SoftwarePrivateKeyBatchProcessor::decrypt(PrivateKeyOperation& operation) {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+  if (rsa == nullptr) {
+    return false;
+  }
+
+  size_t out_len = 0;
+  operation.output_.resize(RSA_size(rsa));
+  if (!RSA_decrypt(rsa, &out_len, operation.output_.data(), operation.output_.size(),
+                   operation.input_.data(), operation.input_.size(), RSA_NO_PADDING)) {
+    return false;
+  }
+  operation.output_.resize(out_len);
+  return true;
+}
+
+bool SoftwarePrivateKeyBatchProcessor::checkFips() {
+  if (EVP_PKEY_id(pkey_.get()) == EVP_PKEY_RSA) {
+    RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+    return rsa != nullptr && RSA_check_fips(rsa);
+  }
+  const EC_KEY* ec_key = EVP_PKEY_get0_EC_KEY(pkey_.get());
+  return ec_key != nullptr && EC_KEY_check_fips(ec_key);
+}
+
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
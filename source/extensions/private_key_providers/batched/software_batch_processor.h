@@ -0,0 +1,34 @@
+#pragma once
+
+#include "source/common/tls/private_key/batched_private_key_provider.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+
+/**
+ * Performs the operations of a batch one after another with BoringSSL, for RSA and ECDSA keys.
+ */
+class SoftwarePrivateKeyBatchProcessor : public TransportSockets::Tls::PrivateKeyBatchProcessor {
+public:
+  explicit SoftwarePrivateKeyBatchProcessor(bssl::UniquePtr<EVP_PKEY> pkey);
+
+  // TransportSockets::Tls::PrivateKeyBatchProcessor
+  void process(const TransportSockets::Tls::PrivateKeyOperationBatch& batch) override;
+  bool checkFips() override;
+  int keyType() const override { return EVP_PKEY_id(pkey_.get()); }
+
+private:
+  bool sign(TransportSockets::Tls::PrivateKeyOperation& operation);
+  bool decrypt(TransportSockets::Tls::PrivateKeyOperation& operation);
+
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+};
+
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -1,10 +1,27 @@
 #include "source/extensions/udp_packet_writer/gso/config.h"
 
+#include "source/common/protobuf/utility.h"
+
 namespace Envoy {
 namespace Quic {
 
 #if UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
 
+Network::UdpPacketWriterFactoryPtr UdpGsoBatchWriterFactoryFactory::createUdpPacketWriterFactory(
+    const envoy::config::core::v3::TypedExtensionConfig& config) {
+#ifdef ENVOY_ENABLE_QUIC
+  const auto writer_config = MessageUtil::anyConvert<
+      envoy::extensions::udp_packet_writer::v3::UdpGsoBatchWriterFactory>(config.typed_config());
+  if (writer_config.batch_across_connections()) {
+    return std::make_unique<UdpGsoMmsgBatchWriterFactory>();
+  }
+  return std::make_unique<UdpGsoBatchWriterFactory>();
+#else
+  UNREFERENCED_PARAMETER(config);
+  return {};
+#endif
+}
+
 REGISTER_FACTORY(UdpGsoBatchWriterFactoryFactory, Network::UdpPacketWriterFactoryFactory);
 
 #endif
@@ -6,6 +6,7 @@
 
 #ifdef ENVOY_ENABLE_QUIC
 #include "source/common/quic/udp_gso_batch_writer.h"
+#include "source/common/quic/udp_gso_mmsg_batch_writer.h"
 #endif
 
 #if UDP_GSO_BATCH_WRITER_COMPILETIME_SUPPORT
@@ -16,14 +17,8 @@ namespace Quic {
 class UdpGsoBatchWriterFactoryFactory : public Network::UdpPacketWriterFactoryFactory {
 public:
   std::string name() const override { return "envoy.udp_packet_writer.gso"; }
-  Network::UdpPacketWriterFactoryPtr
-  createUdpPacketWriterFactory(const envoy::config::core::v3::TypedExtensionConfig&) override {
-#ifdef ENVOY_ENABLE_QUIC
-    return std::make_unique<UdpGsoBatchWriterFactory>();
-#else
-    return {};
-#endif
-  }
+  Network::UdpPacketWriterFactoryPtr createUdpPacketWriterFactory(
+      const envoy::config::core::v3::TypedExtensionConfig& config) override;
   ProtobufTypes::MessagePtr createEmptyConfigProto() override {
     return std::make_unique<envoy::extensions::udp_packet_writer::v3::UdpGsoBatchWriterFactory>();
   }
@@ -77,7 +77,8 @@ ActiveRawUdpListener::ActiveRawUdpListener(uint32_t worker_index, uint32_t concu
     : ActiveRawUdpListener(worker_index, concurrency, parent, listen_socket,
                            std::make_unique<Network::UdpListenerImpl>(
                                dispatcher, listen_socket_ptr, *this, dispatcher.timeSource(),
-                               config.udpListenerConfig()->config().downstream_socket_config()),
+                               config.udpListenerConfig()->config().downstream_socket_config(),
+                               /*prefer_gro_default=*/false),
                            config) {}
 
 ActiveRawUdpListener::ActiveRawUdpListener(uint32_t worker_index, uint32_t concurrency,
@@ -98,7 +99,7 @@ ActiveRawUdpListener::ActiveRawUdpListener(uint32_t worker_index, uint32_t concu
 
   // Create udp_packet_writer
   udp_packet_writer_ = config_->udpListenerConfig()->packetWriterFactory().createUdpPacketWriter(
-      listen_socket_.ioHandle(), config.listenerScope());
+      listen_socket_.ioHandle(), config.listenerScope(), udp_listener_->dispatcher());
 }
 
 void ActiveRawUdpListener::onDataWorker(Network::UdpRecvData&& data) {
@@ -134,6 +134,15 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<uint64_t> file_write_buffer_limit_bytes(
+      "", "file-write-buffer-limit-bytes",
+      "Bytes an access log file may buffer before the overflow policy applies, 0 for no limit",
+      false, 0, "uint64_t", cmd);
+  TCLAP::ValueArg<std::string> file_write_overflow_policy(
+      "", "file-write-overflow-policy",
+      "What to do with access log writes over the buffer limit, one of 'count' (default), "
+      "'drop' or 'block'.",
+      false, "count", "string", cmd);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s",
                                          "Hot restart and LDS removal drain time in seconds", false,
                                          600, "uint32_t", cmd);
@@ -285,6 +294,17 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
   file_flush_interval_msec_ = std::chrono::milliseconds(file_flush_interval_msec.getValue());
+  file_write_buffer_limit_bytes_ = file_write_buffer_limit_bytes.getValue();
+  if (file_write_overflow_policy.getValue() == "count") {
+    file_write_overflow_policy_ = AccessLog::FileOverflowPolicy::Count;
+  } else if (file_write_overflow_policy.getValue() == "drop") {
+    file_write_overflow_policy_ = AccessLog::FileOverflowPolicy::Drop;
+  } else if (file_write_overflow_policy.getValue() == "block") {
+    file_write_overflow_policy_ = AccessLog::FileOverflowPolicy::Block;
+  } else {
+    throw MalformedArgvException(fmt::format("error: unknown file write overflow policy '{}'",
+                                             file_write_overflow_policy.getValue()));
+  }
   drain_time_ = std::chrono::seconds(drain_time_s.getValue());
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   socket_path_ = socket_path.getValue();
@@ -425,6 +445,18 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   }
   command_line_options->mutable_file_flush_interval()->MergeFrom(
       Protobuf::util::TimeUtil::MillisecondsToDuration(fileFlushIntervalMsec().count()));
+  command_line_options->set_file_write_buffer_limit_bytes(fileWriteBufferLimitBytes());
+  switch (fileWriteOverflowPolicy()) {
+  case AccessLog::FileOverflowPolicy::Count:
+    command_line_options->set_file_write_overflow_policy("count");
+    break;
+  case AccessLog::FileOverflowPolicy::Drop:
+    command_line_options->set_file_write_overflow_policy("drop");
+    break;
+  case AccessLog::FileOverflowPolicy::Block:
+    command_line_options->set_file_write_overflow_policy("block");
+    break;
+  }
 
   command_line_options->mutable_drain_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(drainTime().count()));
@@ -67,6 +67,12 @@ public:
   void setFileFlushIntervalMsec(std::chrono::milliseconds file_flush_interval_msec) {
     file_flush_interval_msec_ = file_flush_interval_msec;
   }
+  void setFileWriteBufferLimitBytes(uint64_t file_write_buffer_limit_bytes) {
+    file_write_buffer_limit_bytes_ = file_write_buffer_limit_bytes;
+  }
+  void setFileWriteOverflowPolicy(AccessLog::FileOverflowPolicy file_write_overflow_policy) {
+    file_write_overflow_policy_ = file_write_overflow_policy;
+  }
   void setServiceClusterName(const std::string& service_cluster) {
     service_cluster_ = service_cluster;
   }
@@ -133,6 +139,10 @@ public:
   std::chrono::milliseconds fileFlushIntervalMsec() const override {
     return file_flush_interval_msec_;
   }
+  uint64_t fileWriteBufferLimitBytes() const override { return file_write_buffer_limit_bytes_; }
+  AccessLog::FileOverflowPolicy fileWriteOverflowPolicy() const override {
+    return file_write_overflow_policy_;
+  }
   const std::string& serviceClusterName() const override { return service_cluster_; }
   const std::string& serviceNodeName() const override { return service_node_; }
   const std::string& serviceZone() const override { return service_zone_; }
@@ -196,6 +206,8 @@ private:
   std::string service_node_;
   std::string service_zone_;
   std::chrono::milliseconds file_flush_interval_msec_{10000};
+  uint64_t file_write_buffer_limit_bytes_{0};
+  AccessLog::FileOverflowPolicy file_write_overflow_policy_{AccessLog::FileOverflowPolicy::Count};
   std::chrono::seconds drain_time_{600};
   std::chrono::seconds parent_shutdown_time_{900};
   Server::DrainStrategy drain_strategy_{Server::DrainStrategy::Gradual};
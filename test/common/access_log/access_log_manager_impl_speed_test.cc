@@ -0,0 +1,69 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "source/common/access_log/access_log_manager_impl.h"
+#include "source/common/common/thread.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace AccessLog {
+namespace {
+
+// Measures the throughput of many threads writing access log lines to the same file, with the
+// number of writer threads given by the first argument.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ConcurrentWrites(::benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  const uint64_t writes_per_thread = benchmark::skipExpensiveBenchmarks() ? 100 : 100000;
+  const std::string line = std::string(200, 'a') + "\n";
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  Thread::MutexBasicLockable lock;
+  Stats::IsolatedStoreImpl store;
+  AccessLogManagerImpl access_log_manager(std::chrono::milliseconds(1000), 0,
+                                          FileOverflowPolicy::Count, *api, *dispatcher, lock,
+                                          store);
+  AccessLogFileSharedPtr log_file =
+      access_log_manager
+          .createAccessLog(Filesystem::FilePathAndType{
+              Filesystem::DestinationType::File,
+              TestEnvironment::temporaryPath("access_log_manager_impl_speed_test.log")})
+          .value();
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t i = 0; i < num_threads; i++) {
+      threads.push_back(api->threadFactory().createThread([&]() {
+        for (uint64_t j = 0; j < writes_per_thread; j++) {
+          log_file->write(line);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+    log_file->flush();
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * writes_per_thread);
+  state.SetBytesProcessed(state.iterations() * num_threads * writes_per_thread * line.size());
+}
+BENCHMARK(BM_ConcurrentWrites)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace AccessLog
+} // namespace Envoy
@@ -1,4 +1,6 @@
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "source/common/access_log/access_log_manager_impl.h"
 #include "source/common/filesystem/file_shared_impl.h"
@@ -11,6 +13,9 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -31,7 +36,8 @@ class AccessLogManagerImplTest : public testing::Test {
 protected:
   AccessLogManagerImplTest()
       : file_(new NiceMock<Filesystem::MockFile>), thread_factory_(Thread::threadFactoryForTest()),
-        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_) {
+        access_log_manager_(timeout_40ms_, 0, FileOverflowPolicy::Count, api_, dispatcher_, lock_,
+                            store_) {
     EXPECT_CALL(file_system_,
                 createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
                     Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})))
@@ -55,6 +61,41 @@ protected:
     return TestUtility::waitForGaugeEq(store_, name, value, time_system_);
   }
 
+  // Creates a file with a write buffer limit of 4 bytes, parks its flush thread inside the write of
+  // "aaaa" and then buffers "bbbb", so that the next write finds the limit reached. The flush
+  // thread continues once release_flush_ is notified.
+  AccessLogFileSharedPtr createFileAtWriteBufferLimit(FileOverflowPolicy policy) {
+    limited_manager_ = std::make_unique<AccessLogManagerImpl>(timeout_40ms_, 4, policy, api_,
+                                                              dispatcher_, lock_, store_);
+    EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+    AccessLogFileSharedPtr log_file =
+        limited_manager_
+            ->createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+            .value();
+
+    EXPECT_CALL(*file_, write_(_))
+        .WillRepeatedly(Invoke([this](absl::string_view data) -> Api::IoCallSizeResult {
+          if (!flush_entered_.HasBeenNotified()) {
+            flush_entered_.Notify();
+            release_flush_.WaitForNotification();
+          }
+          absl::MutexLock lock(&written_mutex_);
+          absl::StrAppend(&written_, data);
+          return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+        }));
+
+    log_file->write("aaaa");
+    flush_entered_.WaitForNotification();
+    log_file->write("bbbb");
+    EXPECT_EQ(0UL, store_.counter("filesystem.write_buffer_overflow").value());
+    return log_file;
+  }
+
+  std::string written() {
+    absl::MutexLock lock(&written_mutex_);
+    return written_;
+  }
+
   NiceMock<Api::MockApi> api_;
   NiceMock<Filesystem::MockInstance> file_system_;
   NiceMock<Filesystem::MockFile>* file_;
@@ -65,6 +106,11 @@ protected:
   Thread::MutexBasicLockable lock_;
   AccessLogManagerImpl access_log_manager_;
   Event::TestRealTimeSystem time_system_;
+  absl::Notification flush_entered_;
+  absl::Notification release_flush_;
+  absl::Mutex written_mutex_;
+  std::string written_ ABSL_GUARDED_BY(written_mutex_);
+  std::unique_ptr<AccessLogManagerImpl> limited_manager_;
 };
 
 TEST_F(AccessLogManagerImplTest, BadFile) {
@@ -442,6 +488,119 @@ TEST_F(AccessLogManagerImplTest, BigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+TEST_F(AccessLogManagerImplTest, ConcurrentWritesAreAllFlushed) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file =
+      access_log_manager_
+          .createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})
+          .value();
+
+  absl::Mutex mutex;
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        absl::MutexLock lock(&mutex);
+        absl::StrAppend(&written, data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  constexpr uint32_t num_threads = 8;
+  constexpr uint32_t writes_per_thread = 100;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.push_back(thread_factory_.createThread([&log_file, i]() {
+      for (uint32_t j = 0; j < writes_per_thread; j++) {
+        log_file->write(absl::StrCat(i, ":", j, "\n"));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
+  EXPECT_EQ(num_threads * writes_per_thread, store_.counter("filesystem.write_buffered").value());
+
+  // Every line is written exactly once, and the lines of each thread are in order.
+  absl::MutexLock lock(&mutex);
+  std::vector<uint32_t> next_line(num_threads, 0);
+  for (absl::string_view line : absl::StrSplit(written, '\n', absl::SkipEmpty())) {
+    std::vector<absl::string_view> parts = absl::StrSplit(line, ':');
+    ASSERT_EQ(2, parts.size());
+    uint32_t thread_index;
+    uint32_t line_index;
+    ASSERT_TRUE(absl::SimpleAtoi(parts[0], &thread_index));
+    ASSERT_TRUE(absl::SimpleAtoi(parts[1], &line_index));
+    ASSERT_LT(thread_index, num_threads);
+    EXPECT_EQ(next_line[thread_index]++, line_index);
+  }
+  for (uint32_t i = 0; i < num_threads; i++) {
+    EXPECT_EQ(writes_per_thread, next_line[i]);
+  }
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, WriteBufferOverflowIsCounted) {
+  AccessLogFileSharedPtr log_file = createFileAtWriteBufferLimit(FileOverflowPolicy::Count);
+
+  log_file->write("cccc");
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_buffer_overflow").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(3UL, store_.counter("filesystem.write_buffered").value());
+
+  release_flush_.Notify();
+  log_file->flush();
+  EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
+  EXPECT_EQ("aaaabbbbcccc", written());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, WriteBufferOverflowIsDropped) {
+  AccessLogFileSharedPtr log_file = createFileAtWriteBufferLimit(FileOverflowPolicy::Drop);
+
+  log_file->write("cccc");
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_buffer_overflow").value());
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
+
+  release_flush_.Notify();
+  log_file->flush();
+  EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
+  EXPECT_EQ("aaaabbbb", written());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, WriteBufferOverflowBlocksUntilFlushed) {
+  AccessLogFileSharedPtr log_file = createFileAtWriteBufferLimit(FileOverflowPolicy::Block);
+
+  std::atomic<bool> write_done{false};
+  Thread::ThreadPtr writer = thread_factory_.createThread([&log_file, &write_done]() {
+    log_file->write("cccc");
+    write_done = true;
+  });
+
+  // The writer cannot get past the limit while the flush thread is held inside the file write.
+  EXPECT_TRUE(waitForCounterEq("filesystem.write_buffer_overflow", 1));
+  EXPECT_FALSE(write_done);
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
+
+  release_flush_.Notify();
+  writer->join();
+  EXPECT_TRUE(write_done);
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(3UL, store_.counter("filesystem.write_buffered").value());
+
+  log_file->flush();
+  EXPECT_TRUE(waitForGaugeEq("filesystem.write_total_buffered", 0));
+  EXPECT_EQ("aaaabbbbcccc", written());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
@@ -0,0 +1,86 @@
+#include <memory>
+#include <string>
+
+#include "source/common/common/sharded_lru_cache.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+using Cache = ShardedLruCache<std::string, int>;
+
+bool contains(Cache& cache, absl::string_view key) {
+  return cache.lookup(key, [](int&) { return true; });
+}
+
+TEST(ShardedLruCacheTest, InsertAndLookup) {
+  Cache cache(10);
+  cache.insert(absl::string_view("a"), 1);
+  cache.insert(std::string("b"), 2);
+  cache.insert(absl::string_view("a"), 3);
+  EXPECT_EQ(2U, cache.size());
+
+  int value = 0;
+  EXPECT_TRUE(cache.lookup(absl::string_view("a"), [&value](int& v) {
+    value = v;
+    return true;
+  }));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(contains(cache, "c"));
+}
+
+// An entry is removed when the lookup rejects it.
+TEST(ShardedLruCacheTest, LookupRemovesRejectedEntry) {
+  Cache cache(10);
+  cache.insert(absl::string_view("a"), 1);
+  EXPECT_FALSE(cache.lookup(absl::string_view("a"), [](int&) { return false; }));
+  EXPECT_EQ(0U, cache.size());
+  EXPECT_FALSE(contains(cache, "a"));
+}
+
+TEST(ShardedLruCacheTest, GetOrCreate) {
+  ShardedLruCache<std::string, std::shared_ptr<int>> cache(10);
+  int created = 0;
+  const auto create = [&created]() { return std::make_shared<int>(++created); };
+  std::shared_ptr<int> a = cache.getOrCreate("a", create);
+  EXPECT_EQ(a, cache.getOrCreate("a", create));
+  EXPECT_NE(a, cache.getOrCreate("b", create));
+  EXPECT_EQ(2, created);
+  EXPECT_EQ(2U, cache.size());
+}
+
+// Up to max_entries keys are kept, whichever shards they fall in.
+TEST(ShardedLruCacheTest, KeysWithinBoundAreNeverEvicted) {
+  for (size_t max_entries : {1U, 2U, 5U, 20U, 100U}) {
+    Cache cache(max_entries);
+    for (size_t round = 0; round < 3; round++) {
+      for (size_t i = 0; i < max_entries; i++) {
+        cache.insert(absl::StrCat("key", i), static_cast<int>(i));
+      }
+    }
+    EXPECT_EQ(max_entries, cache.size());
+    for (size_t i = 0; i < max_entries; i++) {
+      EXPECT_TRUE(contains(cache, absl::StrCat("key", i))) << max_entries << " " << i;
+    }
+  }
+}
+
+// The bound applies to the whole cache rather than to each shard.
+TEST(ShardedLruCacheTest, BoundIsGlobal) {
+  for (size_t max_entries : {1U, 2U, 20U}) {
+    Cache cache(max_entries);
+    for (size_t i = 0; i < 1000; i++) {
+      cache.insert(absl::StrCat("key", i), static_cast<int>(i));
+      EXPECT_LE(cache.size(), max_entries);
+      // The entry just inserted is kept.
+      EXPECT_TRUE(contains(cache, absl::StrCat("key", i)));
+    }
+    EXPECT_EQ(max_entries, cache.size());
+  }
+}
+
+} // namespace
+} // namespace Envoy
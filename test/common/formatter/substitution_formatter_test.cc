@@ -4545,6 +4545,37 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterAppendTest) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"key_1", "value_1"},
+                                                {"key_2", R"(value_with_quotes_"_)"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  HttpFormatterContext formatter_context(&request_header, &response_header, &response_trailer,
+                                         body);
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_key: '%REQ(key_1)%_%REQ(key_2)%'
+    missing_key: '%REQ(error)%_suffix'
+  )EOF",
+                            key_mapping);
+
+  const std::string expected =
+      R"({"missing_key":"-_suffix","request_key":"value_1_value_with_quotes_\"_"})"
+      "\n";
+
+  JsonFormatterImpl formatter(key_mapping, false);
+  EXPECT_EQ(expected, formatter.formatWithContext(formatter_context, stream_info));
+
+  // Appending writes the same line after any existing content.
+  std::string output = "prefix";
+  formatter.appendWithContext(formatter_context, stream_info, output);
+  EXPECT_EQ("prefix" + expected, output);
+}
+
 TEST(SubstitutionFormatterTest, LegacyJsonFormatterTest) {
   NiceMock<StreamInfo::MockStreamInfo> stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"key_1", "value_1"},
@@ -4915,6 +4946,42 @@ TEST(SubstitutionFormatterTest, CompositeFormatterEmpty) {
   }
 }
 
+TEST(SubstitutionFormatterTest, CompositeFormatterAppend) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {"second", "/some/path"}};
+  Http::TestResponseHeaderMapImpl response_header{};
+  Http::TestResponseTrailerMapImpl response_trailer{};
+  std::string body;
+
+  HttpFormatterContext formatter_context(&request_header, &response_header, &response_trailer,
+                                         body);
+  stream_info.bytes_sent_ = 42;
+
+  const std::string format = "%DOWNSTREAM_REMOTE_ADDRESS%|%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT%|"
+                             "%REQ(FIRST)%|%REQ(SECOND):5%|%REQ(NOT_EXIST)%|%BYTES_SENT%";
+  const std::string expected = "127.0.0.1:0|127.0.0.1|GET|/some|-|42";
+
+  {
+    FormatterPtr formatter = *FormatterImpl::create(format, false);
+    EXPECT_EQ(expected, formatter->formatWithContext(formatter_context, stream_info));
+
+    // The same buffer can be reused across lines.
+    std::string output = "prefix ";
+    formatter->appendWithContext(formatter_context, stream_info, output);
+    EXPECT_EQ("prefix " + expected, output);
+    output.clear();
+    formatter->appendWithContext(formatter_context, stream_info, output);
+    EXPECT_EQ(expected, output);
+  }
+
+  {
+    FormatterPtr formatter = *FormatterImpl::create(format, true);
+    std::string output;
+    formatter->appendWithContext(formatter_context, stream_info, output);
+    EXPECT_EQ("127.0.0.1:0|127.0.0.1|GET|/some||42", output);
+  }
+}
+
 TEST(SubstitutionFormatterTest, ParserFailures) {
   SubstitutionFormatParser parser;
 
@@ -0,0 +1,120 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+
+#include "envoy/config/core/v3/grpc_service.pb.h"
+#include "envoy/service/auth/v3/external_auth.pb.h"
+
+#include "source/common/grpc/async_client_impl.h"
+#include "source/common/grpc/common.h"
+#include "source/common/protobuf/protobuf.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/test_time.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+namespace Envoy {
+namespace Grpc {
+namespace {
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+constexpr uint32_t NumHeaders = 32;
+
+// Fills in a check request typical of an authorization call made for a browser request.
+void buildCheckRequest(envoy::service::auth::v3::CheckRequest& check_request) {
+  auto* http = check_request.mutable_attributes()->mutable_request()->mutable_http();
+  http->set_method("GET");
+  http->set_path("/some/path/to/a/resource?with=query");
+  http->set_host("www.example.com");
+  http->set_scheme("https");
+  http->set_protocol("HTTP/2");
+  auto& headers = *http->mutable_headers();
+  for (uint32_t i = 0; i < NumHeaders; i++) {
+    headers[absl::StrCat("x-header-", i)] = absl::StrCat("some-fairly-typical-value-", i);
+  }
+  auto* source = check_request.mutable_attributes()->mutable_source();
+  source->mutable_address()->mutable_socket_address()->set_address("10.0.0.1");
+  source->mutable_address()->mutable_socket_address()->set_port_value(54321);
+  auto& context_extensions = *check_request.mutable_attributes()->mutable_context_extensions();
+  context_extensions["virtual_host"] = "example";
+}
+
+// Measures building a check request and serializing it into a gRPC frame, with the request
+// allocated on the heap or on an arena as given by the first argument (0 for the heap, 1 for an
+// arena).
+void bmBuildAndSerializeCheckRequest(::benchmark::State& state) {
+  const bool use_arena = state.range(0) == 1;
+
+  uint64_t bytes = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Protobuf::Arena arena;
+    std::unique_ptr<envoy::service::auth::v3::CheckRequest> heap_request;
+    envoy::service::auth::v3::CheckRequest* check_request;
+    if (use_arena) {
+      check_request = Protobuf::Arena::Create<envoy::service::auth::v3::CheckRequest>(&arena);
+    } else {
+      heap_request = std::make_unique<envoy::service::auth::v3::CheckRequest>();
+      check_request = heap_request.get();
+    }
+    buildCheckRequest(*check_request);
+    bytes += Common::serializeToGrpcFrame(*check_request)->length();
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(bmBuildAndSerializeCheckRequest)->Arg(0)->Arg(1);
+
+// Measures sending check requests on a stream of the Envoy gRPC client, with the number of
+// messages sent per stream given by the first argument. The upstream HTTP stream is a mock that
+// drops the data.
+void bmSendMessage(::benchmark::State& state) {
+  const uint64_t messages_per_stream = state.range(0);
+
+  envoy::config::core::v3::GrpcService config;
+  config.mutable_envoy_grpc()->set_cluster_name("test_cluster");
+  NiceMock<Upstream::MockClusterManager> cm;
+  NiceMock<Http::MockAsyncClient> http_client;
+  DangerousDeprecatedTestTime test_time;
+  cm.initializeThreadLocalClusters({"test_cluster"});
+  ON_CALL(cm.thread_local_cluster_, httpAsyncClient()).WillByDefault(ReturnRef(http_client));
+  AsyncClient<envoy::service::auth::v3::CheckRequest, envoy::service::auth::v3::CheckResponse>
+      grpc_client(std::make_unique<AsyncClientImpl>(cm, config, test_time.timeSystem()));
+
+  NiceMock<Http::MockAsyncClientStream> http_stream;
+  ON_CALL(http_client, start(_, _)).WillByDefault(Return(&http_stream));
+  NiceMock<MockAsyncStreamCallbacks<envoy::service::auth::v3::CheckResponse>> grpc_callbacks;
+  const auto& method = *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+      "envoy.service.auth.v3.Authorization.Check");
+
+  envoy::service::auth::v3::CheckRequest check_request;
+  buildCheckRequest(check_request);
+
+  uint64_t messages = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    auto grpc_stream =
+        grpc_client->start(method, grpc_callbacks, Http::AsyncClient::StreamOptions());
+    for (uint64_t i = 0; i < messages_per_stream; i++) {
+      grpc_stream->sendMessage(check_request, i + 1 == messages_per_stream);
+    }
+    grpc_stream->resetStream();
+    http_client.dispatcher_.clearDeferredDeleteList();
+    messages += messages_per_stream;
+  }
+  state.SetItemsProcessed(messages);
+  state.SetBytesProcessed(messages * check_request.ByteSizeLong());
+}
+BENCHMARK(bmSendMessage)->Arg(1)->Arg(100);
+
+} // namespace
+} // namespace Grpc
+} // namespace Envoy
@@ -0,0 +1,107 @@
+// Usage: bazel run //test/common/http/http1:codec_impl_benchmark
+
+#include <memory>
+#include <string>
+
+#include "envoy/config/core/v3/protocol.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/http1/codec_impl.h"
+#include "source/common/memory/stats.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/overload_manager.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+constexpr absl::string_view Request = "GET /some/path/to/a/resource?with=query HTTP/1.1\r\n"
+                                      "Host: www.example.com\r\n"
+                                      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) "
+                                      "AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 "
+                                      "Safari/537.36\r\n"
+                                      "Accept: text/html,application/xhtml+xml,application/xml;"
+                                      "q=0.9,*/*;q=0.8\r\n"
+                                      "Accept-Encoding: gzip, deflate, br\r\n"
+                                      "Accept-Language: en-US,en;q=0.5\r\n"
+                                      "Cookie: session=0123456789abcdef0123456789abcdef\r\n"
+                                      "X-Request-Id: 2f1c8a4e-6d3b-4f8e-9a7c-5b2d1e0f3a6c\r\n"
+                                      "\r\n";
+
+// Measures decoding of a typical browser request, with the parser given by the first argument (0
+// for http-parser, 1 for Balsa) and the size of the slices the request is split into by the
+// second. Each request is responded to from within the decoder callback so that the connection is
+// ready for the next one. Also reports the bytes allocated per request for the decoded headers.
+void bmDecodeRequest(::benchmark::State& state) {
+  Http1Settings settings;
+  settings.use_balsa_parser_ = state.range(0) == 1;
+  const uint64_t slice_size = state.range(1);
+
+  Stats::IsolatedStoreImpl stats_store;
+  CodecStats::AtomicPtr stats;
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<MockServerConnectionCallbacks> callbacks;
+  NiceMock<MockRequestDecoder> decoder;
+  NiceMock<Server::MockOverloadManager> overload_manager;
+  ResponseEncoder* encoder = nullptr;
+  uint64_t start_mem = 0;
+  uint64_t header_bytes = 0;
+
+  ON_CALL(connection, write(_, _))
+      .WillByDefault(Invoke([](Buffer::Instance& data, bool) { data.drain(data.length()); }));
+  ON_CALL(callbacks, newStream(_, _))
+      .WillByDefault(Invoke([&](ResponseEncoder& response_encoder, bool) -> RequestDecoder& {
+        encoder = &response_encoder;
+        return decoder;
+      }));
+  ON_CALL(decoder, decodeHeaders_(_, _))
+      .WillByDefault(Invoke([&](RequestHeaderMapSharedPtr&, bool) {
+        header_bytes += Memory::Stats::totalCurrentlyAllocated() - start_mem;
+        TestResponseHeaderMapImpl headers{{":status", "200"}};
+        encoder->encodeHeaders(headers, true);
+      }));
+
+  ServerConnectionImpl codec(connection, CodecStats::atomicGet(stats, *stats_store.rootScope()),
+                             callbacks, settings, Http::DEFAULT_MAX_REQUEST_HEADERS_KB,
+                             Http::DEFAULT_MAX_HEADERS_COUNT,
+                             envoy::config::core::v3::HttpProtocolOptions::ALLOW,
+                             overload_manager);
+
+  uint64_t requests = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    Buffer::OwnedImpl buffer;
+    for (size_t offset = 0; offset < Request.size(); offset += slice_size) {
+      buffer.appendSliceForTest(Request.substr(offset, slice_size));
+    }
+    start_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.ResumeTiming();
+
+    RELEASE_ASSERT(codec.dispatch(buffer).ok(), "");
+
+    state.PauseTiming();
+    connection.dispatcher_.clearDeferredDeleteList();
+    ++requests;
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(requests);
+  state.counters["header_bytes_per_request"] = static_cast<double>(header_bytes) / requests;
+}
+BENCHMARK(bmDecodeRequest)->ArgsProduct({{0, 1}, {16, 4096}});
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
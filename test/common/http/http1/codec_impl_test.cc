@@ -1668,6 +1668,31 @@ TEST_P(Http1ServerConnectionImplTest, PostWithContentLengthFragmentedBuffer) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+// Verify that header names and values are decoded correctly when they are split across slices at
+// every possible offset, including values with surrounding whitespace.
+TEST_P(Http1ServerConnectionImplTest, HeadersSplitAcrossSlices) {
+  const std::string request = "GET / HTTP/1.1\r\nHost: example.com\r\nX-Long-Name:  a value  \r\n"
+                              "Accept: */*\r\n\r\n";
+  MockRequestDecoder decoder;
+  for (size_t slice_size = 1; slice_size <= request.size(); slice_size++) {
+    initialize();
+    EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+
+    TestRequestHeaderMapImpl expected_headers{{":path", "/"},
+                                              {":method", "GET"},
+                                              {"host", "example.com"},
+                                              {"x-long-name", "a value"},
+                                              {"accept", "*/*"}};
+    EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers), true));
+
+    Buffer::OwnedImpl buffer = createBufferWithNByteSlices(request, slice_size);
+    auto status = codec_->dispatch(buffer);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(0U, buffer.length());
+    testing::Mock::VerifyAndClearExpectations(&decoder);
+  }
+}
+
 TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponse) {
   initialize();
 
@@ -0,0 +1,222 @@
+// Usage: bazel run //test/common/http/http2:codec_impl_benchmark
+
+#include <memory>
+#include <vector>
+
+#include "envoy/config/core/v3/protocol.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/http2/codec_impl.h"
+#include "source/common/http/utility.h"
+#include "source/common/memory/stats.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/http/http2/codec_impl_test_util.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+/**
+ * A client and server HTTP/2 codec connected back to back through in-memory buffers. The mocks
+ * are created up front so that connect() only allocates codec state, which allows measuring the
+ * memory held by the codecs themselves.
+ */
+class CodecPair {
+public:
+  CodecPair() {
+    ON_CALL(client_connection_, write(_, _))
+        .WillByDefault(
+            Invoke([this](Buffer::Instance& data, bool) -> void { server_input_.move(data); }));
+    ON_CALL(server_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) -> void {
+          ++server_writes_;
+          client_input_.move(data);
+        }));
+    ON_CALL(server_connection_, bufferLimit()).WillByDefault(Return(16 * 1024));
+    ON_CALL(server_callbacks_, newStream(_, _))
+        .WillByDefault(Invoke([this](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoders_.push_back(&encoder);
+          return request_decoder_;
+        }));
+  }
+
+  void connect(const envoy::config::core::v3::Http2ProtocolOptions& http2_options) {
+    client_ = std::make_unique<TestClientConnectionImpl>(
+        client_connection_, client_callbacks_, *client_stats_store_.rootScope(), http2_options,
+        random_, DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT,
+        ProdNghttp2SessionFactory::get());
+    server_ = std::make_unique<TestServerConnectionImpl>(
+        server_connection_, server_callbacks_, *server_stats_store_.rootScope(), http2_options,
+        random_, DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+    // Exchange the connection prefaces and SETTINGS.
+    driveToCompletion();
+  }
+
+  // Responds to every request from within the request decoder callback, i.e. while the server
+  // codec is dispatching, with a 200 and a body of body_size bytes.
+  void respondInline(uint64_t body_size) {
+    ON_CALL(request_decoder_, decodeHeaders_(_, _))
+        .WillByDefault(Invoke([this, body_size](RequestHeaderMapSharedPtr&, bool) {
+          ResponseEncoder& encoder = *response_encoders_.back();
+          TestResponseHeaderMapImpl headers{{":status", "200"}};
+          encoder.encodeHeaders(headers, false);
+          Buffer::OwnedImpl body(std::string(body_size, 'a'));
+          encoder.encodeData(body, true);
+        }));
+  }
+
+  // Sends num_requests header only requests in one batch and waits for their responses.
+  void sendRequests(uint64_t num_requests) {
+    TestRequestHeaderMapImpl headers{
+        {":method", "GET"}, {":path", "/"}, {":scheme", "https"}, {":authority", "host"}};
+    for (uint64_t i = 0; i < num_requests; i++) {
+      RequestEncoder& encoder = client_->newStream(response_decoder_);
+      RELEASE_ASSERT(encoder.encodeHeaders(headers, true).ok(), "");
+    }
+    driveToCompletion();
+    response_encoders_.clear();
+    client_connection_.dispatcher_.clearDeferredDeleteList();
+    server_connection_.dispatcher_.clearDeferredDeleteList();
+  }
+
+  // Sends a request without end stream, leaving an idle stream open on both sides.
+  void openIdleStream() {
+    RequestEncoder& encoder = client_->newStream(response_decoder_);
+    TestRequestHeaderMapImpl headers{
+        {":method", "GET"}, {":path", "/"}, {":scheme", "https"}, {":authority", "host"}};
+    RELEASE_ASSERT(encoder.encodeHeaders(headers, false).ok(), "");
+    driveToCompletion();
+  }
+
+  void driveToCompletion() {
+    while (server_input_.length() > 0 || client_input_.length() > 0 ||
+           server_->wantsToWrite() || client_->wantsToWrite()) {
+      if (server_input_.length() > 0 || server_->wantsToWrite()) {
+        RELEASE_ASSERT(server_->dispatch(server_input_).ok(), "");
+      }
+      if (client_input_.length() > 0 || client_->wantsToWrite()) {
+        RELEASE_ASSERT(client_->dispatch(client_input_).ok(), "");
+      }
+    }
+  }
+
+  Stats::IsolatedStoreImpl client_stats_store_;
+  Stats::IsolatedStoreImpl server_stats_store_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<Network::MockConnection> server_connection_;
+  NiceMock<MockConnectionCallbacks> client_callbacks_;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks_;
+  NiceMock<MockResponseDecoder> response_decoder_;
+  NiceMock<MockRequestDecoder> request_decoder_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  Buffer::OwnedImpl client_input_;
+  Buffer::OwnedImpl server_input_;
+  std::vector<ResponseEncoder*> response_encoders_;
+  uint64_t server_writes_{};
+  std::unique_ptr<TestClientConnectionImpl> client_;
+  std::unique_ptr<TestServerConnectionImpl> server_;
+};
+
+envoy::config::core::v3::Http2ProtocolOptions http2Options(uint32_t hpack_table_size) {
+  envoy::config::core::v3::Http2ProtocolOptions options;
+  options.mutable_hpack_table_size()->set_value(hpack_table_size);
+  return ::Envoy::Http2::Utility::initializeAndValidateOptions(options).value();
+}
+
+// Measures the memory held by idle client and server codec pairs, with the HPACK table size given
+// by the first argument.
+void bmIdleConnectionMemory(::benchmark::State& state) {
+  const uint32_t hpack_table_size = state.range(0);
+  const uint64_t num_connections = benchmark::skipExpensiveBenchmarks() ? 10 : 1000;
+  const auto options = http2Options(hpack_table_size);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    std::vector<std::unique_ptr<CodecPair>> pairs;
+    for (uint64_t i = 0; i < num_connections; i++) {
+      pairs.push_back(std::make_unique<CodecPair>());
+    }
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.ResumeTiming();
+
+    for (auto& pair : pairs) {
+      pair->connect(options);
+    }
+
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory_per_connection_pair"] = (end_mem - start_mem) / num_connections;
+    pairs.clear();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(bmIdleConnectionMemory)->Arg(0)->Arg(4096)->Unit(::benchmark::kMillisecond);
+
+// Measures the memory held by idle streams on a single connection.
+void bmIdleStreamMemory(::benchmark::State& state) {
+  const uint64_t num_streams = benchmark::skipExpensiveBenchmarks() ? 10 : state.range(0);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    CodecPair pair;
+    envoy::config::core::v3::Http2ProtocolOptions options = http2Options(4096);
+    options.mutable_max_concurrent_streams()->set_value(num_streams + 1);
+    pair.connect(options);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < num_streams; i++) {
+      pair.openIdleStream();
+    }
+
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory_per_stream_pair"] = (end_mem - start_mem) / num_streams;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(bmIdleStreamMemory)->Arg(1000)->Unit(::benchmark::kMillisecond);
+
+// Measures the throughput of small responses, with the number of concurrent requests given by the
+// first argument and the response body size by the second. All the responses to a batch of
+// requests are encoded while the server codec is dispatching.
+void bmSmallResponses(::benchmark::State& state) {
+  const uint64_t concurrent_requests = state.range(0);
+  const uint64_t body_size = state.range(1);
+  CodecPair pair;
+  envoy::config::core::v3::Http2ProtocolOptions options = http2Options(4096);
+  options.mutable_max_concurrent_streams()->set_value(concurrent_requests);
+  pair.connect(options);
+  pair.respondInline(body_size);
+  pair.server_writes_ = 0;
+
+  uint64_t batches = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    pair.sendRequests(concurrent_requests);
+    ++batches;
+  }
+  state.SetItemsProcessed(batches * concurrent_requests);
+  state.counters["server_writes_per_response"] =
+      static_cast<double>(pair.server_writes_) / (batches * concurrent_requests);
+}
+BENCHMARK(bmSmallResponses)->ArgsProduct({{1, 16, 100}, {0, 100, 1024}});
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -133,6 +133,20 @@ public:
     return stream_ids;
   }
 
+  // Returns the number of HTTP/2 frames in data, which must start at a frame boundary. The codec
+  // writes all the frames produced by one sendPendingFrames() call to the connection at once, so
+  // tests that count frames must count them in each write.
+  static int countFrames(const Buffer::Instance& data) {
+    constexpr uint64_t frame_header_size = 9;
+    int frames = 0;
+    uint64_t offset = 0;
+    while (offset + frame_header_size <= data.length()) {
+      offset += frame_header_size + data.peekBEInt<uint32_t, 3>(offset);
+      ++frames;
+    }
+    return frames;
+  }
+
   static Http2SettingsTuple smallWindowHttp2Settings() {
     return std::make_tuple(CommonUtility::OptionsLimits::DEFAULT_HPACK_TABLE_SIZE,
                            CommonUtility::OptionsLimits::DEFAULT_MAX_CONCURRENT_STREAMS,
@@ -596,6 +610,42 @@ TEST_P(Http2CodecImplTest, SimpleRequestResponse) {
   }
 }
 
+// The frames of a response encoded while the server dispatches the request reach the connection
+// in a single write.
+TEST_P(Http2CodecImplTest, ResponseFramesCoalescedIntoOneWrite) {
+  initialize();
+
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  TestResponseTrailerMapImpl response_trailers{{"trailing", "header"}};
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() -> void {
+        response_encoder_->encodeHeaders(response_headers, false);
+        Buffer::OwnedImpl response_body(std::string(1024, 'b'));
+        response_encoder_->encodeData(response_body, false);
+        response_encoder_->encodeTrailers(response_trailers);
+      }));
+  int write_count = 0;
+  int frame_count = 0;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+        ++write_count;
+        frame_count += countFrames(data);
+        client_wrapper_->buffer_.move(data);
+      }));
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(response_decoder_, decodeData(_, false));
+  EXPECT_CALL(response_decoder_, decodeTrailers_(_));
+  driveToCompletion();
+
+  // HEADERS, DATA and the trailing HEADERS.
+  EXPECT_EQ(1, write_count);
+  EXPECT_EQ(3, frame_count);
+}
+
 TEST_P(Http2CodecImplTest, ClientUnexpectedHeaders) {
   initialize();
 
@@ -1863,7 +1913,7 @@ TEST_P(Http2CodecImplFlowControlTest, TestFlowControlInPendingSendData) {
   Buffer::OwnedImpl more_long_data(std::string(initial_stream_window, 'a'));
   request_encoder_->encodeData(more_long_data, false);
   driveToCompletion();
-  EXPECT_EQ(initial_stream_window, client_->getStream(1)->pending_send_data_->length());
+  EXPECT_EQ(initial_stream_window, client_->getStream(1)->pendingSendDataLength());
   EXPECT_EQ(initial_stream_window,
             TestUtility::findGauge(client_stats_store_, "http2.pending_send_bytes")->value());
   EXPECT_EQ(initial_stream_window, server_->getStream(1)->unconsumed_bytes_);
@@ -1873,7 +1923,7 @@ TEST_P(Http2CodecImplFlowControlTest, TestFlowControlInPendingSendData) {
   Buffer::OwnedImpl last_byte("!");
   request_encoder_->encodeData(last_byte, false);
   driveToCompletion();
-  EXPECT_EQ(initial_stream_window + 1, client_->getStream(1)->pending_send_data_->length());
+  EXPECT_EQ(initial_stream_window + 1, client_->getStream(1)->pendingSendDataLength());
   EXPECT_EQ(initial_stream_window + 1,
             TestUtility::findGauge(client_stats_store_, "http2.pending_send_bytes")->value());
 
@@ -1939,7 +1989,7 @@ TEST_P(Http2CodecImplFlowControlTest, TestFlowControlInPendingSendData) {
   // Allow client to send last bit of data that was pending.
   driveToCompletion();
 
-  EXPECT_EQ(0, client_->getStream(1)->pending_send_data_->length());
+  EXPECT_EQ(0, client_->getStream(1)->pendingSendDataLength());
   EXPECT_EQ(0, TestUtility::findGauge(client_stats_store_, "http2.pending_send_bytes")->value());
   // The extra 1 byte sent won't trigger another window update, so the final window should be the
   // initial window minus the last 1 byte flush from the client to server.
@@ -2301,7 +2351,7 @@ TEST_P(Http2CodecImplFlowControlTest, WindowUpdateOnReadResumingFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -2377,7 +2427,7 @@ TEST_P(Http2CodecImplFlowControlTest, RstStreamOnPendingFlushTimeoutFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3048,7 +3098,7 @@ TEST_P(Http2CodecImplTest, PingFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &ack_count](Buffer::Instance& frame, bool) {
-        ++ack_count;
+        ack_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3077,9 +3127,14 @@ TEST_P(Http2CodecImplTest, PingFloodMitigationDisabled) {
     submitPing(client_, i);
   }
 
-  EXPECT_CALL(server_connection_, write(_, _))
-      .Times(CommonUtility::OptionsLimits::DEFAULT_MAX_OUTBOUND_CONTROL_FRAMES + 1);
+  int ack_count = 0;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([this, &ack_count](Buffer::Instance& frame, bool) {
+        ack_count += countFrames(frame);
+        client_wrapper_->buffer_.move(frame);
+      }));
   EXPECT_NO_THROW(driveToCompletion());
+  EXPECT_EQ(ack_count, CommonUtility::OptionsLimits::DEFAULT_MAX_OUTBOUND_CONTROL_FRAMES + 1);
 }
 
 // Verify that outbound control frame counter decreases when send buffer is drained
@@ -3105,7 +3160,7 @@ TEST_P(Http2CodecImplTest, PingFloodCounterReset) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &ack_count](Buffer::Instance& frame, bool) {
-        ++ack_count;
+        ack_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3148,7 +3203,7 @@ TEST_P(Http2CodecImplTest, ResponseHeadersFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3182,7 +3237,7 @@ TEST_P(Http2CodecImplTest, ResponseDataFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3217,9 +3272,12 @@ TEST_P(Http2CodecImplTest, ResponseDataFloodMitigationDisabled) {
   EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
   driveToCompletion();
 
-  // +2 is to account for HEADERS and PING ACK, that is used to trigger mitigation
-  EXPECT_CALL(server_connection_, write(_, _))
-      .Times(CommonUtility::OptionsLimits::DEFAULT_MAX_OUTBOUND_FRAMES + 2);
+  int frame_count = 0;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([this, &frame_count](Buffer::Instance& frame, bool) {
+        frame_count += countFrames(frame);
+        client_wrapper_->buffer_.move(frame);
+      }));
   EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
   EXPECT_CALL(response_decoder_, decodeData(_, false))
       .Times(CommonUtility::OptionsLimits::DEFAULT_MAX_OUTBOUND_FRAMES);
@@ -3235,6 +3293,8 @@ TEST_P(Http2CodecImplTest, ResponseDataFloodMitigationDisabled) {
   // So we need to send stream from downstream client to trigger mitigation
   submitPing(client_, 0);
   EXPECT_NO_THROW(driveToCompletion());
+  // +2 is to account for HEADERS and PING ACK, that is used to trigger mitigation
+  EXPECT_EQ(frame_count, CommonUtility::OptionsLimits::DEFAULT_MAX_OUTBOUND_FRAMES + 2);
 }
 
 // Verify that outbound frame counter decreases when send buffer is drained
@@ -3253,7 +3313,7 @@ TEST_P(Http2CodecImplTest, ResponseDataFloodCounterReset) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3298,7 +3358,7 @@ TEST_P(Http2CodecImplTest, PingStacksWithDataFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3335,7 +3395,7 @@ TEST_P(Http2CodecImplTest, ResponseTrailersFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3378,7 +3438,7 @@ TEST_P(Http2CodecImplTest, MetadataFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3507,7 +3567,7 @@ TEST_P(Http2CodecImplTest, GoAwayCausesOutboundFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3550,7 +3610,7 @@ TEST_P(Http2CodecImplTest, ShutdownNoticeCausesOutboundFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3606,7 +3666,7 @@ TEST_P(Http2CodecImplTest, KeepAliveCausesOutboundFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
@@ -3650,7 +3710,7 @@ TEST_P(Http2CodecImplTest, ResetStreamCausesOutboundFlood) {
   Buffer::OwnedImpl buffer;
   ON_CALL(server_connection_, write(_, _))
       .WillByDefault(Invoke([&buffer, &frame_count](Buffer::Instance& frame, bool) {
-        ++frame_count;
+        frame_count += countFrames(frame);
         buffer.move(frame);
       }));
 
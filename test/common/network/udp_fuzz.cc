@@ -90,7 +90,8 @@ public:
 
     std::unique_ptr<Network::UdpListenerImpl> listener_ =
         std::make_unique<Network::UdpListenerImpl>(dispatcherImpl(), server_socket_, fuzzCallbacks,
-                                                   dispatcherImpl().timeSource(), config);
+                                                   dispatcherImpl().timeSource(), config,
+                                                   /*prefer_gro_default=*/false);
 
     Network::Address::Instance* send_to_addr_ = new Network::Address::Ipv4Instance(
         "127.0.0.1", server_socket_->connectionInfoProvider().localAddress()->ip()->port());
@@ -21,6 +21,7 @@
 
 #include "envoy/config/core/v3/base.pb.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/socket_option_factory.h"
 #include "source/common/network/socket_option_impl.h"
@@ -28,6 +29,7 @@
 #include "source/common/network/utility.h"
 
 #include "source/common/quic/udp_gso_batch_writer.h"
+#include "source/common/quic/udp_gso_mmsg_batch_writer.h"
 
 #include "test/common/network/udp_listener_impl_test_base.h"
 #include "test/mocks/api/mocks.h"
@@ -44,6 +46,8 @@
 
 using testing::_;
 using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
 using testing::ReturnRef;
 
 namespace Envoy {
@@ -67,7 +71,7 @@ public:
     server_socket_->addOptions(SocketOptionFactory::buildRxQueueOverFlowOptions());
     listener_ = std::make_unique<UdpListenerImpl>(
         dispatcherImpl(), server_socket_, listener_callbacks_, dispatcherImpl().timeSource(),
-        envoy::config::core::v3::UdpSocketConfig());
+        envoy::config::core::v3::UdpSocketConfig(), /*prefer_gro_default=*/false);
     udp_packet_writer_ = std::make_unique<Quic::UdpGsoBatchWriter>(
         server_socket_->ioHandle(), listener_config_.listenerScope());
     ON_CALL(listener_callbacks_, udpPacketWriter()).WillByDefault(ReturnRef(*udp_packet_writer_));
@@ -268,6 +272,166 @@ TEST_P(UdpListenerImplBatchWriterTest, WriteBlocked) {
   }
 }
 
+class UdpListenerImplMmsgBatchWriterTest : public UdpListenerImplTestBase {
+public:
+  void SetUp() override {
+    UdpListenerImplTestBase::setup();
+    server_socket_->addOptions(SocketOptionFactory::buildIpPacketInfoOptions());
+    server_socket_->addOptions(SocketOptionFactory::buildRxQueueOverFlowOptions());
+    listener_ = std::make_unique<UdpListenerImpl>(
+        dispatcherImpl(), server_socket_, listener_callbacks_, dispatcherImpl().timeSource(),
+        envoy::config::core::v3::UdpSocketConfig(), /*prefer_gro_default=*/false);
+    udp_packet_writer_ = std::make_unique<Quic::UdpGsoMmsgBatchWriter>(
+        server_socket_->ioHandle(), listener_config_.listenerScope(), dispatcherImpl());
+    ON_CALL(listener_callbacks_, udpPacketWriter()).WillByDefault(ReturnRef(*udp_packet_writer_));
+  }
+
+  void send(const std::string& payload, const Address::Instance& peer_address) {
+    Buffer::OwnedImpl buffer(payload);
+    UdpSendData send_data{send_to_addr_->ip(), peer_address, buffer};
+    auto send_result = listener_->send(send_data);
+    ASSERT_TRUE(send_result.ok()) << send_result.err_->getErrorDetails();
+    EXPECT_EQ(payload.length(), send_result.return_value_);
+  }
+
+  uint64_t totalBytesSent() {
+    return listener_config_.listenerScope().counterFromString("total_bytes_sent").value();
+  }
+
+  uint64_t internalBufferSize() {
+    return listener_config_.listenerScope()
+        .gaugeFromString("internal_buffer_size", Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, UdpListenerImplMmsgBatchWriterTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+// The packets written during an event loop iteration are only sent at its end, in order.
+TEST_P(UdpListenerImplMmsgBatchWriterTest, SendDataAtEndOfEventLoopIteration) {
+  EXPECT_FALSE(udp_packet_writer_->isBatchMode());
+  const std::vector<std::string> payloads{"length7", "length7", "len<7", "length>7", "length7"};
+  uint64_t payloads_length = 0;
+  for (const auto& payload : payloads) {
+    send(payload, *client_.localAddress());
+    payloads_length += payload.length();
+  }
+  EXPECT_EQ(0, totalBytesSent());
+  EXPECT_EQ(payloads_length, internalBufferSize());
+
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(payloads_length, totalBytesSent());
+  EXPECT_EQ(0, internalBufferSize());
+  for (const auto& payload : payloads) {
+    UdpRecvData data;
+    client_.recv(data);
+    EXPECT_EQ(payload, data.buffer_->toString());
+    EXPECT_EQ(send_to_addr_->asString(), data.addresses_.peer_->asString());
+  }
+}
+
+// Consecutive packets to the same peer are sent as one GSO message, for as long as they have the
+// size of the first one, and all the messages are sent with a single system call.
+TEST_P(UdpListenerImplMmsgBatchWriterTest, GroupPacketsIntoMessages) {
+  if (!Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+    GTEST_SKIP() << "UDP GSO is not supported";
+  }
+  Network::Test::UdpSyncPeer other_client(GetParam());
+  for (const auto& payload : {"length7", "length7", "len<7", "length7"}) {
+    send(payload, *client_.localAddress());
+  }
+  send("length7", *other_client.localAddress());
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _))
+      .WillOnce(Invoke([&](os_fd_t, struct mmsghdr* messages, unsigned int vlen, int) {
+        EXPECT_EQ(3, vlen);
+        const std::vector<std::pair<size_t, uint16_t>> expected_messages{{3, 7}, {1, 0}, {1, 0}};
+        for (unsigned int i = 0; i < vlen; ++i) {
+          msghdr& message = messages[i].msg_hdr;
+          EXPECT_EQ(expected_messages[i].first, message.msg_iovlen);
+          uint16_t segment_size = 0;
+          for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+               cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+              memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+            }
+          }
+          EXPECT_EQ(expected_messages[i].second, segment_size);
+          messages[i].msg_len = getPacketLength(&message);
+        }
+        return Api::SysCallIntResult{static_cast<int>(vlen), 0};
+      }));
+  auto flush_result = udp_packet_writer_->flush();
+  EXPECT_TRUE(flush_result.ok());
+  EXPECT_EQ(33, flush_result.return_value_);
+  EXPECT_EQ(33, totalBytesSent());
+  EXPECT_EQ(0, internalBufferSize());
+}
+
+// The packets that can't be sent because the socket is write blocked are sent once it is writable.
+TEST_P(UdpListenerImplMmsgBatchWriterTest, WriteBlocked) {
+  send("length7", *client_.localAddress());
+  {
+    NiceMock<Api::MockOsSysCalls> os_sys_calls;
+    TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+    EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _))
+        .WillOnce(Return(Api::SysCallIntResult{-1, SOCKET_ERROR_AGAIN}));
+    auto flush_result = udp_packet_writer_->flush();
+    EXPECT_FALSE(flush_result.ok());
+    EXPECT_EQ(Api::IoError::IoErrorCode::Again, flush_result.err_->getErrorCode());
+  }
+  EXPECT_TRUE(udp_packet_writer_->isWriteBlocked());
+  EXPECT_EQ(7, internalBufferSize());
+
+  // Packets can't be written while the writer is blocked.
+  Buffer::OwnedImpl buffer("len<7");
+  auto write_result =
+      udp_packet_writer_->writePacket(buffer, send_to_addr_->ip(), *client_.localAddress());
+  EXPECT_FALSE(write_result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, write_result.err_->getErrorCode());
+  EXPECT_EQ(nullptr, udp_packet_writer_
+                         ->getNextWriteLocation(send_to_addr_->ip(), *client_.localAddress())
+                         .buffer_);
+
+  udp_packet_writer_->setWritable();
+  EXPECT_FALSE(udp_packet_writer_->isWriteBlocked());
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(7, totalBytesSent());
+  EXPECT_EQ(0, internalBufferSize());
+  UdpRecvData data;
+  client_.recv(data);
+  EXPECT_EQ("length7", data.buffer_->toString());
+}
+
+// QUIC connections write their packets in the location that the writer returns, which the writer
+// sends without copying them.
+TEST_P(UdpListenerImplMmsgBatchWriterTest, WriteInNextWriteLocation) {
+  Network::UdpPacketWriterBuffer location =
+      udp_packet_writer_->getNextWriteLocation(send_to_addr_->ip(), *client_.localAddress());
+  ASSERT_NE(nullptr, location.buffer_);
+  EXPECT_EQ(UdpMaxOutgoingPacketSize, location.length_);
+  const std::string payload("in place");
+  memcpy(location.buffer_, payload.data(), payload.length());
+  Buffer::BufferFragmentImpl fragment(location.buffer_, payload.length(), nullptr);
+  Buffer::OwnedImpl buffer;
+  buffer.addBufferFragment(fragment);
+  EXPECT_TRUE(
+      udp_packet_writer_->writePacket(buffer, send_to_addr_->ip(), *client_.localAddress()).ok());
+  EXPECT_NE(location.buffer_, udp_packet_writer_
+                                  ->getNextWriteLocation(send_to_addr_->ip(),
+                                                         *client_.localAddress())
+                                  .buffer_);
+
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  UdpRecvData data;
+  client_.recv(data);
+  EXPECT_EQ(payload, data.buffer_->toString());
+}
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
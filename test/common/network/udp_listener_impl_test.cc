@@ -81,9 +81,9 @@ public:
     if (prefer_gro) {
       config.mutable_prefer_gro()->set_value(prefer_gro);
     }
-    listener_ =
-        std::make_unique<UdpListenerImpl>(dispatcherImpl(), server_socket_, listener_callbacks_,
-                                          dispatcherImpl().timeSource(), config);
+    listener_ = std::make_unique<UdpListenerImpl>(
+        dispatcherImpl(), server_socket_, listener_callbacks_, dispatcherImpl().timeSource(),
+        config, /*prefer_gro_default=*/false);
     udp_packet_writer_ = std::make_unique<Network::UdpDefaultWriter>(server_socket_->ioHandle());
     int get_recvbuf_size = 0;
     socklen_t int_size = static_cast<socklen_t>(sizeof(get_recvbuf_size));
@@ -0,0 +1,146 @@
+// Usage: bazel run //test/common/quic:envoy_quic_stream_benchmark
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/memory/stats.h"
+#include "source/common/quic/envoy_quic_alarm_factory.h"
+#include "source/common/quic/envoy_quic_connection_helper.h"
+#include "source/common/quic/envoy_quic_server_connection.h"
+#include "source/common/quic/envoy_quic_server_stream.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/quic/test_utils.h"
+#include "test/mocks/http/stream_decoder.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "quiche/quic/core/deterministic_connection_id_generator.h"
+#include "quiche/quic/test_tools/quic_connection_peer.h"
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+using testing::NiceMock;
+
+/**
+ * A server session whose streams receive the request headers, and optionally the start of the
+ * request body, and then wait for the rest of the request, like the streams of a long-lived
+ * HTTP/3 connection which are waiting for their client.
+ */
+class IdleStreamSession {
+public:
+  explicit IdleStreamSession(uint32_t max_streams)
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        connection_helper_(*dispatcher_),
+        alarm_factory_(*dispatcher_, *connection_helper_.GetClock()),
+        quic_version_(quic::CurrentSupportedHttp3Versions()[0]),
+        quic_config_(quicConfig(max_streams)),
+        quic_connection_(connection_helper_, alarm_factory_, writer_,
+                         quic::ParsedQuicVersionVector{quic_version_}, *listener_config_.socket_,
+                         connection_id_generator_),
+        quic_stat_names_(listener_config_.listenerScope().symbolTable()),
+        quic_session_(quic_config_, {quic_version_}, &quic_connection_, *dispatcher_,
+                      quic_config_.GetInitialStreamFlowControlWindowToSend() * 2, quic_stat_names_,
+                      listener_config_.listenerScope()),
+        stats_({ALL_HTTP3_CODEC_STATS(
+            POOL_COUNTER_PREFIX(listener_config_.listenerScope(), "http3."),
+            POOL_GAUGE_PREFIX(listener_config_.listenerScope(), "http3."))}) {
+    quic::test::QuicConnectionPeer::SetAddressValidated(&quic_connection_);
+    quic_session_.Initialize();
+    setQuicConfigWithDefaultValues(quic_session_.config());
+    quic_connection_.SetEncrypter(
+        quic::ENCRYPTION_FORWARD_SECURE,
+        std::make_unique<quic::test::TaggingEncrypter>(quic::ENCRYPTION_FORWARD_SECURE));
+    quic_connection_.SetDefaultEncryptionLevel(quic::ENCRYPTION_FORWARD_SECURE);
+    quic_session_.OnConfigNegotiated();
+    quic::SettingsFrame settings;
+    settings.values[quic::SETTINGS_H3_DATAGRAM] = 1;
+    RELEASE_ASSERT(quic_session_.OnSettingsFrame(settings), "");
+
+    quiche::HttpHeaderBlock request_headers;
+    request_headers[":authority"] = "www.abc.com";
+    request_headers[":method"] = "POST";
+    request_headers[":path"] = "/";
+    request_headers[":scheme"] = "https";
+    request_headers_payload_ = spdyHeaderToHttp3StreamPayload(request_headers);
+  }
+
+  ~IdleStreamSession() { quic_session_.close(Network::ConnectionCloseType::NoFlush); }
+
+  // Opens a stream which receives the request headers and body_size bytes of body.
+  void openIdleStream(uint64_t body_size) {
+    auto stream = std::make_unique<EnvoyQuicServerStream>(
+        next_stream_id_, &quic_session_, quic::BIDIRECTIONAL, stats_, http3_options_,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+    next_stream_id_ += quic::QuicUtils::StreamIdDelta(quic_version_.transport_version);
+    stream->setRequestDecoder(stream_decoder_);
+    EnvoyQuicServerStream& stream_ref = *stream;
+    quic_session_.ActivateStream(std::move(stream));
+
+    std::string data = request_headers_payload_;
+    if (body_size > 0) {
+      absl::StrAppend(&data, bodyToHttp3StreamPayload(std::string(body_size, 'a')));
+    }
+    quic::QuicStreamFrame frame(stream_ref.id(), /*fin=*/false, 0, data);
+    stream_ref.OnStreamFrame(frame);
+  }
+
+private:
+  static quic::QuicConfig quicConfig(uint32_t max_streams) {
+    quic::QuicConfig config;
+    config.SetMaxBidirectionalStreamsToSend(max_streams);
+    config.SetInitialSessionFlowControlWindowToSend(quic::kSessionReceiveWindowLimit);
+    return config;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  EnvoyQuicConnectionHelper connection_helper_;
+  EnvoyQuicAlarmFactory alarm_factory_;
+  NiceMock<quic::test::MockPacketWriter> writer_;
+  quic::ParsedQuicVersion quic_version_;
+  quic::QuicConfig quic_config_;
+  NiceMock<Network::MockListenerConfig> listener_config_;
+  quic::DeterministicConnectionIdGenerator connection_id_generator_{
+      quic::kQuicDefaultConnectionIdLength};
+  NiceMock<MockEnvoyQuicServerConnection> quic_connection_;
+  QuicStatNames quic_stat_names_;
+  NiceMock<MockEnvoyQuicSession> quic_session_;
+  Http::Http3::CodecStats stats_;
+  envoy::config::core::v3::Http3ProtocolOptions http3_options_;
+  NiceMock<Http::MockRequestDecoder> stream_decoder_;
+  std::string request_headers_payload_;
+  quic::QuicStreamId next_stream_id_{0};
+};
+
+// Measures the memory held by idle server streams on a single connection, which have received
+// the request headers and as many bytes of request body as the first argument.
+void bmIdleServerStreamMemory(::benchmark::State& state) {
+  const uint64_t body_size = state.range(0);
+  const uint32_t num_streams = benchmark::skipExpensiveBenchmarks() ? 10 : 1000;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    IdleStreamSession session(num_streams);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.ResumeTiming();
+
+    for (uint32_t i = 0; i < num_streams; i++) {
+      session.openIdleStream(body_size);
+    }
+
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory_per_stream"] = (end_mem - start_mem) / num_streams;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(bmIdleServerStreamMemory)->Arg(0)->Arg(1024)->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Quic
+} // namespace Envoy
@@ -0,0 +1,231 @@
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/api/api_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/socket_option_factory.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/quic/udp_gso_batch_writer.h"
+#include "source/common/quic/udp_gso_mmsg_batch_writer.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Quic {
+
+// The size of the packets that QUIC connections write on a path with a typical MTU.
+static constexpr size_t PacketSize = 1350;
+
+// The CPU time that the calling thread has spent, in user space and in the kernel.
+static double threadCpuSeconds() {
+  rusage usage;
+  RELEASE_ASSERT(getrusage(RUSAGE_THREAD, &usage) == 0, "getrusage");
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// A socket on the loopback interface which receives with GRO, so that draining it costs little
+// whatever the writer under test does.
+static std::unique_ptr<Network::UdpListenSocket> createPeerSocket() {
+  auto options = std::make_shared<Network::Socket::Options>();
+  if (Api::OsSysCallsSingleton::get().supportsUdpGro()) {
+    Network::Socket::appendOptions(options, Network::SocketOptionFactory::buildUdpGroOptions());
+  }
+  auto socket = std::make_unique<Network::UdpListenSocket>(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 0), options, true);
+  const int buffer_size = 8 * 1024 * 1024;
+  socket->setSocketOption(SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+  return socket;
+}
+
+static void drain(Network::Socket& socket) {
+  char buffer[64 * 1024];
+  while (::recv(socket.ioHandle().fdDoNotUse(), buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+  }
+}
+
+// Measures the gigabits per second that a core sends through a UDP packet writer, in the
+// sendmsg() or sendmmsg() system calls and in the kernel on the loopback interface, when QUIC
+// connections are paced to write two packets at a time. The first argument is the writer: 0 for the
+// default one, 1 for the GSO batch writer which is flushed by each connection, and 2 for the one
+// which aggregates the packets of all the connections until the end of the event loop iteration.
+// The second argument is the number of connections that write in each iteration.
+static void testUdpWriterThroughput(benchmark::State& state) {
+  const int64_t writer_type = state.range(0);
+  const uint32_t num_connections = state.range(1);
+  const uint32_t packets_per_write = 2;
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  Stats::IsolatedStoreImpl store;
+  Network::UdpListenSocket server_socket(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 0), nullptr, true);
+  const int buffer_size = 8 * 1024 * 1024;
+  server_socket.setSocketOption(SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+  std::unique_ptr<Network::UdpPacketWriterFactory> factory;
+  switch (writer_type) {
+  case 0:
+    factory = std::make_unique<Network::UdpDefaultWriterFactory>();
+    break;
+  case 1:
+    factory = std::make_unique<UdpGsoBatchWriterFactory>();
+    break;
+  default:
+    factory = std::make_unique<UdpGsoMmsgBatchWriterFactory>();
+    break;
+  }
+  Network::UdpPacketWriterPtr writer =
+      factory->createUdpPacketWriter(server_socket.ioHandle(), *store.rootScope(), *dispatcher);
+  const Network::Address::Ip* self_ip = server_socket.connectionInfoProvider().localAddress()->ip();
+
+  std::vector<std::unique_ptr<Network::UdpListenSocket>> peers;
+  for (uint32_t i = 0; i < num_connections; ++i) {
+    peers.push_back(createPeerSocket());
+  }
+  const std::string payload(PacketSize, 'a');
+
+  uint64_t bytes_sent = 0;
+  double cpu_seconds = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const double start_cpu_seconds = threadCpuSeconds();
+    for (const auto& peer : peers) {
+      const Network::Address::Instance& peer_address =
+          *peer->connectionInfoProvider().localAddress();
+      for (uint32_t i = 0; i < packets_per_write; ++i) {
+        // Like QUIC connections, serialize the packet in the writer's buffer if it provides one.
+        Network::UdpPacketWriterBuffer location =
+            writer->getNextWriteLocation(self_ip, peer_address);
+        const void* data = payload.data();
+        if (location.buffer_ != nullptr) {
+          memcpy(location.buffer_, payload.data(), PacketSize);
+          data = location.buffer_;
+        }
+        Buffer::BufferFragmentImpl fragment(data, PacketSize, nullptr);
+        Buffer::OwnedImpl buffer;
+        buffer.addBufferFragment(fragment);
+        if (writer->writePacket(buffer, self_ip, peer_address).ok()) {
+          bytes_sent += PacketSize;
+        }
+      }
+      if (writer->isBatchMode()) {
+        writer->flush();
+      }
+    }
+    // The end of the event loop iteration.
+    dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    if (writer->isWriteBlocked()) {
+      writer->setWritable();
+    }
+    cpu_seconds += threadCpuSeconds() - start_cpu_seconds;
+
+    for (const auto& peer : peers) {
+      drain(*peer);
+    }
+  }
+
+  state.counters["gbps_per_core"] = cpu_seconds > 0 ? bytes_sent * 8 / 1e9 / cpu_seconds : 0;
+  state.counters["throughput"] = benchmark::Counter(bytes_sent, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(testUdpWriterThroughput)
+    ->Unit(::benchmark::kMicrosecond)
+    ->ArgsProduct({{0, 1, 2}, {1, 16, 64}});
+
+class CountingUdpPacketProcessor : public Network::UdpPacketProcessor {
+public:
+  void processPacket(Network::Address::InstanceConstSharedPtr,
+                     Network::Address::InstanceConstSharedPtr, Buffer::InstancePtr buffer,
+                     MonotonicTime, uint8_t, Buffer::RawSlice) override {
+    bytes_received_ += buffer->length();
+    ++packets_received_;
+  }
+  void onDatagramsDropped(uint32_t) override {}
+  uint64_t maxDatagramSize() const override { return Network::DEFAULT_UDP_MAX_DATAGRAM_SIZE; }
+  size_t numPacketsExpectedPerEventLoop() const override {
+    return Network::MAX_NUM_PACKETS_PER_EVENT_LOOP;
+  }
+  const Network::IoHandle::UdpSaveCmsgConfig& saveCmsgConfig() const override {
+    return save_cmsg_config_;
+  }
+
+  uint64_t bytes_received_{0};
+  uint64_t packets_received_{0};
+
+private:
+  Network::IoHandle::UdpSaveCmsgConfig save_cmsg_config_;
+};
+
+// Measures the gigabits per second that a core receives through a QUIC listener socket on the
+// loopback interface, with recvmmsg() when the argument is 0 and with GRO when it is 1. A client
+// sends runs of packets with GSO, as a QUIC client sending a request body would. The socket only
+// has the UDP_GRO option with GRO reads, as recvmmsg() would truncate the coalesced packets.
+static void testUdpListenerReceiveThroughput(benchmark::State& state) {
+  const bool prefer_gro = state.range(0) != 0;
+  if (prefer_gro && !Api::OsSysCallsSingleton::get().supportsUdpGro()) {
+    state.SkipWithError("UDP GRO is not supported on this platform");
+    return;
+  }
+  const uint32_t packets_per_iteration = 256;
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  Stats::IsolatedStoreImpl store;
+  auto options = std::make_shared<Network::Socket::Options>();
+  Network::Socket::appendOptions(options, Network::SocketOptionFactory::buildIpPacketInfoOptions());
+  Network::Socket::appendOptions(options,
+                                 Network::SocketOptionFactory::buildRxQueueOverFlowOptions());
+  if (prefer_gro) {
+    Network::Socket::appendOptions(options, Network::SocketOptionFactory::buildUdpGroOptions());
+  }
+  Network::UdpListenSocket server_socket(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 0), options, true);
+  const int buffer_size = 8 * 1024 * 1024;
+  server_socket.setSocketOption(SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+  const Network::Address::Instance& server_address =
+      *server_socket.connectionInfoProvider().localAddress();
+
+  Network::UdpListenSocket client_socket(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 0), nullptr, true);
+  UdpGsoMmsgBatchWriter writer(client_socket.ioHandle(), *store.rootScope(), *dispatcher);
+  const std::string payload(PacketSize, 'a');
+  CountingUdpPacketProcessor processor;
+  uint32_t packets_dropped = 0;
+
+  double cpu_seconds = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (uint32_t i = 0; i < packets_per_iteration; ++i) {
+      Buffer::OwnedImpl buffer(payload);
+      writer.writePacket(buffer, nullptr, server_address);
+    }
+    writer.flush();
+
+    const double start_cpu_seconds = threadCpuSeconds();
+    Network::Utility::readPacketsFromSocket(server_socket.ioHandle(), server_address, processor,
+                                            api->timeSource(), prefer_gro, /*allow_mmsg=*/true,
+                                            packets_dropped);
+    cpu_seconds += threadCpuSeconds() - start_cpu_seconds;
+  }
+
+  state.counters["gbps_per_core"] =
+      cpu_seconds > 0 ? processor.bytes_received_ * 8 / 1e9 / cpu_seconds : 0;
+  state.counters["packets_per_iteration"] =
+      benchmark::Counter(processor.packets_received_, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(testUdpListenerReceiveThroughput)->Unit(::benchmark::kMicrosecond)->Arg(0)->Arg(1);
+
+} // namespace Quic
+} // namespace Envoy
@@ -0,0 +1,211 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
+
+#include "source/common/memory/stats.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tls/default_tls_certificate_selector.h"
+#include "source/common/tls/server_context_config_impl.h"
+#include "source/common/tls/server_context_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "openssl/pem.h"
+#include "openssl/x509v3.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string bioContents(BIO* bio) {
+  const uint8_t* data;
+  size_t len;
+  RELEASE_ASSERT(BIO_mem_contents(bio, &data, &len) == 1, "BIO_mem_contents");
+  return {reinterpret_cast<const char*>(data), len};
+}
+
+// Returns a self-signed certificate in PEM for the key, with the DNS SANs of tenant `i`:
+// www.tenant<i>.example.com and *.tenant<i>.example.com.
+std::string tenantCertificatePem(EVP_PKEY* key, uint32_t i) {
+  const std::string exact_name = absl::StrCat("www.tenant", i, ".example.com");
+  const std::string wildcard_name = absl::StrCat("*.tenant", i, ".example.com");
+
+  bssl::UniquePtr<X509> cert(X509_new());
+  RELEASE_ASSERT(X509_set_version(cert.get(), X509_VERSION_3) == 1, "X509_set_version");
+  RELEASE_ASSERT(ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), i + 1) == 1,
+                 "ASN1_INTEGER_set");
+  X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+  X509_gmtime_adj(X509_getm_notAfter(cert.get()), 365 * 24 * 60 * 60);
+  X509_NAME* name = X509_get_subject_name(cert.get());
+  X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                             reinterpret_cast<const uint8_t*>(exact_name.c_str()), -1, -1, 0);
+  X509_set_issuer_name(cert.get(), name);
+  X509_set_pubkey(cert.get(), key);
+
+  bssl::UniquePtr<GENERAL_NAMES> sans(GENERAL_NAMES_new());
+  for (const std::string& dns_name : {exact_name, wildcard_name}) {
+    GENERAL_NAME* san = GENERAL_NAME_new();
+    ASN1_IA5STRING* value = ASN1_IA5STRING_new();
+    ASN1_STRING_set(value, dns_name.data(), dns_name.size());
+    GENERAL_NAME_set0_value(san, GEN_DNS, value);
+    sk_GENERAL_NAME_push(sans.get(), san);
+  }
+  RELEASE_ASSERT(X509_add1_i2d(cert.get(), NID_subject_alt_name, sans.get(), 0,
+                               X509V3_ADD_DEFAULT) == 1,
+                 "X509_add1_i2d");
+  RELEASE_ASSERT(X509_sign(cert.get(), key, EVP_sha256()) != 0, "X509_sign");
+
+  bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+  RELEASE_ASSERT(PEM_write_bio_X509(bio.get(), cert.get()) == 1, "PEM_write_bio_X509");
+  return bioContents(bio.get());
+}
+
+// The configuration of a listener of a multi-tenant edge, with a P-256 ECDSA certificate for each
+// tenant. The certificates share a key, which doesn't change the cost of loading them.
+class TenantListener {
+public:
+  explicit TenantListener(uint32_t num_certs) : api_(Api::createApiForTest(store_)) {
+    ON_CALL(factory_context_.server_context_, api()).WillByDefault(testing::ReturnRef(*api_));
+
+    bssl::UniquePtr<EC_KEY> ec_key(EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+    RELEASE_ASSERT(EC_KEY_generate_key(ec_key.get()) == 1, "EC_KEY_generate_key");
+    bssl::UniquePtr<EVP_PKEY> key(EVP_PKEY_new());
+    RELEASE_ASSERT(EVP_PKEY_assign_EC_KEY(key.get(), ec_key.release()) == 1,
+                   "EVP_PKEY_assign_EC_KEY");
+    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+    RELEASE_ASSERT(PEM_write_bio_PrivateKey(bio.get(), key.get(), nullptr, nullptr, 0, nullptr,
+                                            nullptr) == 1,
+                   "PEM_write_bio_PrivateKey");
+    const std::string key_pem = bioContents(bio.get());
+
+    envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+    tls_context.mutable_full_scan_certs_on_sni_mismatch()->set_value(true);
+    for (uint32_t i = 0; i < num_certs; i++) {
+      auto* tls_certificate = tls_context.mutable_common_tls_context()->add_tls_certificates();
+      tls_certificate->mutable_certificate_chain()->set_inline_string(
+          tenantCertificatePem(key.get(), i));
+      tls_certificate->mutable_private_key()->set_inline_string(key_pem);
+    }
+    config_ = *ServerContextConfigImpl::create(tls_context, factory_context_, false);
+  }
+
+  std::unique_ptr<ServerContextImpl> buildServerContext() {
+    return *ServerContextImpl::create(*store_.rootScope(), *config_, {},
+                                      factory_context_.server_context_, nullptr);
+  }
+
+  const Ssl::ServerContextConfig& config() const { return *config_; }
+
+private:
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  std::unique_ptr<ServerContextConfigImpl> config_;
+};
+
+uint32_t numCerts(::benchmark::State& state) {
+  return benchmark::skipExpensiveBenchmarks() ? std::min<uint32_t>(state.range(0), 100)
+                                              : state.range(0);
+}
+
+// Measures the time to build the server context of a listener with the number of certificates
+// given by the argument, as on startup or on a listener update, and the memory it takes.
+void bmBuildServerContext(::benchmark::State& state) {
+  const uint32_t num_certs = numCerts(state);
+  TenantListener listener(num_certs);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    std::unique_ptr<ServerContextImpl> server_ctx = listener.buildServerContext();
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_cert"] = (end_mem - start_mem) / num_certs;
+    server_ctx.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(bmBuildServerContext)->Arg(1000)->Arg(20000)->Unit(::benchmark::kMillisecond);
+
+// Measures the time to build the certificate selector of the server context of a listener with the
+// number of certificates given by the argument, and the memory it takes.
+void bmBuildCertificateSelector(::benchmark::State& state) {
+  const uint32_t num_certs = numCerts(state);
+  TenantListener listener(num_certs);
+  std::unique_ptr<ServerContextImpl> server_ctx = listener.buildServerContext();
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    auto selector = std::make_unique<DefaultTlsCertificateSelector>(listener.config(), *server_ctx);
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_cert"] = (end_mem - start_mem) / num_certs;
+    selector.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(bmBuildCertificateSelector)->Arg(1000)->Arg(20000)->Unit(::benchmark::kMillisecond);
+
+// Measures the selection of the certificate of a handshake among the number of certificates given
+// by the first argument. The second argument is the kind of ClientHello:
+// 0: an SNI that is a name of a certificate.
+// 1: an SNI that matches a wildcard name of a certificate.
+// 2: no SNI, from a client that only supports P-384, which no certificate has.
+// 3: an SNI that matches no certificate, from a client that only supports P-384.
+// The selection falls back to the first certificate in the last two cases.
+void bmSelectCertificate(::benchmark::State& state) {
+  const uint32_t num_certs = numCerts(state);
+  const int64_t kind = state.range(1);
+  TenantListener listener(num_certs);
+  std::unique_ptr<ServerContextImpl> server_ctx = listener.buildServerContext();
+
+  std::vector<std::string> server_names;
+  for (uint32_t i = 0; i < num_certs; i++) {
+    switch (kind) {
+    case 0:
+      server_names.push_back(absl::StrCat("www.tenant", i, ".example.com"));
+      break;
+    case 1:
+      server_names.push_back(absl::StrCat("api.tenant", i, ".example.com"));
+      break;
+    case 2:
+      server_names.push_back("");
+      break;
+    default:
+      server_names.push_back(absl::StrCat("www.tenant", i, ".example.org"));
+      break;
+    }
+  }
+  const Ssl::CurveNIDVector client_ecdsa_capabilities{
+      kind < 2 ? NID_X9_62_prime256v1 : NID_secp384r1};
+
+  uint32_t i = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const Ssl::TlsContext& selected =
+        server_ctx
+            ->findTlsContext(server_names[i], client_ecdsa_capabilities, false, nullptr)
+            .first;
+    ::benchmark::DoNotOptimize(selected);
+    i = (i + 1) % num_certs;
+  }
+}
+BENCHMARK(bmSelectCertificate)->ArgsProduct({{1000, 20000}, {0, 1, 2, 3}});
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
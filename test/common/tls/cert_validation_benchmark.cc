@@ -0,0 +1,76 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tls/cert_validator/default_validator.h"
+
+#include "test/common/tls/cert_validator/test_common.h"
+#include "test/common/tls/ssl_test_utility.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string testDataPath(absl::string_view file) {
+  return TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", file));
+}
+
+// Measures the verification of the certificate chain that a client presents in an mTLS handshake,
+// without the verified chain cache when the argument is 0, and with it otherwise. The chain is a
+// leaf and three intermediate CA certificates, the same for every handshake, as when many
+// connections come from the same few clients.
+void bmVerifyClientCertChain(::benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("cert_validation_benchmark", &error));
+  TestEnvironment::setRunfiles(runfiles.get());
+
+  testing::NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  Stats::IsolatedStoreImpl store;
+  SslStats stats = generateSslStats(*store.rootScope());
+  TestCertificateValidationContextConfig config(
+      envoy::config::core::v3::TypedExtensionConfig(), false, {},
+      TestEnvironment::readFileToStringForTest(testDataPath("ca_cert.pem")), absl::nullopt,
+      state.range(0) == 0 ? 0 : 1024);
+  DefaultCertValidator validator(&config, stats, context);
+  bssl::UniquePtr<SSL_CTX> ssl_ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(validator.initializeSslContexts({ssl_ctx.get()}, false).ok(), "");
+
+  bssl::UniquePtr<STACK_OF(X509)> cert_chain(sk_X509_new_null());
+  bssl::PushToStack(cert_chain.get(), readCertFromFile(testDataPath("test_random_cert.pem")));
+  bssl::UniquePtr<STACK_OF(X509)> intermediates =
+      readCertChainFromFile(testDataPath("test_long_cert_chain.pem"));
+  for (X509* intermediate : intermediates.get()) {
+    X509_up_ref(intermediate);
+    bssl::PushToStack(cert_chain.get(), bssl::UniquePtr<X509>(intermediate));
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const ValidationResults results = validator.doVerifyCertChain(
+        *cert_chain, /*callback=*/nullptr, /*transport_socket_options=*/nullptr, *ssl_ctx, {},
+        /*is_server=*/true, "");
+    RELEASE_ASSERT(results.status == ValidationResults::ValidationStatus::Successful,
+                   results.error_details.value_or(""));
+  }
+}
+BENCHMARK(bmVerifyClientCertChain)->Arg(0)->Arg(1);
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -3,11 +3,13 @@
 
 #include "source/common/tls/cert_validator/default_validator.h"
 #include "source/common/tls/cert_validator/san_matcher.h"
+#include "source/common/tls/utility.h"
 
 #include "test/common/tls/cert_validator/test_common.h"
 #include "test/common/tls/ssl_test_utility.h"
 #include "test/mocks/server/server_factory_context.h"
 #include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -674,6 +676,62 @@ TEST(DefaultCertValidatorTest, WithVerifyDepth) {
   EXPECT_EQ(X509_STORE_CTX_get_error(store_ctx.get()), X509_V_OK);
 }
 
+TEST(DefaultCertValidatorTest, VerifiedChainCache) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> context;
+  Event::SimulatedTimeSystem time_system;
+  ON_CALL(context, timeSource()).WillByDefault(testing::ReturnRef(time_system));
+  Stats::TestUtil::TestStore test_store;
+  SslStats stats = generateSslStats(*test_store.rootScope());
+  envoy::config::core::v3::TypedExtensionConfig typed_conf;
+  std::vector<envoy::extensions::transport_sockets::tls::v3::SubjectAltNameMatcher> san_matchers{};
+
+  const std::string ca_cert_str = TestEnvironment::readFileToStringForTest(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/ca_cert.pem"));
+  auto test_config = std::make_unique<TestCertificateValidationContextConfig>(
+      typed_conf, false, san_matchers, ca_cert_str, absl::nullopt, 16);
+  auto default_validator =
+      std::make_unique<DefaultCertValidator>(test_config.get(), stats, context);
+  SSLContextPtr ssl_ctx = SSL_CTX_new(TLS_method());
+  ASSERT_TRUE(default_validator->initializeSslContexts({ssl_ctx.get()}, false).ok());
+
+  auto verify = [&](absl::string_view cert_file) {
+    bssl::UniquePtr<X509> cert = readCertFromFile(TestEnvironment::substitute(
+        absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", cert_file)));
+    bssl::UniquePtr<STACK_OF(X509)> cert_chain(sk_X509_new_null());
+    EXPECT_TRUE(bssl::PushToStack(cert_chain.get(), std::move(cert)));
+    return default_validator
+        ->doVerifyCertChain(*cert_chain, /*callback=*/nullptr,
+                            /*transport_socket_options=*/nullptr, *ssl_ctx, {}, true, "")
+        .status;
+  };
+  auto hits = [&]() {
+    return test_store.counterFromString("ssl.verified_chain_cache_hit").value();
+  };
+  auto misses = [&]() {
+    return test_store.counterFromString("ssl.verified_chain_cache_miss").value();
+  };
+
+  // The chain is verified once, and found in the cache the next time.
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, verify("san_dns_cert.pem"));
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, verify("san_dns_cert.pem"));
+  EXPECT_EQ(1U, hits());
+  EXPECT_EQ(1U, misses());
+
+  // A chain that fails verification is not cached.
+  EXPECT_EQ(ValidationResults::ValidationStatus::Failed, verify("selfsigned_cert.pem"));
+  EXPECT_EQ(ValidationResults::ValidationStatus::Failed, verify("selfsigned_cert.pem"));
+  EXPECT_EQ(1U, hits());
+  EXPECT_EQ(3U, misses());
+
+  // The chain is forgotten once its certificate expires.
+  bssl::UniquePtr<X509> cert = readCertFromFile(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem"));
+  time_system.setSystemTime(Utility::getExpirationTime(*cert));
+  verify("san_dns_cert.pem");
+  EXPECT_EQ(1U, hits());
+  EXPECT_EQ(4U, misses());
+}
+
 class MockCertificateValidationContextConfig : public Ssl::CertificateValidationContextConfig {
 public:
   MockCertificateValidationContextConfig() : MockCertificateValidationContextConfig("") {}
@@ -705,6 +763,7 @@ public:
   bool onlyVerifyLeafCertificateCrl() const override { return false; }
   absl::optional<uint32_t> maxVerifyDepth() const override { return absl::nullopt; }
   bool autoSniSanMatch() const override { return false; }
+  uint32_t verifiedChainCacheSize() const override { return 0; }
 
 private:
   std::string s_;
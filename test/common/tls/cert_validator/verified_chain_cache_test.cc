@@ -0,0 +1,82 @@
+#include <chrono>
+#include <string>
+
+#include "source/common/tls/cert_validator/verified_chain_cache.h"
+
+#include "test/common/tls/ssl_test_utility.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+bssl::UniquePtr<STACK_OF(X509)> readChain(absl::string_view cert_file) {
+  bssl::UniquePtr<STACK_OF(X509)> cert_chain(sk_X509_new_null());
+  EXPECT_TRUE(bssl::PushToStack(
+      cert_chain.get(),
+      readCertFromFile(TestEnvironment::substitute(
+          absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", cert_file)))));
+  return cert_chain;
+}
+
+TEST(VerifiedChainCacheTest, Key) {
+  auto chain = readChain("san_dns_cert.pem");
+  auto same_chain = readChain("san_dns_cert.pem");
+  auto other_chain = readChain("san_uri_cert.pem");
+
+  EXPECT_EQ(VerifiedChainCache::key(*chain, true), VerifiedChainCache::key(*same_chain, true));
+  EXPECT_NE(VerifiedChainCache::key(*chain, true), VerifiedChainCache::key(*chain, false));
+  EXPECT_NE(VerifiedChainCache::key(*chain, true), VerifiedChainCache::key(*other_chain, true));
+}
+
+TEST(VerifiedChainCacheTest, Expiration) {
+  Event::SimulatedTimeSystem time_system;
+  VerifiedChainCache cache(16, time_system);
+
+  cache.insert("chain", time_system.systemTime() + std::chrono::seconds(10));
+  EXPECT_TRUE(cache.lookup("chain"));
+  EXPECT_FALSE(cache.lookup("other chain"));
+
+  time_system.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_FALSE(cache.lookup("chain"));
+  EXPECT_EQ(0U, cache.size());
+}
+
+TEST(VerifiedChainCacheTest, Bounded) {
+  Event::SimulatedTimeSystem time_system;
+  VerifiedChainCache cache(16, time_system);
+  const SystemTime expiration = time_system.systemTime() + std::chrono::hours(1);
+
+  for (int i = 0; i < 1000; i++) {
+    cache.insert(absl::StrCat("chain", i), expiration);
+  }
+  EXPECT_EQ(16U, cache.size());
+  // The most recently verified chain is kept.
+  EXPECT_TRUE(cache.lookup("chain999"));
+}
+
+// The bound applies to the whole cache, however small it is.
+TEST(VerifiedChainCacheTest, SingleEntry) {
+  Event::SimulatedTimeSystem time_system;
+  VerifiedChainCache cache(1, time_system);
+  const SystemTime expiration = time_system.systemTime() + std::chrono::hours(1);
+
+  for (int i = 0; i < 100; i++) {
+    cache.insert(absl::StrCat("chain", i), expiration);
+    EXPECT_EQ(1U, cache.size());
+  }
+  EXPECT_TRUE(cache.lookup("chain99"));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -13,6 +13,7 @@
 #include "source/common/tls/context_config_impl.h"
 #include "source/common/tls/context_impl.h"
 #include "source/common/tls/server_context_config_impl.h"
+#include "source/common/tls/server_context_impl.h"
 #include "source/common/tls/server_ssl_socket.h"
 #include "source/common/tls/utility.h"
 
@@ -687,6 +688,44 @@ TEST_F(SslContextImplTest, MustHaveSubjectOrSAN) {
       "Invalid TLS context has neither subject CN nor SAN names");
 }
 
+// Without SNI, the first certificate with one of the curves of the client is selected, or else the
+// first RSA certificate.
+TEST_F(SslContextImplTest, NoSniSelectsFirstCertOfClientCurves) {
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+  const std::string tls_context_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_ecdsa_p384_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_ecdsa_p384_key.pem"
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_ecdsa_p256_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_ecdsa_p256_key.pem"
+    - certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/selfsigned_key.pem"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_context_yaml), tls_context);
+  auto server_context_config =
+      *ServerContextConfigImpl::create(tls_context, factory_context_, false);
+  Envoy::Ssl::ServerContextSharedPtr server_ctx(
+      *manager_.createSslServerContext(*store_.rootScope(), *server_context_config, {}, nullptr));
+  auto cleanup = cleanUpHelper(server_ctx);
+  auto& server_ctx_impl = dynamic_cast<ServerContextImpl&>(*server_ctx);
+  const auto& tls_contexts = server_ctx_impl.getTlsContexts();
+
+  auto select = [&](const Ssl::CurveNIDVector& client_ecdsa_capabilities) {
+    return &server_ctx_impl.findTlsContext("", client_ecdsa_capabilities, false, nullptr).first;
+  };
+  EXPECT_EQ(&tls_contexts[0], select({NID_X9_62_prime256v1, NID_secp384r1}));
+  EXPECT_EQ(&tls_contexts[1], select({NID_X9_62_prime256v1}));
+  EXPECT_EQ(&tls_contexts[2], select({NID_secp521r1}));
+  EXPECT_EQ(&tls_contexts[2], select({}));
+}
+
 class SslServerContextImplOcspTest : public SslContextImplTest {
 public:
   Envoy::Ssl::ServerContextSharedPtr loadConfig(ServerContextConfigImpl& cfg) {
@@ -0,0 +1,471 @@
+#include <fcntl.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/tls/kernel_tls.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/aead.h"
+#include "openssl/err.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string testDataPath(absl::string_view file) {
+  return TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", file));
+}
+
+// Hosts with the tls kernel module set ENVOY_KTLS_AVAILABLE, so that a connection that stays in
+// BoringSSL fails the tests there instead of skipping them.
+bool kernelTlsExpected() {
+  return TestEnvironment::getOptionalEnvVar("ENVOY_KTLS_AVAILABLE").has_value();
+}
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+// The crypto_info of one direction of a connection, whatever its cipher.
+struct CryptoInfo {
+  uint16_t version_{};
+  uint16_t cipher_type_{};
+  std::string key_;
+  // The salt followed by the IV.
+  std::string nonce_;
+  uint64_t sequence_{};
+};
+
+std::string bigEndian(uint64_t value, size_t length) {
+  std::string out(length, '\0');
+  for (size_t i = length; i > 0; i--) {
+    out[i - 1] = static_cast<char>(value & 0xff);
+    value >>= 8;
+  }
+  return out;
+}
+
+template <class Info> CryptoInfo decodeCryptoInfo(const void* optval, socklen_t optlen) {
+  Info info;
+  EXPECT_EQ(sizeof(info), optlen);
+  memcpy(&info, optval, std::min<size_t>(sizeof(info), optlen));
+  const auto bytes = [](const unsigned char* data, size_t length) {
+    return std::string(reinterpret_cast<const char*>(data), length);
+  };
+  CryptoInfo decoded{info.info.version, info.info.cipher_type, bytes(info.key, sizeof(info.key)),
+                     bytes(info.salt, sizeof(info.salt)) + bytes(info.iv, sizeof(info.iv)), 0};
+  for (unsigned char byte : info.rec_seq) {
+    decoded.sequence_ = decoded.sequence_ << 8 | byte;
+  }
+  return decoded;
+}
+
+CryptoInfo decodeCryptoInfo(const void* optval, socklen_t optlen) {
+  tls_crypto_info header;
+  memcpy(&header, optval, sizeof(header));
+  switch (header.cipher_type) {
+  case TLS_CIPHER_AES_GCM_128:
+    return decodeCryptoInfo<tls12_crypto_info_aes_gcm_128>(optval, optlen);
+  case TLS_CIPHER_AES_GCM_256:
+    return decodeCryptoInfo<tls12_crypto_info_aes_gcm_256>(optval, optlen);
+  case TLS_CIPHER_CHACHA20_POLY1305:
+    return decodeCryptoInfo<tls12_crypto_info_chacha20_poly1305>(optval, optlen);
+  default:
+    ADD_FAILURE() << "unexpected cipher type " << header.cipher_type;
+    return {};
+  }
+}
+
+// Seals and opens application data records with the crypto_info of a direction, the way the
+// kernel does, RFC 5246 section 6.2.3.3, RFC 5288 section 3 and RFC 8446 section 5.
+class RecordProtection {
+public:
+  explicit RecordProtection(const CryptoInfo& info) : info_(info) {
+    const EVP_AEAD* aead = aeadOf(info.cipher_type_);
+    EXPECT_EQ(info.key_.size(), EVP_AEAD_key_length(aead));
+    EXPECT_EQ(1, EVP_AEAD_CTX_init(ctx_.get(), aead,
+                                   reinterpret_cast<const uint8_t*>(info.key_.data()),
+                                   info.key_.size(), EVP_AEAD_DEFAULT_TAG_LENGTH, nullptr));
+  }
+
+  std::string seal(absl::string_view plaintext) {
+    const std::string explicit_nonce = explicitNonce() ? bigEndian(info_.sequence_, 8) : "";
+    const std::string inner = tls13() ? absl::StrCat(plaintext, "\x17") : std::string(plaintext);
+    std::string ciphertext(inner.size() + EVP_AEAD_max_overhead(EVP_AEAD_CTX_aead(ctx_.get())),
+                           '\0');
+    const std::string header = recordHeader(explicit_nonce.size() + ciphertext.size());
+    const std::string aad = tls13() ? header : tls12AdditionalData(plaintext.size());
+    const std::string nonce = recordNonce(explicit_nonce);
+    size_t length;
+    EXPECT_EQ(1, EVP_AEAD_CTX_seal(ctx_.get(), reinterpret_cast<uint8_t*>(ciphertext.data()),
+                                   &length, ciphertext.size(),
+                                   reinterpret_cast<const uint8_t*>(nonce.data()), nonce.size(),
+                                   reinterpret_cast<const uint8_t*>(inner.data()), inner.size(),
+                                   reinterpret_cast<const uint8_t*>(aad.data()), aad.size()));
+    ciphertext.resize(length);
+    info_.sequence_++;
+    return absl::StrCat(header, explicit_nonce, ciphertext);
+  }
+
+  std::string open(absl::string_view record) {
+    absl::string_view ciphertext = record.substr(5);
+    const std::string explicit_nonce(explicitNonce() ? ciphertext.substr(0, 8) : "");
+    ciphertext.remove_prefix(explicit_nonce.size());
+    const size_t tag_length = EVP_AEAD_max_overhead(EVP_AEAD_CTX_aead(ctx_.get()));
+    const std::string aad = tls13() ? std::string(record.substr(0, 5))
+                                    : tls12AdditionalData(ciphertext.size() - tag_length);
+    const std::string nonce = recordNonce(explicit_nonce);
+    std::string plaintext(ciphertext.size(), '\0');
+    size_t length = 0;
+    EXPECT_EQ(1, EVP_AEAD_CTX_open(ctx_.get(), reinterpret_cast<uint8_t*>(plaintext.data()),
+                                   &length, plaintext.size(),
+                                   reinterpret_cast<const uint8_t*>(nonce.data()), nonce.size(),
+                                   reinterpret_cast<const uint8_t*>(ciphertext.data()),
+                                   ciphertext.size(),
+                                   reinterpret_cast<const uint8_t*>(aad.data()), aad.size()));
+    plaintext.resize(length);
+    if (tls13() && !plaintext.empty()) {
+      EXPECT_EQ(KernelTls::ApplicationDataRecordType, static_cast<uint8_t>(plaintext.back()));
+      plaintext.pop_back();
+    }
+    info_.sequence_++;
+    return plaintext;
+  }
+
+private:
+  static const EVP_AEAD* aeadOf(uint16_t cipher_type) {
+    switch (cipher_type) {
+    case TLS_CIPHER_AES_GCM_128:
+      return EVP_aead_aes_128_gcm();
+    case TLS_CIPHER_AES_GCM_256:
+      return EVP_aead_aes_256_gcm();
+    default:
+      return EVP_aead_chacha20_poly1305();
+    }
+  }
+
+  bool tls13() const { return info_.version_ == TLS1_3_VERSION; }
+
+  // Only AES-GCM in TLSv1.2 sends a part of the nonce in the records.
+  bool explicitNonce() const {
+    return !tls13() && info_.cipher_type_ != TLS_CIPHER_CHACHA20_POLY1305;
+  }
+
+  std::string recordNonce(absl::string_view explicit_nonce) const {
+    if (explicitNonce()) {
+      return absl::StrCat(info_.nonce_.substr(0, TLS_CIPHER_AES_GCM_128_SALT_SIZE), explicit_nonce);
+    }
+    std::string nonce = info_.nonce_;
+    const std::string sequence = bigEndian(info_.sequence_, 8);
+    for (size_t i = 0; i < sequence.size(); i++) {
+      nonce[nonce.size() - sequence.size() + i] ^= sequence[i];
+    }
+    return nonce;
+  }
+
+  static std::string recordHeader(size_t length) {
+    return absl::StrCat(std::string(1, KernelTls::ApplicationDataRecordType), "\x03\x03",
+                        bigEndian(length, 2));
+  }
+
+  std::string tls12AdditionalData(size_t plaintext_length) const {
+    return absl::StrCat(bigEndian(info_.sequence_, 8), recordHeader(plaintext_length));
+  }
+
+  CryptoInfo info_;
+  bssl::ScopedEVP_AEAD_CTX ctx_;
+};
+
+// A TLS connection over TCP on the loopback interface, whose both ends are driven with BoringSSL
+// until the test hands the server end to the kernel.
+class KernelTlsTest : public testing::Test {
+protected:
+  void connect(uint16_t version, const std::string& cipher_list) {
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listen_fd, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    ASSERT_EQ(0, ::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length));
+    ASSERT_EQ(0, ::listen(listen_fd, 1));
+    ASSERT_EQ(0, ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length));
+    client_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(client_fd_, 0);
+    ASSERT_EQ(0, ::connect(client_fd_, reinterpret_cast<sockaddr*>(&address), address_length));
+    ASSERT_EQ(0, ::fcntl(client_fd_, F_SETFL, O_NONBLOCK));
+    const int server_fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+    ::close(listen_fd);
+    ASSERT_GE(server_fd, 0);
+    server_handle_ = std::make_unique<Network::IoSocketHandleImpl>(server_fd);
+
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    ASSERT_EQ(1, SSL_CTX_use_certificate_chain_file(server_ctx_.get(),
+                                                    testDataPath("san_dns_cert.pem").c_str()));
+    ASSERT_EQ(1, SSL_CTX_use_PrivateKey_file(
+                     server_ctx_.get(), testDataPath("san_dns_key.pem").c_str(), SSL_FILETYPE_PEM));
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    for (SSL_CTX* ctx : {server_ctx_.get(), client_ctx_.get()}) {
+      ASSERT_EQ(1, SSL_CTX_set_min_proto_version(ctx, version));
+      ASSERT_EQ(1, SSL_CTX_set_max_proto_version(ctx, version));
+      if (!cipher_list.empty()) {
+        ASSERT_EQ(1, SSL_CTX_set_strict_cipher_list(ctx, cipher_list.c_str()));
+      }
+    }
+
+    server_ssl_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(server_ssl_.get(), server_fd);
+    SSL_set_accept_state(server_ssl_.get());
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(client_ssl_.get(), client_fd_);
+    SSL_set_connect_state(client_ssl_.get());
+
+    for (int i = 0; i < 50; i++) {
+      const int client_rc = SSL_do_handshake(client_ssl_.get());
+      const int server_rc = SSL_do_handshake(server_ssl_.get());
+      if (client_rc == 1 && server_rc == 1) {
+        return;
+      }
+      for (auto [ssl, rc] : {std::make_pair(client_ssl_.get(), client_rc),
+                             std::make_pair(server_ssl_.get(), server_rc)}) {
+        const int error = SSL_get_error(ssl, rc);
+        ASSERT_TRUE(rc == 1 || error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE)
+            << ERR_reason_error_string(ERR_get_error());
+      }
+    }
+    FAIL() << "handshake did not complete";
+  }
+
+  void TearDown() override {
+    if (client_fd_ >= 0) {
+      ::close(client_fd_);
+    }
+  }
+
+  static void waitReadable(int fd) {
+    pollfd poll_fd{fd, POLLIN, 0};
+    ASSERT_EQ(1, ::poll(&poll_fd, 1, 5000));
+  }
+
+  // Reads the given number of bytes of application data from the server end.
+  std::string serverRead(size_t length) {
+    std::string data(length, '\0');
+    size_t offset = 0;
+    while (offset < length) {
+      waitReadable(server_handle_->fdDoNotUse());
+      uint8_t record_type;
+      const Api::SysCallSizeResult result = KernelTls::read(
+          *server_handle_, {data.data() + offset, length - offset}, record_type);
+      EXPECT_GT(result.return_value_, 0) << result.errno_;
+      EXPECT_EQ(KernelTls::ApplicationDataRecordType, record_type);
+      if (result.return_value_ <= 0) {
+        break;
+      }
+      offset += result.return_value_;
+    }
+    return data;
+  }
+
+  // Reads the given number of bytes of application data from the client end.
+  std::string clientRead(size_t length) {
+    std::string data(length, '\0');
+    size_t offset = 0;
+    while (offset < length) {
+      const int rc = SSL_read(client_ssl_.get(), data.data() + offset, length - offset);
+      if (rc > 0) {
+        offset += rc;
+        continue;
+      }
+      EXPECT_EQ(SSL_ERROR_WANT_READ, SSL_get_error(client_ssl_.get(), rc));
+      if (SSL_get_error(client_ssl_.get(), rc) != SSL_ERROR_WANT_READ) {
+        break;
+      }
+      waitReadable(client_fd_);
+    }
+    return data;
+  }
+
+  // Reads a record from the socket of the server end, undecrypted.
+  std::string serverReadRecord() {
+    const int fd = server_handle_->fdDoNotUse();
+    const auto receive = [fd](char* data, size_t length) {
+      while (length > 0) {
+        waitReadable(fd);
+        const ssize_t rc = ::recv(fd, data, length, 0);
+        EXPECT_GT(rc, 0) << errno;
+        if (rc <= 0) {
+          return;
+        }
+        data += rc;
+        length -= rc;
+      }
+    };
+    std::string record(5, '\0');
+    receive(record.data(), record.size());
+    record.resize(5 + (static_cast<uint8_t>(record[3]) << 8 | static_cast<uint8_t>(record[4])));
+    receive(record.data() + 5, record.size() - 5);
+    return record;
+  }
+
+  int client_fd_{-1};
+  Network::IoHandlePtr server_handle_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+};
+
+class KernelTlsCipherTest
+    : public KernelTlsTest,
+      public testing::WithParamInterface<std::tuple<uint16_t, std::string>> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    Ciphers, KernelTlsCipherTest,
+    testing::Values(std::make_tuple(TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256"),
+                    std::make_tuple(TLS1_2_VERSION, "ECDHE-RSA-AES256-GCM-SHA384"),
+                    std::make_tuple(TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305"),
+                    // The TLSv1.3 cipher can't be configured.
+                    std::make_tuple(TLS1_3_VERSION, "")));
+
+// The keys that the server end hands to the kernel interoperate with the client end, which stays
+// in BoringSSL, in both directions and across several records.
+TEST_P(KernelTlsCipherTest, ExchangeData) {
+  ASSERT_NO_FATAL_FAILURE(connect(std::get<0>(GetParam()), std::get<1>(GetParam())));
+  const absl::Status status = KernelTls::enable(server_ssl_.get(), *server_handle_);
+  if (!status.ok()) {
+    // The tls kernel module, or its support for the cipher, isn't available everywhere.
+    ASSERT_TRUE(absl::IsFailedPrecondition(status)) << status;
+    ASSERT_FALSE(kernelTlsExpected()) << status;
+    GTEST_SKIP() << status;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    const std::string request = absl::StrCat("request ", i);
+    ASSERT_EQ(static_cast<int>(request.size()),
+              SSL_write(client_ssl_.get(), request.data(), request.size()));
+    EXPECT_EQ(request, serverRead(request.size()));
+
+    // More than a record, and less than the socket buffers.
+    const std::string response(20000, 'a' + i);
+    Buffer::OwnedImpl response_buffer(response);
+    while (response_buffer.length() > 0) {
+      ASSERT_TRUE(server_handle_->write(response_buffer).ok());
+    }
+    EXPECT_EQ(response, clientRead(response.size()));
+  }
+}
+
+TEST_P(KernelTlsCipherTest, CloseNotify) {
+  ASSERT_NO_FATAL_FAILURE(connect(std::get<0>(GetParam()), std::get<1>(GetParam())));
+  const absl::Status status = KernelTls::enable(server_ssl_.get(), *server_handle_);
+  if (!status.ok()) {
+    ASSERT_TRUE(absl::IsFailedPrecondition(status)) << status;
+    ASSERT_FALSE(kernelTlsExpected()) << status;
+    GTEST_SKIP() << status;
+  }
+
+  EXPECT_EQ(2, KernelTls::sendCloseNotify(*server_handle_).return_value_);
+  char byte;
+  int rc;
+  while ((rc = SSL_read(client_ssl_.get(), &byte, 1)) < 0 &&
+         SSL_get_error(client_ssl_.get(), rc) == SSL_ERROR_WANT_READ) {
+    waitReadable(client_fd_);
+  }
+  EXPECT_EQ(SSL_ERROR_ZERO_RETURN, SSL_get_error(client_ssl_.get(), rc));
+
+  SSL_shutdown(client_ssl_.get());
+  waitReadable(server_handle_->fdDoNotUse());
+  uint8_t alert[2];
+  uint8_t record_type;
+  EXPECT_EQ(2, KernelTls::read(*server_handle_, {alert, sizeof(alert)}, record_type).return_value_);
+  EXPECT_EQ(KernelTls::AlertRecordType, record_type);
+  EXPECT_EQ(SSL_AD_CLOSE_NOTIFY, alert[1]);
+}
+
+// The keys handed to the kernel are checked without the tls kernel module, by protecting the
+// records of the connection with the crypto_info that the mocked setsockopt() receives.
+TEST_P(KernelTlsCipherTest, CryptoInfo) {
+  ASSERT_NO_FATAL_FAILURE(connect(std::get<0>(GetParam()), std::get<1>(GetParam())));
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  const int fd = server_handle_->fdDoNotUse();
+  CryptoInfo read_info;
+  CryptoInfo write_info;
+  const auto capture = [](CryptoInfo& info) {
+    return Invoke([&info](os_fd_t, int, int, const void* optval, socklen_t optlen) {
+      info = decodeCryptoInfo(optval, optlen);
+      return 0;
+    });
+  };
+  {
+    testing::InSequence s;
+    EXPECT_CALL(os_sys_calls, setsockopt_(fd, IPPROTO_TCP, TCP_ULP, _, _));
+    EXPECT_CALL(os_sys_calls, setsockopt_(fd, SOL_TLS, TLS_RX, _, _))
+        .WillOnce(capture(read_info));
+    EXPECT_CALL(os_sys_calls, setsockopt_(fd, SOL_TLS, TLS_TX, _, _))
+        .WillOnce(capture(write_info));
+  }
+  const absl::Status status = KernelTls::enable(server_ssl_.get(), *server_handle_);
+  ASSERT_TRUE(status.ok()) << status;
+
+  const uint16_t version = std::get<0>(GetParam());
+  EXPECT_EQ(version, read_info.version_);
+  EXPECT_EQ(version, write_info.version_);
+  EXPECT_EQ(read_info.cipher_type_, write_info.cipher_type_);
+  RecordProtection read_protection(read_info);
+  RecordProtection write_protection(write_info);
+  for (int i = 0; i < 3; i++) {
+    const std::string request = absl::StrCat("request ", i);
+    ASSERT_EQ(static_cast<int>(request.size()),
+              SSL_write(client_ssl_.get(), request.data(), request.size()));
+    EXPECT_EQ(request, read_protection.open(serverReadRecord()));
+
+    const std::string response = absl::StrCat("response ", i);
+    const std::string record = write_protection.seal(response);
+    ASSERT_EQ(static_cast<ssize_t>(record.size()), ::send(fd, record.data(), record.size(), 0));
+    EXPECT_EQ(response, clientRead(response.size()));
+  }
+}
+
+// A connection with a cipher that the kernel doesn't support keeps working with BoringSSL.
+TEST_F(KernelTlsTest, UnsupportedCipher) {
+  ASSERT_NO_FATAL_FAILURE(connect(TLS1_2_VERSION, "ECDHE-RSA-AES128-SHA"));
+  const absl::Status status = KernelTls::enable(server_ssl_.get(), *server_handle_);
+  EXPECT_TRUE(absl::IsFailedPrecondition(status));
+  EXPECT_EQ("unsupported cipher ECDHE-RSA-AES128-SHA", status.message());
+
+  const std::string request = "request";
+  ASSERT_EQ(static_cast<int>(request.size()),
+            SSL_write(client_ssl_.get(), request.data(), request.size()));
+  waitReadable(server_handle_->fdDoNotUse());
+  char data[16];
+  EXPECT_EQ(static_cast<int>(request.size()), SSL_read(server_ssl_.get(), data, sizeof(data)));
+  EXPECT_EQ(request, absl::string_view(data, request.size()));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
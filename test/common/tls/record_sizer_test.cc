@@ -0,0 +1,56 @@
+#include <chrono>
+
+#include "source/common/tls/record_sizer.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class RecordSizerTest : public testing::Test {
+protected:
+  Event::SimulatedTimeSystem time_system_;
+  RecordSizer sizer_{{1400, 4000, std::chrono::milliseconds(1000)}, time_system_};
+};
+
+// Records grow to full size once the configured number of bytes was written in small records.
+TEST_F(RecordSizerTest, GrowsAfterSmallRecordBytes) {
+  EXPECT_EQ(1400, sizer_.recordSize());
+  sizer_.onRecordWritten(1400);
+  sizer_.onRecordWritten(1400);
+  EXPECT_EQ(1400, sizer_.recordSize());
+  sizer_.onRecordWritten(1400);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer_.recordSize());
+  sizer_.onRecordWritten(RecordSizer::MaxRecordSize);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer_.recordSize());
+}
+
+// Records go back to small after the connection was idle, and only then.
+TEST_F(RecordSizerTest, ResetsAfterIdleTimeout) {
+  for (int i = 0; i < 3; i++) {
+    sizer_.onRecordWritten(1400);
+  }
+  time_system_.advanceTimeWait(std::chrono::milliseconds(999));
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer_.recordSize());
+  sizer_.onRecordWritten(RecordSizer::MaxRecordSize);
+
+  // The idle period starts over with each write.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(999));
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer_.recordSize());
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(1));
+  EXPECT_EQ(1400, sizer_.recordSize());
+  sizer_.onRecordWritten(1400);
+  EXPECT_EQ(1400, sizer_.recordSize());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
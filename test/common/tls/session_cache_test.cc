@@ -0,0 +1,145 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/tls/session_cache.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class SessionCacheTest : public testing::Test {
+public:
+  // Creates a TLSv1.2 server context without session tickets, so that sessions are resumed by ID.
+  bssl::UniquePtr<SSL_CTX> createServerContext(SessionCacheSharedPtr cache) {
+    bssl::UniquePtr<SSL_CTX> ctx(SSL_CTX_new(TLS_method()));
+    const std::string cert_path =
+        TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+    const std::string key_path =
+        TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+    EXPECT_EQ(1, SSL_CTX_use_certificate_file(ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM));
+    EXPECT_EQ(1, SSL_CTX_use_PrivateKey_file(ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM));
+    EXPECT_EQ(1, SSL_CTX_set_max_proto_version(ctx.get(), TLS1_2_VERSION));
+    SSL_CTX_set_options(ctx.get(), SSL_OP_NO_TICKET);
+    static const uint8_t session_id_context[] = {'t', 'e', 's', 't'};
+    EXPECT_EQ(1, SSL_CTX_set_session_id_context(ctx.get(), session_id_context,
+                                                sizeof(session_id_context)));
+    if (cache != nullptr) {
+      SessionCache::attach(std::move(cache), ctx.get());
+    }
+    return ctx;
+  }
+
+  // Completes a handshake with the server context over a BIO pair, offering the session if it is
+  // not null. Returns the session of the handshake.
+  bssl::UniquePtr<SSL_SESSION> handshake(SSL_CTX* server_ctx, SSL_SESSION* session,
+                                         bool& reused) {
+    bssl::UniquePtr<SSL> client(SSL_new(client_ctx_.get()));
+    bssl::UniquePtr<SSL> server(SSL_new(server_ctx));
+    BIO* client_bio;
+    BIO* server_bio;
+    EXPECT_EQ(1, BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client.get(), client_bio, client_bio);
+    SSL_set_bio(server.get(), server_bio, server_bio);
+    SSL_set_connect_state(client.get());
+    SSL_set_accept_state(server.get());
+    if (session != nullptr) {
+      SSL_set_session(client.get(), session);
+    }
+
+    bool done = false;
+    for (int i = 0; i < 10 && !done; i++) {
+      const int client_rc = SSL_do_handshake(client.get());
+      const int server_rc = SSL_do_handshake(server.get());
+      done = client_rc == 1 && server_rc == 1;
+    }
+    EXPECT_TRUE(done);
+    reused = SSL_session_reused(server.get());
+    return bssl::UniquePtr<SSL_SESSION>(SSL_get1_session(client.get()));
+  }
+
+  bssl::UniquePtr<SSL_CTX> client_ctx_{SSL_CTX_new(TLS_method())};
+};
+
+// Verify sessions established through a context are resumed through a context that replaces it.
+TEST_F(SessionCacheTest, ResumesAcrossContexts) {
+  auto cache = std::make_shared<SessionCache>(100);
+  auto server_ctx = createServerContext(cache);
+
+  bool reused;
+  bssl::UniquePtr<SSL_SESSION> session = handshake(server_ctx.get(), nullptr, reused);
+  EXPECT_FALSE(reused);
+  EXPECT_EQ(1U, cache->size());
+
+  server_ctx = createServerContext(cache);
+  handshake(server_ctx.get(), session.get(), reused);
+  EXPECT_TRUE(reused);
+
+  // A context with its own internal cache does not know the session.
+  server_ctx = createServerContext(nullptr);
+  handshake(server_ctx.get(), session.get(), reused);
+  EXPECT_FALSE(reused);
+}
+
+// Verify the cache keeps the most recently used sessions once it is full.
+TEST_F(SessionCacheTest, EvictsLeastRecentlyUsed) {
+  auto cache = std::make_shared<SessionCache>(1);
+  auto server_ctx = createServerContext(cache);
+
+  bool reused;
+  bssl::UniquePtr<SSL_SESSION> first = handshake(server_ctx.get(), nullptr, reused);
+  for (int i = 0; i < 200; i++) {
+    handshake(server_ctx.get(), nullptr, reused);
+  }
+  EXPECT_EQ(1U, cache->size());
+
+  bssl::UniquePtr<SSL_SESSION> last = handshake(server_ctx.get(), nullptr, reused);
+  handshake(server_ctx.get(), last.get(), reused);
+  EXPECT_TRUE(reused);
+  handshake(server_ctx.get(), first.get(), reused);
+  EXPECT_FALSE(reused);
+}
+
+// Verify the sessions do not evict each other while the cache has room for all of them.
+TEST_F(SessionCacheTest, KeepsSessionsWithinBound) {
+  auto cache = std::make_shared<SessionCache>(20);
+  auto server_ctx = createServerContext(cache);
+
+  bool reused;
+  std::vector<bssl::UniquePtr<SSL_SESSION>> sessions;
+  for (int i = 0; i < 20; i++) {
+    sessions.push_back(handshake(server_ctx.get(), nullptr, reused));
+  }
+  EXPECT_EQ(20U, cache->size());
+
+  for (const auto& session : sessions) {
+    handshake(server_ctx.get(), session.get(), reused);
+    EXPECT_TRUE(reused);
+  }
+}
+
+TEST(SessionCacheRegistryTest, SharedBySessionIdContext) {
+  SessionCacheRegistry registry;
+  SessionCacheSharedPtr cache = registry.getOrCreate("a", 10);
+  EXPECT_EQ(cache, registry.getOrCreate("a", 10));
+  EXPECT_NE(cache, registry.getOrCreate("b", 10));
+
+  // The registry does not keep the caches alive.
+  std::weak_ptr<SessionCache> released = cache;
+  cache.reset();
+  EXPECT_TRUE(released.expired());
+  EXPECT_NE(nullptr, registry.getOrCreate("a", 10));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -3732,6 +3732,100 @@ TEST_P(SslSocketTest, HalfClose) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// With dynamic record sizing, the server writes the start of a response in records that fit in a
+// TCP segment.
+TEST_P(SslSocketTest, DynamicRecordSizing) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+  dynamic_record_sizing: {}
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = *ServerContextConfigImpl::create(server_tls_context, factory_context_, false);
+  NiceMock<Server::Configuration::MockServerFactoryContext> server_factory_context;
+  ContextManagerImpl manager(server_factory_context);
+  Stats::TestUtil::TestStore server_stats_store;
+  auto server_ssl_socket_factory = *ServerSslSocketFactory::create(
+      std::move(server_cfg), manager, *server_stats_store.rootScope(), std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+      Network::Test::getCanonicalLoopbackAddress(version_));
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  Server::ThreadLocalOverloadStateOptRef overload_state;
+  Network::ListenerPtr listener = createListener(socket, listener_callbacks, runtime_,
+                                                 listener_config, overload_state, *dispatcher_);
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  auto client_cfg = *ClientContextConfigImpl::create(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  auto client_ssl_socket_factory = *ClientSslSocketFactory::create(std::move(client_cfg), manager,
+                                                                   *client_stats_store.rootScope());
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->connectionInfoProvider().localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory->createTransportSocket(nullptr, nullptr), nullptr, nullptr);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+
+  // The ciphertext lengths of the records that the server writes.
+  std::vector<uint16_t> record_lengths;
+  const uint64_t response_size = 64 * 1024;
+  Network::ConnectionPtr server_connection;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory->createDownstreamTransportSocket(),
+            stream_info_);
+        SSL* ssl = dynamic_cast<const SslHandshakerImpl*>(server_connection->ssl().get())->ssl();
+        SSL_set_msg_callback(ssl, [](int is_write, int, int content_type, const void* buf,
+                                     size_t len, SSL* ssl, void* arg) {
+          // The handshake records, such as the one of the certificate, are left out.
+          if (is_write && content_type == SSL3_RT_HEADER && len == SSL3_RT_HEADER_LENGTH &&
+              !SSL_in_init(ssl)) {
+            const uint8_t* header = static_cast<const uint8_t*>(buf);
+            static_cast<std::vector<uint16_t>*>(arg)->push_back(
+                static_cast<uint16_t>(header[3] << 8 | header[4]));
+          }
+        });
+        SSL_set_msg_callback_arg(ssl, &record_lengths);
+        Buffer::OwnedImpl data(std::string(response_size, 'a'));
+        server_connection->write(data, false);
+      }));
+  EXPECT_CALL(listener_callbacks, recordConnectionsAcceptedOnSocketEvent(_));
+
+  uint64_t bytes_received = 0;
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(*client_read_filter, onData(_, false))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) -> Network::FilterStatus {
+        bytes_received += data.length();
+        data.drain(data.length());
+        if (bytes_received == response_size) {
+          dispatcher_->exit();
+        }
+        return Network::FilterStatus::StopIteration;
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(response_size, bytes_received);
+  // At least one record per 1400 bytes of the response, and no record larger than a segment.
+  EXPECT_GE(record_lengths.size(), response_size / 1400);
+  for (const uint16_t length : record_lengths) {
+    EXPECT_LT(length, 1460);
+  }
+
+  client_connection->close(Network::ConnectionCloseType::NoFlush);
+  server_connection->close(Network::ConnectionCloseType::NoFlush);
+}
+
 TEST_P(SslSocketTest, ShutdownWithCloseNotify) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -4723,6 +4817,30 @@ TEST_P(SslSocketTest, TicketSessionResumptionDifferentServerCertDifferentSAN) {
                               version_);
 }
 
+// Verify a server context built again through the context manager from the same config, as on a
+// secret update, resumes the sessions of the first context from the shared session cache.
+TEST_P(SslSocketTest, SharedSessionCacheResumptionAcrossContexts) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/common/tls/test_data/unittest_key.pem"
+  disable_stateless_session_resumption: true
+  shared_session_cache_size: 100
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              version_);
+}
+
 TEST_P(SslSocketTest, SessionResumptionDisabled) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -6642,7 +6760,7 @@ protected:
   Stats::TestUtil::TestStore client_stats_store_;
   std::shared_ptr<Network::Test::TcpListenSocketImmediateListen> socket_;
   Network::MockTcpListenerCallbacks listener_callbacks_;
-  const std::string server_ctx_yaml_ = R"EOF(
+  std::string server_ctx_yaml_ = R"EOF(
   common_tls_context:
     tls_certificates:
       certificate_chain:
@@ -6698,6 +6816,27 @@ TEST_P(SslReadBufferLimitTest, SomeLimit) {
   readBufferLimitTest(32 * 1024, 32 * 1024, 256 * 1024, 1, false);
 }
 
+// The server hands the record layer to the kernel where the tls kernel module is available, and
+// keeps it in BoringSSL otherwise. Either way, the data and the close_notify alert go through.
+TEST_P(SslReadBufferLimitTest, KernelTlsOffload) {
+  server_ctx_yaml_ += "  kernel_tls_offload: true\n";
+  readBufferLimitTest(0, 256 * 1024, 256 * 1024, 1, false);
+  EXPECT_EQ(1UL, server_stats_store_.counter("ssl.kernel_tls_offload").value() +
+                     server_stats_store_.counter("ssl.kernel_tls_offload_fallback").value());
+}
+
+// Hosts with the tls kernel module set ENVOY_KTLS_AVAILABLE, where the server must not fall back to
+// BoringSSL.
+TEST_P(SslReadBufferLimitTest, KernelTlsOffloadWithoutFallback) {
+  if (!TestEnvironment::getOptionalEnvVar("ENVOY_KTLS_AVAILABLE").has_value()) {
+    GTEST_SKIP() << "ENVOY_KTLS_AVAILABLE is not set";
+  }
+  server_ctx_yaml_ += "  kernel_tls_offload: true\n";
+  readBufferLimitTest(0, 256 * 1024, 256 * 1024, 1, false);
+  EXPECT_EQ(1UL, server_stats_store_.counter("ssl.kernel_tls_offload").value());
+  EXPECT_EQ(0UL, server_stats_store_.counter("ssl.kernel_tls_offload_fallback").value());
+}
+
 TEST_P(SslReadBufferLimitTest, WritesSmallerThanBufferLimit) { singleWriteTest(5 * 1024, 1024); }
 
 TEST_P(SslReadBufferLimitTest, WritesLargerThanBufferLimit) { singleWriteTest(1024, 5 * 1024); }
@@ -1,6 +1,16 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/tls/kernel_tls.h"
+#include "source/common/tls/record_sizer.h"
+#include "source/common/tls/session_cache.h"
 
 #include "test/test_common/environment.h"
+#include "test/test_common/test_time.h"
 
 #include "benchmark/benchmark.h"
 #include "openssl/ssl.h"
@@ -192,5 +202,318 @@ static void testParams(benchmark::internal::Benchmark* b) {
 
 BENCHMARK(testThroughput)->Unit(::benchmark::kMicrosecond)->Apply(testParams);
 
+// Creates a TLSv1.2 server context without session tickets, so that sessions are resumed by ID.
+// The context uses the shared session cache if it is not null, and its internal cache otherwise.
+static bssl::UniquePtr<SSL_CTX> createServerContext(SessionCacheSharedPtr session_cache) {
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  std::string cert_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+  std::string key_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+  err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+  SSL_CTX_set_max_proto_version(server_ctx.get(), TLS1_2_VERSION);
+  SSL_CTX_set_options(server_ctx.get(), SSL_OP_NO_TICKET);
+  static const uint8_t session_id_context[] = {'b', 'e', 'n', 'c', 'h'};
+  SSL_CTX_set_session_id_context(server_ctx.get(), session_id_context,
+                                 sizeof(session_id_context));
+  if (session_cache != nullptr) {
+    SessionCache::attach(std::move(session_cache), server_ctx.get());
+  }
+  return server_ctx;
+}
+
+// Measures the handshake rate of clients that resume their previous session, with the server
+// session cache given by the first argument (0 for no resumption, 1 for the internal cache of the
+// context, 2 for the shared session cache), and the server context rebuilt, as on a secret update,
+// every number of handshakes given by the second argument.
+static void testHandshakes(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const unsigned cache_mode = state.range(0);
+  const unsigned handshakes_per_context = state.range(1);
+  constexpr unsigned num_clients = 64;
+
+  SessionCacheSharedPtr session_cache =
+      cache_mode == 2 ? std::make_shared<SessionCache>(10000) : nullptr;
+  bssl::UniquePtr<SSL_CTX> server_ctx = createServerContext(session_cache);
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  std::vector<bssl::UniquePtr<SSL_SESSION>> client_sessions(num_clients);
+
+  uint64_t handshakes = 0;
+  uint64_t resumed = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    if (handshakes > 0 && handshakes % handshakes_per_context == 0) {
+      state.PauseTiming();
+      server_ctx = createServerContext(session_cache);
+      state.ResumeTiming();
+    }
+
+    bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+    bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+    BIO* client_bio;
+    BIO* server_bio;
+    RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0) == 1, "BIO_new_bio_pair");
+    SSL_set_bio(client_ssl.get(), client_bio, client_bio);
+    SSL_set_bio(server_ssl.get(), server_bio, server_bio);
+    SSL_set_accept_state(server_ssl.get());
+    SSL_set_connect_state(client_ssl.get());
+    bssl::UniquePtr<SSL_SESSION>& client_session = client_sessions[handshakes % num_clients];
+    if (cache_mode != 0 && client_session != nullptr) {
+      SSL_set_session(client_ssl.get(), client_session.get());
+    }
+
+    bool handshake_success = false;
+    for (int i = 0; i < 10; i++) {
+      int client_err = SSL_do_handshake(client_ssl.get());
+      int server_err = SSL_do_handshake(server_ssl.get());
+      if (client_err == 1 && server_err == 1) {
+        handshake_success = true;
+        break;
+      }
+      handleSslError(client_ssl.get(), client_err, false);
+      handleSslError(server_ssl.get(), server_err, true);
+    }
+    RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+
+    resumed += SSL_session_reused(server_ssl.get());
+    client_session.reset(SSL_get1_session(client_ssl.get()));
+    ++handshakes;
+  }
+  state.counters["handshakes"] = benchmark::Counter(handshakes, benchmark::Counter::kIsRate);
+  state.counters["resumed_per_handshake"] = static_cast<double>(resumed) / handshakes;
+}
+
+BENCHMARK(testHandshakes)
+    ->Unit(::benchmark::kMicrosecond)
+    ->ArgsProduct({{0, 1, 2}, {100, 1000000}});
+
+// Returns the CPU time that the process spent in user and kernel mode, in seconds.
+static double cpuSeconds() {
+  rusage usage;
+  RELEASE_ASSERT(getrusage(RUSAGE_SELF, &usage) == 0, "getrusage");
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// Measures the throughput of a TLS connection over TCP on the loopback interface, and the CPU time
+// that both of its ends spend per GB, with the record layer in BoringSSL when the argument is 0,
+// and handed to the kernel otherwise. The kernel encrypts and decrypts in the socket calls, so the
+// CPU time includes the time spent in the kernel.
+static void testKernelTlsThroughput(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const bool kernel_tls = state.range(0) != 0;
+  constexpr uint64_t bytes_per_iteration = 1024 * 1024;
+
+  const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_length = sizeof(address);
+  RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0 &&
+                     ::listen(listen_fd, 1) == 0 &&
+                     ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address),
+                                   &address_length) == 0,
+                 "listen");
+  Network::IoSocketHandleImpl client_handle(::socket(AF_INET, SOCK_STREAM, 0));
+  RELEASE_ASSERT(::connect(client_handle.fdDoNotUse(), reinterpret_cast<sockaddr*>(&address),
+                           address_length) == 0,
+                 "connect");
+  ::fcntl(client_handle.fdDoNotUse(), F_SETFL, O_NONBLOCK);
+  Network::IoSocketHandleImpl server_handle(
+      ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK));
+  ::close(listen_fd);
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  std::string cert_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+  std::string key_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+  err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  SSL_set_fd(server_ssl.get(), server_handle.fdDoNotUse());
+  SSL_set_accept_state(server_ssl.get());
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  SSL_set_fd(client_ssl.get(), client_handle.fdDoNotUse());
+  SSL_set_connect_state(client_ssl.get());
+
+  bool handshake_success = false;
+  for (int i = 0; i < 50; i++) {
+    int client_err = SSL_do_handshake(client_ssl.get());
+    int server_err = SSL_do_handshake(server_ssl.get());
+    if (client_err == 1 && server_err == 1) {
+      handshake_success = true;
+      break;
+    }
+    handleSslError(client_ssl.get(), client_err, false);
+    handleSslError(server_ssl.get(), server_err, true);
+  }
+  RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+
+  if (kernel_tls) {
+    for (auto [ssl, handle] :
+         {std::make_pair(client_ssl.get(), &client_handle),
+          std::make_pair(server_ssl.get(), &server_handle)}) {
+      const absl::Status status = KernelTls::enable(ssl, *handle);
+      if (!status.ok()) {
+        state.SkipWithError(std::string(status.message()).c_str());
+        return;
+      }
+    }
+  }
+
+  std::vector<uint8_t> write_buf(16384, 'a');
+  static uint8_t read_buf[1024 * 1024];
+
+  uint64_t bytes_read = 0;
+  const double start_cpu_seconds = cpuSeconds();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    uint64_t bytes_written_this_iteration = 0;
+    uint64_t bytes_read_this_iteration = 0;
+    while (bytes_read_this_iteration < bytes_per_iteration) {
+      // Write until the socket buffers are full, then read what made it to the server.
+      while (bytes_written_this_iteration < bytes_per_iteration) {
+        const size_t len = std::min<uint64_t>(write_buf.size(),
+                                              bytes_per_iteration - bytes_written_this_iteration);
+        const int rc = kernel_tls
+                           ? ::send(client_handle.fdDoNotUse(), write_buf.data(), len, 0)
+                           : SSL_write(client_ssl.get(), write_buf.data(), len);
+        if (rc <= 0) {
+          break;
+        }
+        bytes_written_this_iteration += rc;
+      }
+      const int rc = kernel_tls ? ::recv(server_handle.fdDoNotUse(), read_buf, sizeof(read_buf), 0)
+                                : SSL_read(server_ssl.get(), read_buf, sizeof(read_buf));
+      if (rc > 0) {
+        bytes_read_this_iteration += rc;
+      }
+    }
+    bytes_read += bytes_read_this_iteration;
+  }
+  const double cpu_seconds = cpuSeconds() - start_cpu_seconds;
+  state.counters["throughput"] = benchmark::Counter(bytes_read, benchmark::Counter::kIsRate);
+  state.counters["cpu_seconds_per_gb"] = cpu_seconds / (bytes_read / 1e9);
+}
+
+BENCHMARK(testKernelTlsThroughput)->Unit(::benchmark::kMicrosecond)->Arg(0)->Arg(1);
+
+// Measures the records that the server writes per response, their size, and the throughput, when
+// it sizes them like SslSocket::doWrite() does. The first argument is the size of the small
+// records, or 0 for full size records only, and the second is the size of a response. Each
+// response starts on an idle connection, so it starts with small records again.
+static void testRecordSizing(benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  const uint32_t small_record_size = state.range(0);
+  const uint64_t response_size = state.range(1);
+
+  int sockets[2];
+  socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  std::string cert_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_cert.pem");
+  std::string key_path =
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/tls/test_data/san_dns_key.pem");
+  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+  err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  SSL_set_fd(server_ssl.get(), sockets[0]);
+  SSL_set_accept_state(server_ssl.get());
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  SSL_set_fd(client_ssl.get(), sockets[1]);
+  SSL_set_connect_state(client_ssl.get());
+
+  bool handshake_success = false;
+  for (int i = 0; i < 50; i++) {
+    int client_err = SSL_do_handshake(client_ssl.get());
+    int server_err = SSL_do_handshake(server_ssl.get());
+    if (client_err == 1 && server_err == 1) {
+      handshake_success = true;
+      break;
+    }
+    handleSslError(client_ssl.get(), client_err, false);
+    handleSslError(server_ssl.get(), server_err, true);
+  }
+  RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+
+  Event::TestRealTimeSystem time_system;
+  const Ssl::ServerContextConfig::DynamicRecordSizing config{
+      small_record_size, 1024 * 1024, std::chrono::milliseconds(1000)};
+  static uint8_t read_buf[1024 * 1024];
+
+  uint64_t bytes_written = 0;
+  uint64_t records = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    Buffer::OwnedImpl write_buf;
+    addFullSlices(write_buf, response_size / 16384, false);
+    absl::optional<RecordSizer> sizer;
+    if (small_record_size != 0) {
+      sizer.emplace(config, time_system);
+    }
+    state.ResumeTiming();
+
+    while (write_buf.length() > 0) {
+      const uint64_t len = std::min(
+          write_buf.length(), sizer.has_value() ? sizer->recordSize() : RecordSizer::MaxRecordSize);
+      err = SSL_write(server_ssl.get(), write_buf.linearize(len), len);
+      // Drain the client when the socket buffer is full, and write the same record again.
+      while (err <= 0) {
+        RELEASE_ASSERT(SSL_get_error(server_ssl.get(), err) == SSL_ERROR_WANT_WRITE, "SSL_write");
+        while (SSL_read(client_ssl.get(), read_buf, sizeof(read_buf)) > 0) {
+        }
+        err = SSL_write(server_ssl.get(), write_buf.linearize(len), len);
+      }
+      RELEASE_ASSERT(err == static_cast<int>(len),
+                     absl::StrCat("SSL_write got: ", err, " expected: ", len));
+      write_buf.drain(len);
+      if (sizer.has_value()) {
+        sizer->onRecordWritten(len);
+      }
+      ++records;
+    }
+    while (SSL_read(client_ssl.get(), read_buf, sizeof(read_buf)) > 0) {
+    }
+    bytes_written += response_size;
+  }
+  state.counters["records_per_iteration"] =
+      benchmark::Counter(records, benchmark::Counter::kAvgIterations);
+  state.counters["bytes_per_record"] = static_cast<double>(bytes_written) / records;
+  state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
+
+  ::close(sockets[0]);
+  ::close(sockets[1]);
+}
+
+BENCHMARK(testRecordSizing)
+    ->Unit(::benchmark::kMicrosecond)
+    ->ArgsProduct({{0, 1400, 4096}, {16 * 1024, 256 * 1024, 4 * 1024 * 1024}});
+
 } // namespace Extensions::TransportSockets::Tls
 } // namespace Envoy
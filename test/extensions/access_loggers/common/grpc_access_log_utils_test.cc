@@ -2,7 +2,7 @@
 
 #include "source/common/http/header_map_impl.h"
 #include "source/common/stream_info/filter_state_impl.h"
-#include "source/extensions/access_loggers/grpc/grpc_access_log_utils.h"
+#include "source/extensions/access_loggers/common/grpc_access_log_utils.h"
 
 #if defined(USE_CEL)
 #include "source/extensions/filters/common/expr/cel_state.h"
@@ -267,6 +267,68 @@ TEST_F(StreamingGrpcAccessLogTest, WatermarksOverrun) {
             TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
 }
 
+// Test that batches grow while the stream is backed up and shrink again once it drains.
+TEST_F(StreamingGrpcAccessLogTest, AdaptiveBatching) {
+  InSequence s;
+  const uint64_t entry_size = mockHttpEntry().ByteSizeLong();
+  config_.mutable_max_buffer_size_bytes()->set_value(4 * entry_size);
+  initLogger(FlushInterval, entry_size);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+
+  // The first two flushes are rejected, each doubling the batch size.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  logger_->log(mockHttpEntry());
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  logger_->log(mockHttpEntry());
+  // No flush is attempted until the batch reaches four entries.
+  logger_->log(mockHttpEntry());
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 4);
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(1, logger_->numClears());
+
+  // The batch size halves after each accepted flush.
+  logger_->log(mockHttpEntry());
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 2);
+  logger_->log(mockHttpEntry());
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 1);
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(3, logger_->numClears());
+  EXPECT_EQ(7,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+  EXPECT_EQ(0,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+}
+
+// Test that entries are dropped once the stream has been backed up for long enough to fill the
+// buffer up to its maximum size.
+TEST_F(StreamingGrpcAccessLogTest, AdaptiveBatchingDropsAtMaxBufferSize) {
+  InSequence s;
+  const uint64_t entry_size = mockHttpEntry().ByteSizeLong();
+  config_.mutable_max_buffer_size_bytes()->set_value(2 * entry_size);
+  initLogger(FlushInterval, entry_size);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  logger_->log(mockHttpEntry());
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  logger_->log(mockHttpEntry());
+  // The buffer is full and the stream still can't take the batch.
+  EXPECT_CALL(stream, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_CALL(stream, sendMessageRaw_(_, _)).Times(0);
+  logger_->log(mockHttpEntry());
+  EXPECT_EQ(0, logger_->numClears());
+  EXPECT_EQ(2,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+  EXPECT_EQ(1,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+}
+
 // Test that stream failure is handled correctly.
 TEST_F(StreamingGrpcAccessLogTest, StreamFailure) {
   initLogger(FlushInterval, 0);
@@ -0,0 +1,124 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+
+#include "source/common/formatter/substitution_format_string.h"
+#include "source/common/network/address_impl.h"
+#include "source/extensions/access_loggers/common/file_access_log_impl.h"
+#include "source/extensions/access_loggers/file/binary_access_log_impl.h"
+
+#include "test/common/stream_info/test_util.h"
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/common.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+namespace {
+
+/**
+ * An access log file which only counts what is written to it.
+ */
+class CountingAccessLogFile : public AccessLog::AccessLogFile {
+public:
+  // AccessLog::AccessLogFile
+  void write(absl::string_view data) override { bytes_ += data.size(); }
+  void reopen() override {}
+  void flush() override {}
+
+  uint64_t bytes_{};
+};
+
+// Roughly the same fields as are logged in binary form.
+constexpr absl::string_view JsonLogFormat = R"EOF(
+  start_time: '%START_TIME%'
+  downstream_remote_address: '%DOWNSTREAM_REMOTE_ADDRESS%'
+  downstream_local_address: '%DOWNSTREAM_LOCAL_ADDRESS%'
+  upstream_host: '%UPSTREAM_HOST%'
+  upstream_cluster: '%UPSTREAM_CLUSTER%'
+  route_name: '%ROUTE_NAME%'
+  duration: '%DURATION%'
+  response_flags: '%RESPONSE_FLAGS%'
+  protocol: '%PROTOCOL%'
+  method: '%REQ(:METHOD)%'
+  scheme: '%REQ(:SCHEME)%'
+  authority: '%REQ(:AUTHORITY)%'
+  path: '%REQ(:PATH)%'
+  user_agent: '%REQ(USER-AGENT)%'
+  forwarded_for: '%REQ(X-FORWARDED-FOR)%'
+  request_id: '%REQ(X-REQUEST-ID)%'
+  bytes_received: '%BYTES_RECEIVED%'
+  response_code: '%RESPONSE_CODE%'
+  response_code_details: '%RESPONSE_CODE_DETAILS%'
+  bytes_sent: '%BYTES_SENT%'
+)EOF";
+
+// Logs a typical request with the given logger and reports the bytes written per record.
+void runLogger(::benchmark::State& state, AccessLog::Instance& logger,
+               const CountingAccessLogFile& file) {
+  testing::NiceMock<MockTimeSystem> time_system;
+  TestStreamInfo stream_info(time_system);
+  stream_info.downstream_connection_info_provider_->setRemoteAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("203.0.113.1", 443));
+  stream_info.setResponseCode(200);
+  stream_info.setResponseCodeDetails("via_upstream");
+  stream_info.addBytesReceived(1024);
+  stream_info.addBytesSent(4096);
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"},
+      {":scheme", "https"},
+      {":authority", "www.example.com"},
+      {":path", "/some/path/to/a/resource?with=query"},
+      {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 Chrome/120.0"},
+      {"x-forwarded-for", "203.0.113.1"},
+      {"x-request-id", "2f1c8a4e-6d3b-4f8e-9a7c-5b2d1e0f3a6c"}};
+  Http::TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+
+  uint64_t records = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    logger.log({&request_headers, &response_headers}, stream_info);
+    ++records;
+  }
+  state.SetItemsProcessed(records);
+  state.counters["bytes_per_record"] = static_cast<double>(file.bytes_) / records;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_JsonAccessLog(::benchmark::State& state) {
+  auto file = std::make_shared<CountingAccessLogFile>();
+  testing::NiceMock<AccessLog::MockAccessLogManager> log_manager;
+  ON_CALL(log_manager, createAccessLog(testing::_)).WillByDefault(testing::Return(file));
+
+  ProtobufWkt::Struct json_format;
+  TestUtility::loadFromYaml(std::string(JsonLogFormat), json_format);
+  FileAccessLog logger({Filesystem::DestinationType::File, "/dev/null"}, nullptr,
+                       Formatter::SubstitutionFormatStringUtils::createJsonFormatter(
+                           json_format, true, false, false),
+                       log_manager);
+  runLogger(state, logger, *file);
+}
+BENCHMARK(BM_JsonAccessLog);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_BinaryAccessLog(::benchmark::State& state) {
+  auto file = std::make_shared<CountingAccessLogFile>();
+  testing::NiceMock<AccessLog::MockAccessLogManager> log_manager;
+  ON_CALL(log_manager, createAccessLog(testing::_)).WillByDefault(testing::Return(file));
+
+  BinaryFileAccessLog logger({Filesystem::DestinationType::File, "/dev/null"}, nullptr, {},
+                             log_manager);
+  runLogger(state, logger, *file);
+}
+BENCHMARK(BM_BinaryAccessLog);
+
+} // namespace
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -1,4 +1,5 @@
 #include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
 #include "envoy/extensions/access_loggers/file/v3/file.pb.h"
 #include "envoy/registry/registry.h"
 
@@ -176,6 +177,92 @@ TEST_F(FileAccessLogTest, LogFormatJson) {
       true);
 }
 
+// Lines are formatted into a buffer that is reused between lines, so each line must only hold its
+// own content.
+TEST_F(FileAccessLogTest, LogFormatTextReusesBuffer) {
+  envoy::extensions::access_loggers::file::v3::FileAccessLog fal_config;
+  TestUtility::loadFromYaml(R"(
+  path: "/foo"
+  log_format:
+    text_format_source:
+      inline_string: "%REQ(:path)% %RESPONSE_CODE%\n"
+)",
+                            fal_config);
+
+  envoy::config::accesslog::v3::AccessLog config;
+  config.mutable_typed_config()->PackFrom(fal_config);
+
+  auto file = std::make_shared<AccessLog::MockAccessLogFile>();
+  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, fal_config.path()};
+  EXPECT_CALL(context_.server_factory_context_.access_log_manager_, createAccessLog(file_info))
+      .WillOnce(Return(file));
+
+  AccessLog::InstanceSharedPtr logger = AccessLog::AccessLogFactory::fromProto(config, context_);
+
+  std::vector<std::string> lines;
+  EXPECT_CALL(*file, write(_)).Times(2).WillRepeatedly(Invoke([&lines](absl::string_view got) {
+    lines.emplace_back(got);
+  }));
+  stream_info_.setResponseCode(200);
+  request_headers_.setPath("/a/much/longer/path/than/the/next/one");
+  logger->log({&request_headers_, &response_headers_, &response_trailers_}, stream_info_);
+  stream_info_.setResponseCode(404);
+  request_headers_.setPath("/b");
+  logger->log({&request_headers_, &response_headers_, &response_trailers_}, stream_info_);
+
+  EXPECT_THAT(lines,
+              testing::ElementsAre("/a/much/longer/path/than/the/next/one 200\n", "/b 404\n"));
+}
+
+TEST_F(FileAccessLogTest, BinaryFormat) {
+  envoy::extensions::access_loggers::file::v3::FileAccessLog fal_config;
+  TestUtility::loadFromYaml(R"(
+  path: "/foo"
+  binary_format:
+    additional_request_headers_to_log: ["x-custom"]
+)",
+                            fal_config);
+
+  envoy::config::accesslog::v3::AccessLog config;
+  config.mutable_typed_config()->PackFrom(fal_config);
+
+  auto file = std::make_shared<AccessLog::MockAccessLogFile>();
+  Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, fal_config.path()};
+  EXPECT_CALL(context_.server_factory_context_.access_log_manager_, createAccessLog(file_info))
+      .WillOnce(Return(file));
+
+  AccessLog::InstanceSharedPtr logger = AccessLog::AccessLogFactory::fromProto(config, context_);
+
+  stream_info_.setResponseCode(200);
+  request_headers_.addCopy(Http::LowerCaseString("x-custom"), "custom-value");
+
+  std::string output;
+  EXPECT_CALL(*file, write(_)).Times(2).WillRepeatedly(Invoke([&output](absl::string_view got) {
+    output.append(got);
+  }));
+  logger->log({&request_headers_, &response_headers_, &response_trailers_}, stream_info_);
+  request_headers_.setPath("/baz");
+  logger->log({&request_headers_, &response_headers_, &response_trailers_}, stream_info_);
+
+  // The output is a sequence of varint length prefixed entries.
+  Protobuf::io::CodedInputStream coded_stream(reinterpret_cast<const uint8_t*>(output.data()),
+                                              output.size());
+  std::vector<std::string> paths;
+  uint32_t size;
+  while (coded_stream.ReadVarint32(&size)) {
+    const auto limit = coded_stream.PushLimit(size);
+    envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+    ASSERT_TRUE(entry.ParseFromCodedStream(&coded_stream));
+    coded_stream.PopLimit(limit);
+
+    EXPECT_EQ(200, entry.response().response_code().value());
+    EXPECT_EQ(envoy::config::core::v3::GET, entry.request().request_method());
+    EXPECT_EQ("custom-value", entry.request().request_headers().at("x-custom"));
+    paths.push_back(entry.request().path());
+  }
+  EXPECT_THAT(paths, testing::ElementsAre("/bar/foo", "/baz"));
+}
+
 } // namespace
 } // namespace File
 } // namespace AccessLoggers
@@ -0,0 +1,123 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <memory>
+
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/access_loggers/grpc/grpc_access_log_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace GrpcCommon {
+namespace {
+
+/**
+ * Stands in for the stream to an access log collector. The collector is modelled as reading a
+ * fixed number of bytes off the stream per logged request, and the stream reports being above its
+ * high watermark while more than HighWatermark bytes are waiting to be read.
+ */
+class FakeCollectorStream : public Grpc::RawAsyncStream {
+public:
+  static constexpr uint64_t HighWatermark = 64 * 1024;
+
+  // Grpc::RawAsyncStream
+  void sendMessageRaw(Buffer::InstancePtr&& request, bool) override {
+    ++messages_;
+    pending_bytes_ += request->length();
+  }
+  void closeStream() override {}
+  void resetStream() override {}
+  bool isAboveWriteBufferHighWatermark() const override { return pending_bytes_ > HighWatermark; }
+  const StreamInfo::StreamInfo& streamInfo() const override { return stream_info_; }
+  StreamInfo::StreamInfo& streamInfo() override { return stream_info_; }
+  void setWatermarkCallbacks(Http::SidestreamWatermarkCallbacks&) override {}
+  void removeWatermarkCallbacks() override {}
+
+  void read(uint64_t bytes) { pending_bytes_ -= std::min(bytes, pending_bytes_); }
+
+  uint64_t messages_{};
+
+private:
+  uint64_t pending_bytes_{};
+  testing::NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+};
+
+envoy::data::accesslog::v3::HTTPAccessLogEntry makeEntry() {
+  envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  auto* common = entry.mutable_common_properties();
+  common->mutable_downstream_remote_address()->mutable_socket_address()->set_address(
+      "203.0.113.1");
+  common->mutable_upstream_remote_address()->mutable_socket_address()->set_address("10.0.0.1");
+  common->set_upstream_cluster("backend");
+  common->set_route_name("default");
+  common->mutable_start_time()->set_seconds(1700000000);
+  common->mutable_time_to_last_downstream_tx_byte()->set_nanos(12345678);
+  entry.set_protocol_version(envoy::data::accesslog::v3::HTTPAccessLogEntry::HTTP2);
+  auto* request = entry.mutable_request();
+  request->set_request_method(envoy::config::core::v3::GET);
+  request->set_scheme("https");
+  request->set_authority("www.example.com");
+  request->set_path("/some/path/to/a/resource?with=query");
+  request->set_user_agent("Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 Chrome/120.0");
+  request->set_request_id("2f1c8a4e-6d3b-4f8e-9a7c-5b2d1e0f3a6c");
+  entry.mutable_response()->mutable_response_code()->set_value(200);
+  entry.mutable_response()->set_response_body_bytes(4096);
+  return entry;
+}
+
+// Measures the CPU per logged request with max_buffer_size_bytes given by the first argument and
+// the bytes the collector reads per logged request by the second. Reports the requests per
+// message sent and the fraction of requests whose entries were dropped.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_LogHttp(::benchmark::State& state) {
+  const uint64_t collector_bytes_per_request = state.range(1);
+  envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig config;
+  config.set_log_name("benchmark");
+  config.mutable_buffer_size_bytes()->set_value(16384);
+  config.mutable_max_buffer_size_bytes()->set_value(state.range(0));
+
+  FakeCollectorStream collector;
+  auto client = std::make_shared<testing::NiceMock<Grpc::MockAsyncClient>>();
+  ON_CALL(*client, startRaw(testing::_, testing::_, testing::_, testing::_))
+      .WillByDefault(testing::Return(&collector));
+  testing::NiceMock<Event::MockDispatcher> dispatcher;
+  testing::NiceMock<LocalInfo::MockLocalInfo> local_info;
+  Stats::IsolatedStoreImpl stats_store;
+  GrpcAccessLoggerImpl logger(client, config, dispatcher, local_info, *stats_store.rootScope());
+
+  const envoy::data::accesslog::v3::HTTPAccessLogEntry entry = makeEntry();
+  uint64_t requests = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    logger.log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+    collector.read(collector_bytes_per_request);
+    ++requests;
+  }
+  state.SetItemsProcessed(requests);
+  state.counters["requests_per_message"] =
+      static_cast<double>(requests) / std::max<uint64_t>(collector.messages_, 1);
+  state.counters["dropped_fraction"] =
+      static_cast<double>(
+          TestUtility::findCounter(stats_store, "access_logs.grpc_access_log.logs_dropped")
+              ->value()) /
+      requests;
+}
+BENCHMARK(BM_LogHttp)->ArgsProduct({{16384, 262144}, {1024, 128}});
+
+} // namespace
+} // namespace GrpcCommon
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
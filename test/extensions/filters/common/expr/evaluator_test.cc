@@ -54,6 +54,52 @@ TEST(Evaluator, Activation) {
   EXPECT_TRUE(activation->FindValue("upstream_filter_state", &arena).has_value());
 }
 
+// Verify an expression that references the same attribute several times in an evaluation.
+TEST(Evaluator, RepeatedAttribute) {
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  Http::TestRequestHeaderMapImpl headers{
+      {":method", "POST"}, {":path", "/meow"}, {"user-agent", "envoy-mobile"}};
+  // request.path == '/meow' && request.headers['user-agent'] == <user_agent>
+  const std::string expr_yaml = R"EOF(
+  call_expr:
+    function: _&&_
+    args:
+    - call_expr:
+        function: _==_
+        args:
+        - select_expr:
+            operand:
+              ident_expr:
+                name: request
+            field: path
+        - const_expr:
+            string_value: /meow
+    - call_expr:
+        function: _==_
+        args:
+        - call_expr:
+            function: _[_]
+            args:
+            - select_expr:
+                operand:
+                  ident_expr:
+                    name: request
+                field: headers
+            - const_expr:
+                string_value: user-agent
+        - const_expr:
+            string_value: {}
+  )EOF";
+  const auto builder = createBuilder(nullptr);
+
+  google::api::expr::v1alpha1::Expr expr;
+  TestUtility::loadFromYaml(fmt::format(expr_yaml, "envoy-mobile"), expr);
+  EXPECT_TRUE(matches(*createExpression(*builder, expr), info, headers));
+
+  TestUtility::loadFromYaml(fmt::format(expr_yaml, "curl"), expr);
+  EXPECT_FALSE(matches(*createExpression(*builder, expr), info, headers));
+}
+
 } // namespace
 } // namespace Expr
 } // namespace Common
@@ -3,6 +3,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/router/string_accessor_impl.h"
 #include "source/extensions/filters/common/expr/context.h"
+#include "source/extensions/filters/common/expr/evaluator.h"
 
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/ssl/mocks.h"
@@ -90,6 +91,48 @@ public:
     }
   }
 
+  // Evaluates a condition that references the request attributes several times, as an RBAC
+  // condition would.
+  void testEvaluate(::benchmark::State& state) {
+    // request.method == 'POST' && request.path == '/meow?yes=1' &&
+    //     request.headers['user-agent'] == 'envoy-mobile'
+    google::api::expr::v1alpha1::Expr expr;
+    TestUtility::loadFromYaml(R"EOF(
+    call_expr:
+      function: _&&_
+      args:
+      - call_expr:
+          function: _&&_
+          args:
+          - call_expr:
+              function: _==_
+              args:
+              - select_expr: {operand: {ident_expr: {name: request}}, field: method}
+              - const_expr: {string_value: POST}
+          - call_expr:
+              function: _==_
+              args:
+              - select_expr: {operand: {ident_expr: {name: request}}, field: path}
+              - const_expr: {string_value: /meow?yes=1}
+      - call_expr:
+          function: _==_
+          args:
+          - call_expr:
+              function: _[_]
+              args:
+              - select_expr: {operand: {ident_expr: {name: request}}, field: headers}
+              - const_expr: {string_value: user-agent}
+          - const_expr: {string_value: envoy-mobile}
+    )EOF",
+                              expr);
+    const auto builder = createBuilder(nullptr);
+    const auto expression = createExpression(*builder, expr);
+
+    for (auto _ : state) { // NOLINT
+      benchmark::DoNotOptimize(matches(*expression, info_, request_headers_));
+    }
+  }
+
 private:
   Http::TestRequestHeaderMapImpl makeRequestHeaders() {
     return Http::TestRequestHeaderMapImpl{{":method", "POST"},      {":scheme", "http"},
@@ -165,6 +208,11 @@ static void bmFilterState(::benchmark::State& state) {
   speed_test.testFilterState(state);
 }
 
+static void bmEvaluate(::benchmark::State& state) {
+  ExpressionContextSpeedTest speed_test(state.range(0));
+  speed_test.testEvaluate(state);
+}
+
 BENCHMARK(bmRequestAttributes)
     ->Unit(::benchmark::kMicrosecond)
     ->RangeMultiplier(100)
@@ -177,6 +225,8 @@ BENCHMARK(bmResponseAttributes)
 
 BENCHMARK(bmFilterState)->Unit(::benchmark::kMicrosecond)->RangeMultiplier(100)->Range(10, 100000);
 
+BENCHMARK(bmEvaluate)->Unit(::benchmark::kMicrosecond)->Arg(10);
+
 } // namespace Expr
 } // namespace Common
 } // namespace Filters
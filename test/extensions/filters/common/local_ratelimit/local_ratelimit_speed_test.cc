@@ -0,0 +1,115 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/common/ratelimit/v3/ratelimit.pb.h"
+
+#include "source/extensions/filters/common/local_ratelimit/local_ratelimit_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace LocalRateLimit {
+namespace {
+
+using testing::NiceMock;
+
+// Returns a request descriptor per client, as produced by a descriptor with a client address key.
+std::vector<std::vector<RateLimit::LocalDescriptor>> clientDescriptors(uint64_t num_clients) {
+  std::vector<std::vector<RateLimit::LocalDescriptor>> descriptors;
+  descriptors.reserve(num_clients);
+  for (uint64_t i = 0; i < num_clients; i++) {
+    descriptors.push_back({{{{"client", absl::StrCat("10.", i >> 16, ".", (i >> 8) & 0xff, ".",
+                                                     i & 0xff)}}}});
+  }
+  return descriptors;
+}
+
+// Measures rate limiting requests from 1M distinct clients with a wildcard descriptor, with the
+// maximum number of buckets kept for the clients given by the first argument. Reports the buckets
+// kept, which bound the memory used by the limiter however many clients it sees.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_WildcardDescriptor(::benchmark::State& state) {
+  const uint32_t max_dynamic_descriptors = state.range(0);
+  const uint64_t num_clients = benchmark::skipExpensiveBenchmarks() ? 1000 : 1000000;
+
+  Protobuf::RepeatedPtrField<envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>
+      config;
+  TestUtility::loadFromYaml(R"EOF(
+  entries:
+  - key: client
+  token_bucket:
+    max_tokens: 10
+    tokens_per_fill: 10
+    fill_interval: 1s
+  )EOF",
+                            *config.Add());
+  NiceMock<Event::MockDispatcher> dispatcher;
+  // The default token bucket is only consumed by the requests that match no descriptor.
+  LocalRateLimiterImpl limiter(std::chrono::milliseconds(50), 1, 1, dispatcher, config, false,
+                               nullptr, max_dynamic_descriptors);
+  const auto descriptors = clientDescriptors(num_clients);
+
+  uint64_t requests = 0;
+  uint64_t allowed = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (const auto& descriptor : descriptors) {
+      allowed += limiter.requestAllowed(descriptor).allowed;
+    }
+    requests += num_clients;
+  }
+  state.SetItemsProcessed(requests);
+  state.counters["allowed_per_request"] = static_cast<double>(allowed) / requests;
+}
+BENCHMARK(BM_WildcardDescriptor)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(::benchmark::kMillisecond);
+
+// Measures looking up the buckets of 1M distinct clients in a dynamic descriptor cache, with the
+// maximum number of buckets given by the first argument, and reports the buckets kept.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_DynamicDescriptorCache(::benchmark::State& state) {
+  const uint32_t max_entries = state.range(0);
+  const uint64_t num_clients = benchmark::skipExpensiveBenchmarks() ? 1000 : 1000000;
+
+  NiceMock<Event::MockDispatcher> dispatcher;
+  DynamicDescriptorCache cache(max_entries, 10, 10, std::chrono::seconds(1),
+                               dispatcher.timeSource());
+  const auto descriptors = clientDescriptors(num_clients);
+
+  uint64_t lookups = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (const auto& descriptor : descriptors) {
+      benchmark::DoNotOptimize(cache.getOrCreate(descriptor[0]));
+    }
+    lookups += num_clients;
+  }
+  state.SetItemsProcessed(lookups);
+  state.counters["buckets"] = cache.size();
+}
+BENCHMARK(BM_DynamicDescriptorCache)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace LocalRateLimit
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -1033,6 +1033,160 @@ TEST_F(LocalRateLimiterDescriptorImplTest, AtomicTokenBucketDescriptorStatus) {
   EXPECT_EQ(rate_limit_result.token_bucket_context->remainingTokens(), 2);
 }
 
+
+class LocalRateLimiterWildcardDescriptorTest : public LocalRateLimiterDescriptorImplTest {
+public:
+  void initializeWithWildcardDescriptor(uint32_t max_dynamic_descriptors) {
+    TestUtility::loadFromYaml(wildcard_descriptor_config_yaml, *descriptors_.Add());
+    // The default token bucket is large enough to not limit any of the requests.
+    rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(std::chrono::milliseconds(50), 10000,
+                                                           10000, dispatcher_, descriptors_, true,
+                                                           nullptr, max_dynamic_descriptors);
+  }
+
+  static std::vector<RateLimit::LocalDescriptor> clientDescriptor(const std::string& client) {
+    return {{{{"client", client}, {"path", "/api"}}}};
+  }
+
+  const std::string wildcard_descriptor_config_yaml = R"(
+  entries:
+  - key: client
+  - key: path
+    value: /api
+  token_bucket:
+    max_tokens: 1
+    tokens_per_fill: 1
+    fill_interval: 1s
+  )";
+};
+
+// Verify each value matched by a wildcard entry gets its own token bucket.
+TEST_F(LocalRateLimiterWildcardDescriptorTest, BucketPerValue) {
+  initializeWithWildcardDescriptor(10);
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("b")).allowed);
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("b")).allowed);
+
+  auto result = rate_limiter_->requestAllowed(clientDescriptor("a"));
+  ASSERT_NE(result.token_bucket_context, nullptr);
+  EXPECT_EQ(result.token_bucket_context->maxTokens(), 1);
+  EXPECT_EQ(result.token_bucket_context->remainingTokens(), 0);
+
+  // The buckets refill lazily.
+  dispatcher_.globalTimeSystem().advanceTimeWait(std::chrono::milliseconds(1000));
+  EXPECT_EQ(result.token_bucket_context->remainingTokens(), 1);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+}
+
+// Verify the entries with a value must still match, and the keys must match in order.
+TEST_F(LocalRateLimiterWildcardDescriptorTest, NonWildcardEntriesMustMatch) {
+  initializeWithWildcardDescriptor(10);
+
+  std::vector<RateLimit::LocalDescriptor> other_path{{{{"client", "a"}, {"path", "/other"}}}};
+  std::vector<RateLimit::LocalDescriptor> other_order{{{{"path", "/api"}, {"client", "a"}}}};
+  std::vector<RateLimit::LocalDescriptor> fewer_entries{{{{"client", "a"}}}};
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(other_path).allowed);
+    EXPECT_TRUE(rate_limiter_->requestAllowed(other_order).allowed);
+    EXPECT_TRUE(rate_limiter_->requestAllowed(fewer_entries).allowed);
+  }
+}
+
+// Verify an exact descriptor takes precedence over a wildcard descriptor matching the same
+// request descriptor.
+TEST_F(LocalRateLimiterWildcardDescriptorTest, ExactDescriptorTakesPrecedence) {
+  TestUtility::loadFromYaml(R"(
+  entries:
+  - key: client
+    value: a
+  - key: path
+    value: /api
+  token_bucket:
+    max_tokens: 3
+    tokens_per_fill: 3
+    fill_interval: 1s
+  )",
+                            *descriptors_.Add());
+  initializeWithWildcardDescriptor(10);
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("b")).allowed);
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("b")).allowed);
+}
+
+// Verify the least recently used buckets are evicted, and that an evicted bucket is recreated full
+// while the context of a request that still holds it stays valid.
+TEST_F(LocalRateLimiterWildcardDescriptorTest, LeastRecentlyUsedEviction) {
+  initializeWithWildcardDescriptor(1);
+
+  auto result = rate_limiter_->requestAllowed(clientDescriptor("a"));
+  EXPECT_TRUE(result.allowed);
+  // The cache holds a single bucket, so the bucket of "a" is evicted.
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(
+        rate_limiter_->requestAllowed(clientDescriptor(absl::StrCat("client-", i))).allowed);
+  }
+  EXPECT_EQ(result.token_bucket_context->remainingTokens(), 0);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+}
+
+TEST(DynamicDescriptorCacheTest, BoundedSize) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  DynamicDescriptorCache cache(64, 1, 1, std::chrono::milliseconds(1000), dispatcher.timeSource());
+
+  RateLimitTokenBucketSharedPtr first = cache.getOrCreate({{{"client", "first"}}});
+  EXPECT_EQ(first, cache.getOrCreate({{{"client", "first"}}}));
+  for (int i = 0; i < 10000; i++) {
+    cache.getOrCreate({{{"client", absl::StrCat(i)}}});
+  }
+  EXPECT_EQ(cache.size(), 64U);
+  EXPECT_NE(first, cache.getOrCreate({{{"client", "first"}}}));
+}
+
+// Verify the buckets of distinct descriptors do not evict one another while the cache has room
+// for all of them.
+TEST_F(LocalRateLimiterWildcardDescriptorTest, NoEvictionWithinBound) {
+  initializeWithWildcardDescriptor(20);
+
+  for (int i = 0; i < 20; i++) {
+    EXPECT_TRUE(
+        rate_limiter_->requestAllowed(clientDescriptor(absl::StrCat("client-", i))).allowed);
+  }
+  for (int i = 0; i < 20; i++) {
+    EXPECT_FALSE(
+        rate_limiter_->requestAllowed(clientDescriptor(absl::StrCat("client-", i))).allowed);
+  }
+}
+
+TEST(DynamicDescriptorCacheTest, NoEvictionWithinBound) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  DynamicDescriptorCache cache(20, 1, 1, std::chrono::milliseconds(1000), dispatcher.timeSource());
+
+  std::vector<RateLimitTokenBucketSharedPtr> buckets;
+  for (int i = 0; i < 20; i++) {
+    buckets.push_back(cache.getOrCreate({{{"client", absl::StrCat(i)}}}));
+  }
+  EXPECT_EQ(cache.size(), 20U);
+  for (int i = 0; i < 20; i++) {
+    EXPECT_EQ(buckets[i], cache.getOrCreate({{{"client", absl::StrCat(i)}}}));
+  }
+}
+
+// Verify blank values are matched literally when the dynamic descriptors are disabled.
+TEST_F(LocalRateLimiterWildcardDescriptorTest, DisabledMatchesBlankValueLiterally) {
+  initializeWithWildcardDescriptor(0);
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("a")).allowed);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(clientDescriptor("")).allowed);
+  EXPECT_FALSE(rate_limiter_->requestAllowed(clientDescriptor("")).allowed);
+}
+
 } // Namespace LocalRateLimit
 } // namespace Common
 } // namespace Filters
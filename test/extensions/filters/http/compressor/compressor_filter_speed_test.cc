@@ -1,6 +1,7 @@
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
 
+#include "source/common/singleton/manager_impl.h"
 #include "source/extensions/compression/brotli/compressor/brotli_compressor_impl.h"
 #include "source/extensions/compression/brotli/compressor/config.h"
 #include "source/extensions/compression/gzip/compressor/config.h"
@@ -11,11 +12,14 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 
 using testing::Return;
+using testing::ReturnRef;
 
 namespace Envoy {
 namespace Extensions {
@@ -120,8 +124,11 @@ CompressorFilterConfigSharedPtr makeGzipConfig(Stats::IsolatedStoreImpl& stats,
   const auto memory_level = params.memory_level;
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockGzipCompressorFactory>(level, strategy, window_bits, memory_level);
+  Singleton::ManagerImpl singleton_manager;
+  testing::NiceMock<Event::MockDispatcher> main_thread_dispatcher;
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, singleton_manager,
+      Thread::threadFactoryForTest(), main_thread_dispatcher, std::move(compressor_factory));
 
   return config;
 }
@@ -136,8 +143,11 @@ CompressorFilterConfigSharedPtr makeZstdConfig(Stats::IsolatedStoreImpl& stats,
   const auto strategy = params.strategy;
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockZstdCompressorFactory>(level, strategy);
+  Singleton::ManagerImpl singleton_manager;
+  testing::NiceMock<Event::MockDispatcher> main_thread_dispatcher;
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, singleton_manager,
+      Thread::threadFactoryForTest(), main_thread_dispatcher, std::move(compressor_factory));
 
   return config;
 }
@@ -151,8 +161,11 @@ CompressorFilterConfigSharedPtr makeBrotliConfig(Stats::IsolatedStoreImpl& stats
   const auto quality = params.level;
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockBrotliCompressorFactory>(quality);
+  Singleton::ManagerImpl singleton_manager;
+  testing::NiceMock<Event::MockDispatcher> main_thread_dispatcher;
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, singleton_manager,
+      Thread::threadFactoryForTest(), main_thread_dispatcher, std::move(compressor_factory));
 
   return config;
 }
@@ -703,6 +716,142 @@ BENCHMARK(compressChunks1024WithBrotli)
     ->UseManualTime()
     ->Unit(benchmark::kMillisecond);
 
+// The number of streams which receive a response at the same time in compressUnderLoadWithGzip,
+// and the size of their responses.
+static constexpr uint32_t LoadedStreams = 8;
+static constexpr uint64_t LoadedResponseSize = 1048576;
+
+// A stream of compressUnderLoadWithGzip, whose response goes through a compressor filter.
+struct LoadedStream {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+  std::unique_ptr<CompressorFilter> filter;
+  // The data that the filter manager buffers while the filter stops iteration.
+  Buffer::OwnedImpl buffered;
+  bool end_stream_sent{false};
+};
+
+// Measures how long the event loop of a worker stalls while it proxies the responses of
+// LoadedStreams streams, which arrive in chunks of the size of the second argument. The responses
+// are compressed on the worker thread if the first argument is 0, and else on a thread pool with
+// as many threads. "max_stall_ms" is the largest delay of a 1ms timer of the worker, which is how
+// long the other streams of the worker could have to wait, and the time is the time it takes to
+// compress all the responses.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressUnderLoadWithGzip(benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  const uint64_t chunk_size = state.range(1);
+  const uint64_t chunks_per_stream = LoadedResponseSize / chunk_size;
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  Stats::IsolatedStoreImpl stats;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  Singleton::ManagerImpl singleton_manager;
+  envoy::extensions::filters::http::compressor::v3::Compressor proto_config;
+  if (num_threads > 0) {
+    auto* offload =
+        proto_config.mutable_response_direction_config()->mutable_compression_offload();
+    offload->mutable_num_threads()->set_value(num_threads);
+    offload->mutable_min_chunk_size()->set_value(chunk_size);
+  }
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      proto_config, "test.", *stats.rootScope(), runtime, singleton_manager, api->threadFactory(),
+      *dispatcher, std::make_unique<MockGzipCompressorFactory>(
+          Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel::Standard,
+          Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, 15,
+          8));
+
+  Buffer::OwnedImpl body_buffer;
+  TestUtility::feedBufferWithRandomCharacters(body_buffer, LoadedResponseSize);
+  const std::string body = body_buffer.toString();
+
+  double max_stall_ms = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    uint32_t streams_done = 0;
+    const auto on_stream_done = [&]() {
+      if (++streams_done == LoadedStreams) {
+        dispatcher->exit();
+      }
+    };
+
+    std::vector<std::unique_ptr<LoadedStream>> streams;
+    for (uint32_t i = 0; i < LoadedStreams; ++i) {
+      auto stream = std::make_unique<LoadedStream>();
+      LoadedStream* stream_ptr = stream.get();
+      ON_CALL(stream->encoder_callbacks, dispatcher()).WillByDefault(ReturnRef(*dispatcher));
+      ON_CALL(stream->encoder_callbacks, modifyEncodingBuffer(_))
+          .WillByDefault(Invoke([stream_ptr](std::function<void(Buffer::Instance&)> callback) {
+            callback(stream_ptr->buffered);
+          }));
+      ON_CALL(stream->encoder_callbacks, continueEncoding())
+          .WillByDefault(Invoke([stream_ptr, &on_stream_done]() {
+            stream_ptr->buffered.drain(stream_ptr->buffered.length());
+            if (stream_ptr->end_stream_sent) {
+              on_stream_done();
+            }
+          }));
+      stream->filter = std::make_unique<CompressorFilter>(config);
+      stream->filter->setDecoderFilterCallbacks(stream->decoder_callbacks);
+      stream->filter->setEncoderFilterCallbacks(stream->encoder_callbacks);
+      Http::TestRequestHeaderMapImpl request_headers = {{":method", "get"},
+                                                        {"accept-encoding", "gzip"}};
+      stream->filter->decodeHeaders(request_headers, true);
+      Http::TestResponseHeaderMapImpl response_headers = {{":status", "200"},
+                                                          {"content-type", "application/json"}};
+      stream->filter->encodeHeaders(response_headers, false);
+      streams.push_back(std::move(stream));
+    }
+
+    // Each event loop iteration receives a chunk of one of the streams in turn.
+    const uint64_t num_chunks = LoadedStreams * chunks_per_stream;
+    std::function<void(uint64_t)> receive_chunk = [&](uint64_t chunk) {
+      LoadedStream& stream = *streams[chunk % LoadedStreams];
+      const bool end_stream = chunk / LoadedStreams == chunks_per_stream - 1;
+      Buffer::OwnedImpl data(body.data() + (chunk / LoadedStreams) * chunk_size, chunk_size);
+      stream.end_stream_sent = end_stream;
+      if (stream.filter->encodeData(data, end_stream) == Http::FilterDataStatus::Continue) {
+        if (end_stream) {
+          on_stream_done();
+        }
+      } else {
+        stream.buffered.move(data);
+      }
+      if (chunk + 1 < num_chunks) {
+        dispatcher->post([&receive_chunk, chunk]() { receive_chunk(chunk + 1); });
+      }
+    };
+
+    MonotonicTime probe_enabled_at;
+    Event::TimerPtr probe = dispatcher->createTimer([&]() {
+      const MonotonicTime now = api->timeSource().monotonicTime();
+      const double stall_ms =
+          std::chrono::duration<double, std::milli>(now - probe_enabled_at).count() - 1;
+      max_stall_ms = std::max(max_stall_ms, stall_ms);
+      probe_enabled_at = now;
+      probe->enableTimer(std::chrono::milliseconds(1));
+    });
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    probe_enabled_at = api->timeSource().monotonicTime();
+    probe->enableTimer(std::chrono::milliseconds(1));
+    dispatcher->post([&receive_chunk]() { receive_chunk(0); });
+    dispatcher->run(Event::Dispatcher::RunType::Block);
+    const auto end = std::chrono::high_resolution_clock::now();
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+
+    probe.reset();
+    for (auto& stream : streams) {
+      stream->filter->onDestroy();
+    }
+  }
+  state.counters["max_stall_ms"] = max_stall_ms;
+}
+BENCHMARK(compressUnderLoadWithGzip)
+    ->ArgsProduct({{0, 1, 4}, {65536, 1048576}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
 } // namespace Compressor
 } // namespace HttpFilters
 } // namespace Extensions
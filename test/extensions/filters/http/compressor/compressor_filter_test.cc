@@ -1,11 +1,14 @@
+#include "source/common/singleton/manager_impl.h"
 #include "source/extensions/filters/http/compressor/compressor_filter.h"
 
 #include "test/mocks/compression/compressor/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+#include "absl/synchronization/notification.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -17,6 +20,7 @@ namespace {
 using envoy::extensions::filters::http::compressor::v3::CompressorPerRoute;
 using testing::NiceMock;
 using testing::Return;
+using testing::ReturnRef;
 
 class TestCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
@@ -31,10 +35,13 @@ public:
   const std::string& statsPrefix() const override { CONSTRUCT_ON_FIRST_USE(std::string, "test."); }
   const std::string& contentEncoding() const override { return content_encoding_; }
 
-  void setExpectedCompressCalls(uint32_t calls) { expected_compress_calls_ = calls; }
+  void setExpectedCompressCalls(uint32_t calls) {
+    expected_compress_calls_ = testing::Exactly(calls);
+  }
+  void setExpectedCompressCalls(testing::Cardinality calls) { expected_compress_calls_ = calls; }
 
 private:
-  uint32_t expected_compress_calls_{1};
+  testing::Cardinality expected_compress_calls_{testing::Exactly(1)};
   const std::string content_encoding_;
 };
 
@@ -64,8 +71,9 @@ public:
     TestUtility::loadFromJson(json, compressor);
     auto compressor_factory = std::make_unique<TestCompressorFactory>("test");
     compressor_factory_ = compressor_factory.get();
-    config_ = std::make_shared<CompressorFilterConfig>(compressor, "test.", *stats_.rootScope(),
-                                                       runtime_, std::move(compressor_factory));
+    config_ = std::make_shared<CompressorFilterConfig>(
+        compressor, "test.", *stats_.rootScope(), runtime_, singleton_manager_,
+        Thread::threadFactoryForTest(), *dispatcher_, std::move(compressor_factory));
     filter_ = std::make_unique<CompressorFilter>(config_);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
@@ -171,6 +179,10 @@ public:
     }
   }
 
+  // The dispatcher of the worker and of the main thread, declared first so that it outlives the
+  // jobs it may hold.
+  Api::ApiPtr api_{Api::createApiForTest()};
+  Event::DispatcherPtr dispatcher_{api_->allocateDispatcher("test_thread")};
   TestCompressorFactory* compressor_factory_;
   std::shared_ptr<CompressorFilterConfig> config_;
   std::unique_ptr<CompressorFilter> filter_;
@@ -179,6 +191,7 @@ public:
   std::string response_stats_prefix_{};
   Stats::TestUtil::TestStore stats_;
   NiceMock<Runtime::MockLoader> runtime_;
+  Singleton::ManagerImpl singleton_manager_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
   NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
 };
@@ -271,6 +284,9 @@ TEST_F(CompressorFilterTest, DefaultConfigValues) {
   EXPECT_EQ(false, config_->responseDirectionConfig().removeAcceptEncodingHeader());
   EXPECT_EQ(20, config_->responseDirectionConfig().contentTypeValues().size());
   EXPECT_EQ(20, config_->requestDirectionConfig().contentTypeValues().size());
+  EXPECT_EQ(0, config_->responseDirectionConfig().offloadNumThreads());
+  EXPECT_EQ(65536, config_->responseDirectionConfig().offloadMinChunkSize());
+  EXPECT_EQ(nullptr, config_->compressionThreadPool());
 }
 
 TEST_F(CompressorFilterTest, CompressRequest) {
@@ -629,6 +645,163 @@ TEST_F(CompressorFilterTest, RemoveAcceptEncodingHeader) {
   }
 }
 
+class CompressionOffloadTest : public CompressorFilterTest {
+public:
+  CompressionOffloadTest() {
+    ON_CALL(encoder_callbacks_, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    // Buffer the data of the filter like the filter manager does when iteration is stopped.
+    ON_CALL(encoder_callbacks_, modifyEncodingBuffer(_))
+        .WillByDefault(Invoke([this](std::function<void(Buffer::Instance&)> callback) {
+          callback(buffered_);
+        }));
+    ON_CALL(encoder_callbacks_, continueEncoding()).WillByDefault(Invoke([this]() {
+      dispatcher_->exit();
+    }));
+  }
+
+  void SetUp() override {
+    setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compression_offload": {
+      "min_chunk_size": 1024
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+    response_stats_prefix_ = "response.";
+    doRequestNoCompression({{":method", "get"}, {"accept-encoding", "deflate, test"}});
+    expected_str_.clear();
+  }
+
+  void TearDown() override {
+    if (filter_ != nullptr) {
+      filter_->onDestroy();
+    }
+  }
+
+  // Starts a compressed response, whose compressor expects the given number of calls.
+  void encodeHeaders(testing::Cardinality compress_calls) {
+    compressor_factory_->setExpectedCompressCalls(compress_calls);
+    Http::TestResponseHeaderMapImpl headers{{":status", "200"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  }
+
+  // Passes the data to the filter, and buffers it if the filter stops iteration.
+  Http::FilterDataStatus encodeData(uint64_t size, bool end_stream) {
+    Buffer::OwnedImpl data;
+    TestUtility::feedBufferWithRandomCharacters(data, size);
+    expected_str_ += data.toString();
+    const Http::FilterDataStatus status = filter_->encodeData(data, end_stream);
+    if (status == Http::FilterDataStatus::StopIterationAndWatermark) {
+      buffered_.move(data);
+    }
+    return status;
+  }
+
+  uint64_t responseCounter(absl::string_view name) {
+    return stats_.counter(absl::StrCat("test.compressor.test.test.response.", name)).value();
+  }
+
+  Buffer::OwnedImpl buffered_;
+};
+
+// A chunk smaller than min_chunk_size is compressed on the worker thread.
+TEST_F(CompressionOffloadTest, SmallChunkIsCompressedInline) {
+  encodeHeaders(testing::Exactly(1));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, encodeData(512, true));
+  EXPECT_EQ(0, responseCounter("offloaded_chunks"));
+  EXPECT_EQ(512, responseCounter("total_uncompressed_bytes"));
+}
+
+// The data received while a chunk is compressed on the thread pool is buffered, and compressed
+// after it.
+TEST_F(CompressionOffloadTest, LargeChunkIsOffloaded) {
+  encodeHeaders(testing::Exactly(2));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(2048, false));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(10, true));
+  EXPECT_CALL(encoder_callbacks_, continueEncoding());
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // The mock compressor leaves the data as it is.
+  EXPECT_EQ(expected_str_, buffered_.toString());
+  EXPECT_EQ(1, responseCounter("offloaded_chunks"));
+  EXPECT_EQ(2058, responseCounter("total_uncompressed_bytes"));
+  EXPECT_EQ(2058, responseCounter("total_compressed_bytes"));
+}
+
+// The data buffered while a chunk is compressed on the thread pool is offloaded in turn if it is
+// large enough.
+TEST_F(CompressionOffloadTest, BufferedDataIsOffloaded) {
+  encodeHeaders(testing::Exactly(2));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(2048, false));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(600, false));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(600, true));
+  EXPECT_CALL(encoder_callbacks_, continueEncoding());
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(expected_str_, buffered_.toString());
+  EXPECT_EQ(2, responseCounter("offloaded_chunks"));
+  EXPECT_EQ(3248, responseCounter("total_uncompressed_bytes"));
+}
+
+// Trailers received while a chunk is compressed on the thread pool wait for it, and the compression
+// library is then told that the stream is ended.
+TEST_F(CompressionOffloadTest, TrailersWaitForOffloadedChunk) {
+  encodeHeaders(testing::Exactly(2));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(2048, false));
+  Http::TestResponseTrailerMapImpl trailers;
+  EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_->encodeTrailers(trailers));
+  EXPECT_CALL(encoder_callbacks_, continueEncoding());
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(expected_str_, buffered_.toString());
+  EXPECT_EQ(1, responseCounter("offloaded_chunks"));
+}
+
+// The result of a job is discarded if the stream is destroyed while it is running.
+TEST_F(CompressionOffloadTest, StreamDestroyedDuringOffload) {
+  encodeHeaders(testing::AtMost(1));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(2048, false));
+  filter_->onDestroy();
+  filter_.reset();
+
+  EXPECT_CALL(encoder_callbacks_, continueEncoding()).Times(0);
+  EXPECT_CALL(encoder_callbacks_, modifyEncodingBuffer(_)).Times(0);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+// A job queued when its stream and the filter config are destroyed holds the config until the job
+// is released on the main thread.
+TEST_F(CompressionOffloadTest, ConfigDestroyedWhileJobQueued) {
+  CompressionThreadPool& pool = *config_->compressionThreadPool();
+  absl::Notification unblock_pool;
+  pool.post([&unblock_pool]() { unblock_pool.WaitForNotification(); });
+
+  encodeHeaders(testing::Exactly(0));
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, encodeData(2048, false));
+  filter_->onDestroy();
+  filter_.reset();
+  std::weak_ptr<CompressorFilterConfig> config = config_;
+  config_.reset();
+  EXPECT_FALSE(config.expired());
+
+  unblock_pool.Notify();
+  absl::Notification job_done;
+  pool.post([&job_done]() { job_done.Notify(); });
+  job_done.WaitForNotification();
+  EXPECT_FALSE(config.expired());
+
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_TRUE(config.expired());
+}
+
 class IsAcceptEncodingAllowedTest
     : public CompressorFilterTest,
       public testing::WithParamInterface<std::tuple<std::string, bool, int, int, int, int>> {};
@@ -930,7 +1103,8 @@ protected:
     auto compressor_factory1 = std::make_unique<TestCompressorFactory>("test1");
     compressor_factory1->setExpectedCompressCalls(0);
     auto config1 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1));
+        compressor, "test1.", *stats1_.rootScope(), runtime_, singleton_manager_,
+        Thread::threadFactoryForTest(), main_thread_dispatcher_, std::move(compressor_factory1));
     filter1_ = std::make_unique<CompressorFilter>(config1);
 
     TestUtility::loadFromJson(R"EOF(
@@ -947,11 +1121,14 @@ protected:
     auto compressor_factory2 = std::make_unique<TestCompressorFactory>("test2");
     compressor_factory2->setExpectedCompressCalls(0);
     auto config2 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2));
+        compressor, "test2.", *stats2_.rootScope(), runtime_, singleton_manager_,
+        Thread::threadFactoryForTest(), main_thread_dispatcher_, std::move(compressor_factory2));
     filter2_ = std::make_unique<CompressorFilter>(config2);
   }
 
   NiceMock<Runtime::MockLoader> runtime_;
+  Singleton::ManagerImpl singleton_manager_;
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher_;
   Stats::TestUtil::TestStore stats1_;
   Stats::TestUtil::TestStore stats2_;
   std::unique_ptr<CompressorFilter> filter1_;
@@ -1053,7 +1230,8 @@ protected:
                               compressor);
     auto compressor_factory1 = std::make_unique<TestCompressorFactory>("test1");
     auto config1 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1));
+        compressor, "test1.", *stats1_.rootScope(), runtime_, singleton_manager_,
+        Thread::threadFactoryForTest(), main_thread_dispatcher_, std::move(compressor_factory1));
     filter1_ = std::make_unique<CompressorFilter>(config1);
 
     TestUtility::loadFromJson(fmt::format(R"EOF(
@@ -1071,7 +1249,8 @@ protected:
                               compressor);
     auto compressor_factory2 = std::make_unique<TestCompressorFactory>("test2");
     auto config2 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2));
+        compressor, "test2.", *stats2_.rootScope(), runtime_, singleton_manager_,
+        Thread::threadFactoryForTest(), main_thread_dispatcher_, std::move(compressor_factory2));
     filter2_ = std::make_unique<CompressorFilter>(config2);
   }
 
@@ -1174,15 +1353,49 @@ TEST(CompressorFilterConfigTests, MakeCompressorTest) {
   const envoy::extensions::filters::http::compressor::v3::Compressor compressor_cfg;
   NiceMock<Runtime::MockLoader> runtime;
   Stats::TestUtil::TestStore stats;
+  Singleton::ManagerImpl singleton_manager;
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher;
   auto compressor_factory(std::make_unique<Compression::Compressor::MockCompressorFactory>());
   EXPECT_CALL(*compressor_factory, createCompressor());
   EXPECT_CALL(*compressor_factory, statsPrefix());
   EXPECT_CALL(*compressor_factory, contentEncoding());
   CompressorFilterConfig config(compressor_cfg, "test.compressor.", *stats.rootScope(), runtime,
-                                std::move(compressor_factory));
+                                singleton_manager, Thread::threadFactoryForTest(),
+                                main_thread_dispatcher, std::move(compressor_factory));
   Envoy::Compression::Compressor::CompressorPtr compressor = config.makeCompressor();
 }
 
+// The configs with the same number of offload threads share a thread pool.
+TEST(CompressorFilterConfigTests, CompressionThreadPoolIsShared) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::TestUtil::TestStore stats;
+  Singleton::ManagerImpl singleton_manager;
+  NiceMock<Event::MockDispatcher> main_thread_dispatcher;
+  const auto make_config = [&](uint32_t num_threads) {
+    envoy::extensions::filters::http::compressor::v3::Compressor compressor_cfg;
+    compressor_cfg.mutable_response_direction_config()
+        ->mutable_compression_offload()
+        ->mutable_num_threads()
+        ->set_value(num_threads);
+    return std::make_shared<CompressorFilterConfig>(
+        compressor_cfg, "test.", *stats.rootScope(), runtime, singleton_manager,
+        Thread::threadFactoryForTest(), main_thread_dispatcher,
+        std::make_unique<TestCompressorFactory>("test"));
+  };
+  CompressorFilterConfigSharedPtr config1 = make_config(2);
+  CompressorFilterConfigSharedPtr config2 = make_config(2);
+  CompressorFilterConfigSharedPtr config3 = make_config(1);
+  ASSERT_NE(nullptr, config1->compressionThreadPool());
+  EXPECT_EQ(config1->compressionThreadPool(), config2->compressionThreadPool());
+  EXPECT_NE(config1->compressionThreadPool(), config3->compressionThreadPool());
+
+  // The pool outlives the configs which use it.
+  CompressionThreadPool* pool = config1->compressionThreadPool();
+  config1.reset();
+  config2.reset();
+  EXPECT_EQ(pool, make_config(2)->compressionThreadPool());
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace HttpFilters
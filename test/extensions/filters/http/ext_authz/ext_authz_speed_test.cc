@@ -0,0 +1,126 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+
+#include "source/common/network/address_impl.h"
+#include "source/extensions/filters/http/ext_authz/ext_authz.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+using testing::NiceMock;
+using testing::Return;
+
+// A stand-in for the authorization server that holds the check calls until respond() is called,
+// and then allows all of them.
+class FakeAuthzServer {
+public:
+  void respond() {
+    std::vector<Filters::Common::ExtAuthz::RequestCallbacks*> pending = std::move(pending_);
+    pending_.clear();
+    for (auto* callbacks : pending) {
+      auto response = std::make_unique<Filters::Common::ExtAuthz::Response>();
+      response->status = Filters::Common::ExtAuthz::CheckStatus::OK;
+      callbacks->onComplete(std::move(response));
+    }
+  }
+
+  std::vector<Filters::Common::ExtAuthz::RequestCallbacks*> pending_;
+  uint64_t checks_{};
+};
+
+class FakeAuthzClient : public Filters::Common::ExtAuthz::Client {
+public:
+  explicit FakeAuthzClient(FakeAuthzServer& server) : server_(server) {}
+
+  // Filters::Common::ExtAuthz::Client
+  void cancel() override {}
+  void check(Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+             const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+             const StreamInfo::StreamInfo&) override {
+    ++server_.checks_;
+    server_.pending_.push_back(&callbacks);
+  }
+
+private:
+  FakeAuthzServer& server_;
+};
+
+// Measures authorizing batches of concurrent requests that share a principal, with the decision
+// cache disabled or enabled by the first argument and the number of requests per batch given by
+// the second. Each batch uses a new principal, so the cache only helps by coalescing the check
+// calls of a batch. Reports the check calls made per request.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ConcurrentChecks(::benchmark::State& state) {
+  const bool cache = state.range(0) == 1;
+  const uint64_t concurrency = state.range(1);
+
+  envoy::extensions::filters::http::ext_authz::v3::ExtAuthz proto_config;
+  proto_config.mutable_grpc_service()->mutable_envoy_grpc()->set_cluster_name("ext_authz_server");
+  if (cache) {
+    proto_config.mutable_check_cache()->add_key_headers("authorization");
+  }
+  NiceMock<Stats::MockIsolatedStatsStore> stats_store;
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  auto config = std::make_shared<FilterConfig>(proto_config, *stats_store.rootScope(), "",
+                                               factory_context);
+
+  NiceMock<Network::MockConnection> connection;
+  auto addr = std::make_shared<Network::Address::Ipv4Instance>("1.2.3.4", 1111);
+  connection.stream_info_.downstream_connection_info_provider_->setRemoteAddress(addr);
+  connection.stream_info_.downstream_connection_info_provider_->setLocalAddress(addr);
+  std::vector<std::unique_ptr<NiceMock<Http::MockStreamDecoderFilterCallbacks>>> callbacks;
+  for (uint64_t i = 0; i < concurrency; i++) {
+    callbacks.push_back(std::make_unique<NiceMock<Http::MockStreamDecoderFilterCallbacks>>());
+    ON_CALL(*callbacks.back(), connection())
+        .WillByDefault(Return(OptRef<const Network::Connection>{connection}));
+  }
+
+  FakeAuthzServer server;
+  uint64_t batches = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Http::TestRequestHeaderMapImpl headers{{":method", "GET"},
+                                           {":path", "/"},
+                                           {":authority", "host"},
+                                           {"authorization", absl::StrCat("user-", batches)}};
+    std::vector<std::unique_ptr<Filter>> filters;
+    for (uint64_t i = 0; i < concurrency; i++) {
+      filters.push_back(
+          std::make_unique<Filter>(config, std::make_unique<FakeAuthzClient>(server)));
+      filters.back()->setDecoderFilterCallbacks(*callbacks[i]);
+      filters.back()->decodeHeaders(headers, true);
+    }
+    server.respond();
+    for (auto& filter : filters) {
+      filter->onDestroy();
+    }
+    ++batches;
+  }
+  state.SetItemsProcessed(batches * concurrency);
+  state.counters["checks_per_request"] =
+      static_cast<double>(server.checks_) / (batches * concurrency);
+}
+BENCHMARK(BM_ConcurrentChecks)->ArgsProduct({{0, 1}, {1, 16, 64}});
+
+} // namespace
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,4 +1,5 @@
 #include <chrono>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -4123,6 +4124,253 @@ TEST_P(EmitFilterStateTest, PreexistingFilterStateSameTypeMutable) {
 
 TEST_P(ExtAuthzLoggingInfoTest, FieldTest) { test(); }
 
+// Tests for the decision cache, which is shared by all the filter instances of a config on a
+// worker. Each test drives a second filter instance next to the one from the fixture.
+class CheckCacheTest : public HttpFilterTestBase<testing::Test> {
+public:
+  void SetUp() override {
+    initialize(R"(
+      grpc_service:
+        envoy_grpc:
+          cluster_name: "ext_authz_server"
+      check_cache:
+        key_headers: ["authorization"]
+        ttl_metadata_key: "cache_ttl"
+    )");
+    prepareCheck();
+    request_headers_.addCopy(Http::Headers::get().Path, "/");
+    request_headers_.addCopy(Http::LowerCaseString("authorization"), "token");
+
+    other_client_ = new NiceMock<Filters::Common::ExtAuthz::MockClient>();
+    other_filter_ =
+        std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{other_client_});
+    ON_CALL(other_decoder_callbacks_, connection())
+        .WillByDefault(Return(OptRef<const Network::Connection>{connection_}));
+    other_filter_->setDecoderFilterCallbacks(other_decoder_callbacks_);
+    other_filter_->setEncoderFilterCallbacks(other_encoder_callbacks_);
+  }
+
+  // Starts a check call on the fixture's filter and leaves it in flight.
+  void startCheck() {
+    EXPECT_CALL(*client_, check(_, _, _, _))
+        .WillOnce(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                             const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                             const StreamInfo::StreamInfo&) -> void {
+          request_callbacks_ = &callbacks;
+        }));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+              filter_->decodeHeaders(request_headers_, false));
+  }
+
+  static Filters::Common::ExtAuthz::ResponsePtr okResponse() {
+    auto response = std::make_unique<Filters::Common::ExtAuthz::Response>();
+    response->status = Filters::Common::ExtAuthz::CheckStatus::OK;
+    return response;
+  }
+
+  Filters::Common::ExtAuthz::MockClient* other_client_;
+  std::unique_ptr<Filter> other_filter_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> other_decoder_callbacks_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> other_encoder_callbacks_;
+};
+
+// A later request with the same key uses the cached decision without a check call.
+TEST_F(CheckCacheTest, CachedDecision) {
+  startCheck();
+  EXPECT_CALL(decoder_filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(okResponse());
+
+  EXPECT_CALL(*other_client_, check(_, _, _, _)).Times(0);
+  EXPECT_CALL(other_decoder_callbacks_, continueDecoding()).Times(0);
+  Http::TestRequestHeaderMapImpl other_headers{{":path", "/other"}, {"authorization", "token"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue,
+            other_filter_->decodeHeaders(other_headers, false));
+
+  EXPECT_EQ(1U, config_->stats().check_cache_miss_.value());
+  EXPECT_EQ(1U, config_->stats().check_cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+}
+
+// A request with a different key makes its own check call.
+TEST_F(CheckCacheTest, DifferentKey) {
+  startCheck();
+  EXPECT_CALL(decoder_filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(okResponse());
+
+  EXPECT_CALL(*other_client_, check(_, _, _, _));
+  Http::TestRequestHeaderMapImpl other_headers{{":path", "/"}, {"authorization", "other"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(other_headers, false));
+  EXPECT_CALL(*other_client_, cancel());
+  other_filter_->onDestroy();
+
+  EXPECT_EQ(2U, config_->stats().check_cache_miss_.value());
+  EXPECT_EQ(0U, config_->stats().check_cache_hit_.value());
+}
+
+// Requests without any of the key headers bypass the cache.
+TEST_F(CheckCacheTest, NoKeyHeaders) {
+  EXPECT_CALL(*other_client_, check(_, _, _, _));
+  Http::TestRequestHeaderMapImpl other_headers{{":path", "/"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(other_headers, false));
+  EXPECT_CALL(*other_client_, cancel());
+  other_filter_->onDestroy();
+
+  EXPECT_EQ(0U, config_->stats().check_cache_miss_.value());
+}
+
+// Routes with different context extensions don't share decisions, even for the same key headers.
+TEST_F(CheckCacheTest, DifferentContextExtensions) {
+  envoy::extensions::filters::http::ext_authz::v3::ExtAuthzPerRoute settings_a;
+  (*settings_a.mutable_check_settings()->mutable_context_extensions())["tenant"] = "a";
+  FilterConfigPerRoute per_route_a(settings_a);
+  ON_CALL(*decoder_filter_callbacks_.route_, mostSpecificPerFilterConfig(_))
+      .WillByDefault(Return(&per_route_a));
+  ON_CALL(*decoder_filter_callbacks_.route_, perFilterConfigs(_))
+      .WillByDefault(Invoke([&](absl::string_view) -> Router::RouteSpecificFilterConfigs {
+        return {&per_route_a};
+      }));
+
+  envoy::extensions::filters::http::ext_authz::v3::ExtAuthzPerRoute settings_b;
+  (*settings_b.mutable_check_settings()->mutable_context_extensions())["tenant"] = "b";
+  FilterConfigPerRoute per_route_b(settings_b);
+  ON_CALL(*other_decoder_callbacks_.route_, mostSpecificPerFilterConfig(_))
+      .WillByDefault(Return(&per_route_b));
+  ON_CALL(*other_decoder_callbacks_.route_, perFilterConfigs(_))
+      .WillByDefault(Invoke([&](absl::string_view) -> Router::RouteSpecificFilterConfigs {
+        return {&per_route_b};
+      }));
+
+  startCheck();
+  EXPECT_CALL(decoder_filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(okResponse());
+
+  // The decision allowing route A must not be used for route B.
+  Filters::Common::ExtAuthz::RequestCallbacks* other_callbacks = nullptr;
+  envoy::service::auth::v3::CheckRequest other_check_request;
+  EXPECT_CALL(*other_client_, check(_, _, _, _))
+      .WillOnce(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                           const envoy::service::auth::v3::CheckRequest& check_request,
+                           Tracing::Span&, const StreamInfo::StreamInfo&) -> void {
+        other_callbacks = &callbacks;
+        other_check_request = check_request;
+      }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(request_headers_, false));
+  ASSERT_NE(nullptr, other_callbacks);
+  EXPECT_EQ("b", other_check_request.attributes().context_extensions().at("tenant"));
+
+  auto denied = std::make_unique<Filters::Common::ExtAuthz::Response>();
+  denied->status = Filters::Common::ExtAuthz::CheckStatus::Denied;
+  denied->status_code = Http::Code::Unauthorized;
+  EXPECT_CALL(other_decoder_callbacks_, continueDecoding()).Times(0);
+  EXPECT_CALL(other_decoder_callbacks_, sendLocalReply(Http::Code::Unauthorized, _, _, _, _));
+  other_callbacks->onComplete(std::move(denied));
+
+  EXPECT_EQ(2U, config_->stats().check_cache_miss_.value());
+  EXPECT_EQ(0U, config_->stats().check_cache_hit_.value());
+  EXPECT_EQ(1U, config_->stats().ok_.value());
+  EXPECT_EQ(1U, config_->stats().denied_.value());
+  EXPECT_EQ(2U, config_->checkCache()->cache().size());
+}
+
+// Errors and decisions with a zero TTL are not cached.
+TEST_F(CheckCacheTest, UncacheableDecisions) {
+  startCheck();
+  auto response = okResponse();
+  (*response->dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(0);
+  EXPECT_CALL(decoder_filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(std::move(response));
+
+  Filters::Common::ExtAuthz::RequestCallbacks* other_callbacks = nullptr;
+  EXPECT_CALL(*other_client_, check(_, _, _, _))
+      .WillOnce(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                           const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                           const StreamInfo::StreamInfo&) -> void {
+        other_callbacks = &callbacks;
+      }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(request_headers_, false));
+  auto error = std::make_unique<Filters::Common::ExtAuthz::Response>();
+  error->status = Filters::Common::ExtAuthz::CheckStatus::Error;
+  EXPECT_CALL(other_decoder_callbacks_, sendLocalReply(Http::Code::Forbidden, _, _, _, _));
+  other_callbacks->onComplete(std::move(error));
+
+  EXPECT_EQ(2U, config_->stats().check_cache_miss_.value());
+  EXPECT_EQ(0U, config_->stats().check_cache_hit_.value());
+  EXPECT_EQ(0U, config_->checkCache()->cache().size());
+}
+
+// A concurrent request with the same key waits on the call in flight instead of making its own.
+TEST_F(CheckCacheTest, CoalescedCheck) {
+  startCheck();
+
+  EXPECT_CALL(*other_client_, check(_, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(request_headers_, false));
+
+  EXPECT_CALL(other_decoder_callbacks_, continueDecoding());
+  EXPECT_CALL(decoder_filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(okResponse());
+
+  EXPECT_EQ(1U, config_->stats().check_cache_miss_.value());
+  EXPECT_EQ(1U, config_->stats().check_coalesced_.value());
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+}
+
+// A waiting request that goes away is not called when the shared call completes.
+TEST_F(CheckCacheTest, CoalescedRequestDestroyed) {
+  startCheck();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(*other_client_, cancel()).Times(0);
+  other_filter_->onDestroy();
+
+  EXPECT_CALL(other_decoder_callbacks_, continueDecoding()).Times(0);
+  EXPECT_CALL(decoder_filter_callbacks_, continueDecoding());
+  request_callbacks_->onComplete(okResponse());
+  EXPECT_EQ(1U, config_->stats().ok_.value());
+}
+
+// When the request making the shared call goes away, a waiting request makes the call instead.
+TEST_F(CheckCacheTest, SharedCallAbandoned) {
+  startCheck();
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            other_filter_->decodeHeaders(request_headers_, false));
+
+  Filters::Common::ExtAuthz::RequestCallbacks* other_callbacks = nullptr;
+  EXPECT_CALL(*client_, cancel());
+  EXPECT_CALL(*other_client_, check(_, _, _, _))
+      .WillOnce(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                           const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                           const StreamInfo::StreamInfo&) -> void {
+        other_callbacks = &callbacks;
+      }));
+  filter_->onDestroy();
+  ASSERT_NE(nullptr, other_callbacks);
+
+  EXPECT_CALL(other_decoder_callbacks_, continueDecoding());
+  other_callbacks->onComplete(okResponse());
+  EXPECT_EQ(1U, config_->checkCache()->cache().size());
+}
+
+// The TTL from the response metadata is capped, and values which aren't positive numbers disable
+// caching.
+TEST_F(CheckCacheTest, TtlMetadataIsBounded) {
+  const auto ttl = [this](double seconds) {
+    Filters::Common::ExtAuthz::Response response{};
+    (*response.dynamic_metadata.mutable_fields())["cache_ttl"] = ValueUtil::numberValue(seconds);
+    return config_->checkCache()->ttl(response);
+  };
+  const std::chrono::milliseconds one_year = std::chrono::hours(365 * 24);
+  EXPECT_EQ(std::chrono::milliseconds(1500), ttl(1.5));
+  EXPECT_EQ(one_year, ttl(1e300));
+  EXPECT_EQ(one_year, ttl(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(std::chrono::milliseconds(0), ttl(-std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(std::chrono::milliseconds(0), ttl(std::numeric_limits<double>::quiet_NaN()));
+}
+
 } // namespace
 } // namespace ExtAuthz
 } // namespace HttpFilters
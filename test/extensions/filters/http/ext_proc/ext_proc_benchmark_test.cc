@@ -13,6 +13,7 @@
 #include "test/test_common/utility.h"
 
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "gtest/gtest.h"
 
@@ -81,10 +82,14 @@ protected:
                           ->add_endpoints()
                           ->add_lb_endpoints()
                           ->mutable_endpoint()
-                          ->mutable_address()
-                          ->mutable_socket_address();
-      address->set_address(Network::Test::getLoopbackAddressString(ipVersion()));
-      address->set_port_value(test_processor_.port());
+                          ->mutable_address();
+      if (!processor_socket_path_.empty()) {
+        address->mutable_pipe()->set_path(processor_socket_path_);
+      } else {
+        address->mutable_socket_address()->set_address(
+            Network::Test::getLoopbackAddressString(ipVersion()));
+        address->mutable_socket_address()->set_port_value(test_processor_.port());
+      }
 
       // Ensure "HTTP2 with no prior knowledge." Necessary for gRPC.
       ConfigHelper::setHttp2(
@@ -145,7 +150,16 @@ protected:
     }
   }
 
+  // Starts the processor on a Unix domain socket rather than a loopback TCP port, as for a
+  // processor running on the same host as Envoy.
+  void startProcessorOnUnixSocket(ProcessingFunc cb) {
+    processor_socket_path_ = TestEnvironment::unixDomainSocketPath(absl::StrCat(
+        testing::UnitTest::GetInstance()->current_test_info()->name(), ".sock"));
+    test_processor_.startOnUnixSocket(processor_socket_path_, std::move(cb));
+  }
+
   TestProcessor test_processor_;
+  std::string processor_socket_path_;
   envoy::extensions::filters::http::ext_proc::v3::ExternalProcessor proto_config_{};
 };
 
@@ -189,34 +203,44 @@ TEST_F(BenchmarkTest, AddRequestHeaderAndClose) {
   measureHttpGets("add-request-header-close");
 }
 
+// Pass the request headers through, then add a response header and close.
+void addResponseHeaderAndClose(
+    grpc::ServerReaderWriter<ProcessingResponse, ProcessingRequest>* stream) {
+  ProcessingRequest request_in;
+  ASSERT_TRUE(stream->Read(&request_in));
+  ASSERT_TRUE(request_in.has_request_headers());
+  ProcessingResponse request_out;
+  request_out.mutable_request_headers();
+  stream->Write(request_out);
+
+  ProcessingRequest response_in;
+  ASSERT_TRUE(stream->Read(&response_in));
+  ASSERT_TRUE(response_in.has_response_headers());
+  ProcessingResponse response_out;
+  auto* new_hdr = response_out.mutable_response_headers()
+                      ->mutable_response()
+                      ->mutable_header_mutation()
+                      ->add_set_headers()
+                      ->mutable_header();
+  new_hdr->set_key("x-envoy-benchmark");
+  new_hdr->set_raw_value("true");
+  stream->Write(response_out);
+}
+
 // Add a response header, then close.
 TEST_F(BenchmarkTest, AddResponseHeaderAndClose) {
-  test_processor_.start(
-      ipVersion(), [](grpc::ServerReaderWriter<ProcessingResponse, ProcessingRequest>* stream) {
-        ProcessingRequest request_in;
-        ASSERT_TRUE(stream->Read(&request_in));
-        ASSERT_TRUE(request_in.has_request_headers());
-        ProcessingResponse request_out;
-        request_out.mutable_request_headers();
-        stream->Write(request_out);
-
-        ProcessingRequest response_in;
-        ASSERT_TRUE(stream->Read(&response_in));
-        ASSERT_TRUE(response_in.has_response_headers());
-        ProcessingResponse response_out;
-        auto* new_hdr = response_out.mutable_response_headers()
-                            ->mutable_response()
-                            ->mutable_header_mutation()
-                            ->add_set_headers()
-                            ->mutable_header();
-        new_hdr->set_key("x-envoy-benchmark");
-        new_hdr->set_raw_value("true");
-        stream->Write(response_out);
-      });
+  test_processor_.start(ipVersion(), addResponseHeaderAndClose);
   initialize();
   measureHttpGets("add-response-header-close");
 }
 
+// Same as above, with the processor reached over a Unix domain socket.
+TEST_F(BenchmarkTest, AddResponseHeaderAndCloseOverUnixSocket) {
+  startProcessorOnUnixSocket(addResponseHeaderAndClose);
+  initialize();
+  measureHttpGets("add-response-header-close-uds");
+}
+
 // Process the response body in buffered mode.
 TEST_F(BenchmarkTest, ProcessBufferedResponseBody) {
   proto_config_.mutable_processing_mode()->set_response_body_mode(ProcessingMode::BUFFERED);
@@ -247,6 +271,61 @@ TEST_F(BenchmarkTest, ProcessBufferedResponseBody) {
   measureHttpGets("buffered-response-body", 2000);
 }
 
+// Answer the headers, then each streamed body chunk in order until the end of the stream.
+void processStreamedResponseBody(
+    grpc::ServerReaderWriter<ProcessingResponse, ProcessingRequest>* stream) {
+  ProcessingRequest request_in;
+  ASSERT_TRUE(stream->Read(&request_in));
+  ASSERT_TRUE(request_in.has_request_headers());
+  ProcessingResponse request_out;
+  request_out.mutable_request_headers();
+  stream->Write(request_out);
+
+  ProcessingRequest response_in;
+  ASSERT_TRUE(stream->Read(&response_in));
+  ASSERT_TRUE(response_in.has_response_headers());
+  ProcessingResponse response_out;
+  response_out.mutable_response_headers();
+  stream->Write(response_out);
+
+  ProcessingRequest body_in;
+  while (stream->Read(&body_in)) {
+    ASSERT_TRUE(body_in.has_response_body());
+    ProcessingResponse body_out;
+    body_out.mutable_response_body();
+    stream->Write(body_out);
+    if (body_in.response_body().end_of_stream()) {
+      break;
+    }
+  }
+}
+
+// Process a large response body in streamed mode, with only the buffer limit bounding the chunks
+// waiting for the processor.
+TEST_F(BenchmarkTest, ProcessStreamedResponseBody) {
+  proto_config_.mutable_processing_mode()->set_response_body_mode(ProcessingMode::STREAMED);
+  test_processor_.start(ipVersion(), processStreamedResponseBody);
+  initialize();
+  measureHttpGets("streamed-response-body", 1024 * 1024);
+}
+
+// Same as above, with the processor reached over a Unix domain socket.
+TEST_F(BenchmarkTest, ProcessStreamedResponseBodyOverUnixSocket) {
+  proto_config_.mutable_processing_mode()->set_response_body_mode(ProcessingMode::STREAMED);
+  startProcessorOnUnixSocket(processStreamedResponseBody);
+  initialize();
+  measureHttpGets("streamed-response-body-uds", 1024 * 1024);
+}
+
+// Same as the loopback case, with at most four chunks waiting for the processor at a time.
+TEST_F(BenchmarkTest, ProcessStreamedResponseBodyWindowed) {
+  proto_config_.mutable_processing_mode()->set_response_body_mode(ProcessingMode::STREAMED);
+  proto_config_.mutable_max_streamed_chunks_in_flight()->set_value(4);
+  test_processor_.start(ipVersion(), processStreamedResponseBody);
+  initialize();
+  measureHttpGets("streamed-response-body-window-4", 1024 * 1024);
+}
+
 } // namespace
 } // namespace ExternalProcessing
 } // namespace HttpFilters
@@ -4,6 +4,7 @@
 
 #include "test/test_common/network_utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "grpc++/server_builder.h"
 
@@ -25,12 +26,21 @@ grpc::Status ProcessorWrapper::Process(
 
 void TestProcessor::start(const Network::Address::IpVersion ip_version, ProcessingFunc cb,
                           absl::optional<ContextProcessingFunc> context_cb) {
+  start(absl::StrFormat("%s:0", Network::Test::getLoopbackAddressUrlString(ip_version)),
+        std::move(cb), std::move(context_cb));
+}
+
+void TestProcessor::startOnUnixSocket(const std::string& path, ProcessingFunc cb,
+                                      absl::optional<ContextProcessingFunc> context_cb) {
+  start(absl::StrCat("unix:", path), std::move(cb), std::move(context_cb));
+}
+
+void TestProcessor::start(const std::string& listening_address, ProcessingFunc cb,
+                          absl::optional<ContextProcessingFunc> context_cb) {
   wrapper_ = std::make_unique<ProcessorWrapper>(cb, context_cb);
   grpc::ServerBuilder builder;
   builder.RegisterService(wrapper_.get());
-  builder.AddListeningPort(
-      absl::StrFormat("%s:0", Network::Test::getLoopbackAddressUrlString(ip_version)),
-      grpc::InsecureServerCredentials(), &listening_port_);
+  builder.AddListeningPort(listening_address, grpc::InsecureServerCredentials(), &listening_port_);
   server_ = builder.BuildAndStart();
 }
 
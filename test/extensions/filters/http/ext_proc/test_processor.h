@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 #include "envoy/network/address.h"
 #include "envoy/service/ext_proc/v3/external_processor.grpc.pb.h"
@@ -53,6 +54,11 @@ public:
   void start(const Network::Address::IpVersion ip_version, ProcessingFunc cb,
              absl::optional<ContextProcessingFunc> context_cb = absl::nullopt);
 
+  // Start the processor listening on the Unix domain socket at the given path, as a processor
+  // co-located with Envoy would. port() is not meaningful in this case.
+  void startOnUnixSocket(const std::string& path, ProcessingFunc cb,
+                         absl::optional<ContextProcessingFunc> context_cb = absl::nullopt);
+
   // Stop the processor from listening once all streams are closed, and exit
   // the listening threads.
   void shutdown();
@@ -62,9 +68,12 @@ public:
   int port() const { return listening_port_; }
 
 private:
+  void start(const std::string& listening_address, ProcessingFunc cb,
+             absl::optional<ContextProcessingFunc> context_cb);
+
   std::unique_ptr<ProcessorWrapper> wrapper_;
   std::unique_ptr<grpc::Server> server_;
-  int listening_port_;
+  int listening_port_{};
 };
 
 } // namespace ExternalProcessing
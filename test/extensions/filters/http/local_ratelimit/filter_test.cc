@@ -1002,6 +1002,51 @@ TEST_F(DescriptorFilterTest, UseInlinedRateLimitConfig) {
   EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_->decodeHeaders(headers, false));
 }
 
+static constexpr absl::string_view wildcard_descriptor_config_yaml = R"(
+stat_prefix: test
+token_bucket:
+  max_tokens: 10
+  tokens_per_fill: 1
+  fill_interval: 60s
+filter_enabled:
+  runtime_key: test_enabled
+  default_value:
+    numerator: 100
+    denominator: HUNDRED
+filter_enforced:
+  runtime_key: test_enforced
+  default_value:
+    numerator: 100
+    denominator: HUNDRED
+wildcard_descriptors:
+- entries:
+   - key: client
+  token_bucket:
+    max_tokens: 1
+    tokens_per_fill: 1
+    fill_interval: 60s
+rate_limits:
+- actions:
+  - request_headers:
+      header_name: x-client
+      descriptor_key: client
+  )";
+
+TEST_F(DescriptorFilterTest, WildcardDescriptorBucketPerValue) {
+  setUpTest(std::string(wildcard_descriptor_config_yaml));
+
+  auto headers_a = Http::TestRequestHeaderMapImpl{{"x-client", "a"}};
+  auto headers_b = Http::TestRequestHeaderMapImpl{{"x-client", "b"}};
+
+  // Each client gets its own token bucket with one token.
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers_a, false));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers_b, false));
+  EXPECT_CALL(decoder_callbacks_, sendLocalReply(Http::Code::TooManyRequests, _, _, _, _));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_->decodeHeaders(headers_a, false));
+  EXPECT_EQ(2U, findCounter("test.http_local_rate_limit.ok"));
+  EXPECT_EQ(1U, findCounter("test.http_local_rate_limit.rate_limited"));
+}
+
 } // namespace LocalRateLimitFilter
 } // namespace HttpFilters
 } // namespace Extensions
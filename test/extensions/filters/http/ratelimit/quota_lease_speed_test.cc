@@ -0,0 +1,122 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/extensions/filters/http/ratelimit/quota_lease.h"
+
+#include "test/benchmark/main.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+namespace {
+
+constexpr uint64_t Limit = 1000;
+constexpr std::chrono::seconds Window(1);
+const std::string Key = "key";
+
+class SimulatedTimeSource : public TimeSource {
+public:
+  SystemTime systemTime() override { return SystemTime(now_.time_since_epoch()); }
+  MonotonicTime monotonicTime() override { return now_; }
+
+  MonotonicTime now_;
+};
+
+// A stand-in for the rate limit service with a fixed window limit. Like the reference
+// implementation, it counts the hits of a call against the limit even when it refuses them.
+class SimulatedRateLimitService {
+public:
+  explicit SimulatedRateLimitService(SimulatedTimeSource& time_source)
+      : time_source_(time_source) {}
+
+  bool hit(uint64_t hits) {
+    ++calls_;
+    const uint64_t window = time_source_.now_.time_since_epoch() / Window;
+    if (window != window_) {
+      window_ = window;
+      count_ = 0;
+    }
+    count_ += hits;
+    return count_ <= Limit;
+  }
+
+  SimulatedTimeSource& time_source_;
+  uint64_t window_{};
+  uint64_t count_{};
+  uint64_t calls_{};
+};
+
+// Simulates Envoys that share a limit of 1000 requests per second and receive twice as many
+// requests between them, with the number of Envoys given by the first argument and the lease size
+// by the second (0 disables leasing). Each Envoy holds its leases for a tenth of the window. The
+// calls to the rate limit service complete immediately. Reports the requests allowed per request
+// the limit allows, and the calls to the rate limit service per request.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_QuotaLeasingAccuracy(::benchmark::State& state) {
+  const uint64_t num_envoys = state.range(0);
+  const uint64_t lease_size = state.range(1);
+  const uint64_t windows = benchmark::skipExpensiveBenchmarks() ? 2 : 100;
+  const uint64_t requests_per_window = 2 * Limit;
+  const auto interval =
+      std::chrono::duration_cast<MonotonicTime::duration>(Window) / requests_per_window;
+
+  uint64_t allowed = 0;
+  uint64_t calls = 0;
+  uint64_t requests = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    SimulatedTimeSource time_source;
+    SimulatedRateLimitService service(time_source);
+    std::vector<std::unique_ptr<QuotaLeases>> envoys;
+    for (uint64_t i = 0; i < num_envoys; i++) {
+      envoys.push_back(std::make_unique<QuotaLeases>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(Window) / 10, time_source));
+    }
+
+    for (uint64_t i = 0; i < windows * requests_per_window; i++) {
+      time_source.now_ += interval;
+      QuotaLeases& leases = *envoys[i % num_envoys];
+      // This follows the calls the filter makes for a request with a single hit.
+      const LeaseDecision decision =
+          lease_size == 0 ? LeaseDecision::PerRequest : leases.consume(Key, 1);
+      switch (decision) {
+      case LeaseDecision::Allow:
+        ++allowed;
+        break;
+      case LeaseDecision::PerRequest:
+        allowed += service.hit(1);
+        break;
+      case LeaseDecision::Lease:
+        if (service.hit(lease_size)) {
+          leases.onLeaseGranted(Key, lease_size - 1);
+          ++allowed;
+        } else {
+          leases.onLeaseRefused(Key);
+          allowed += service.hit(1);
+        }
+        break;
+      }
+    }
+    calls += service.calls_;
+    requests += windows * requests_per_window;
+  }
+  state.SetItemsProcessed(requests);
+  state.counters["allowed_per_limit"] = static_cast<double>(allowed) * 2 / requests;
+  state.counters["calls_per_request"] = static_cast<double>(calls) / requests;
+}
+BENCHMARK(BM_QuotaLeasingAccuracy)
+    ->ArgsProduct({{1, 8, 64}, {0, 10, 100}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
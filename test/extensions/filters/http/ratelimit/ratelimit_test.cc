@@ -18,6 +18,7 @@
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/ratelimit/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/utility.h"
@@ -56,7 +57,7 @@ public:
     TestUtility::loadFromYaml(yaml, proto_config);
 
     config_ = std::make_shared<FilterConfig>(proto_config, local_info_, *stats_store_.rootScope(),
-                                             runtime_, http_context_);
+                                             runtime_, http_context_, tls_);
 
     client_ = new Filters::Common::RateLimit::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::RateLimit::ClientPtr{client_});
@@ -112,6 +113,21 @@ public:
   stat_prefix: with_stat_prefix
   )EOF";
 
+  const std::string quota_leasing_config_ = R"EOF(
+  domain: foo
+  quota_leasing:
+    lease_size: 3
+    lease_ttl: 60s
+  )EOF";
+
+  // Creates another filter with the fixture's config and callbacks.
+  std::unique_ptr<Filter> createFilter(Filters::Common::RateLimit::MockClient*& client) {
+    client = new Filters::Common::RateLimit::MockClient();
+    auto filter = std::make_unique<Filter>(config_, Filters::Common::RateLimit::ClientPtr{client});
+    filter->setDecoderFilterCallbacks(filter_callbacks_);
+    return filter;
+  }
+
   Filters::Common::RateLimit::MockClient* client_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> filter_callbacks_;
   Stats::StatNamePool pool_{filter_callbacks_.clusterInfo()->statsScope().symbolTable()};
@@ -119,6 +135,8 @@ public:
   Stats::StatName ratelimit_error_{pool_.add("ratelimit.error")};
   Stats::StatName ratelimit_failure_mode_allowed_{pool_.add("ratelimit.failure_mode_allowed")};
   Stats::StatName ratelimit_over_limit_{pool_.add("ratelimit.over_limit")};
+  Stats::StatName ratelimit_leased_{pool_.add("ratelimit.leased")};
+  Stats::StatName ratelimit_lease_refused_{pool_.add("ratelimit.lease_refused")};
   Stats::StatName upstream_rq_4xx_{pool_.add("upstream_rq_4xx")};
   Stats::StatName upstream_rq_429_{pool_.add("upstream_rq_429")};
   Stats::StatName upstream_rq_5xx_{pool_.add("upstream_rq_5xx")};
@@ -140,6 +158,7 @@ public:
   std::vector<RateLimit::Descriptor> descriptor_two_{{{{"key", "value"}}}};
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
   Http::ContextImpl http_context_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
 };
 
 TEST_F(HttpRateLimitFilterTest, NoRoute) {
@@ -1716,6 +1735,183 @@ TEST_F(HttpRateLimitFilterTest, StatsWithPrefix) {
   EXPECT_EQ("request_rate_limited", filter_callbacks_.details());
 }
 
+// Requests spend the hits of a granted lease without calls, and make a lease call once it is spent.
+TEST_F(HttpRateLimitFilterTest, QuotaLeasingSpendsLease) {
+  setUpTest(quota_leasing_config_);
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillRepeatedly(SetArgReferee<0>(descriptor_));
+
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, 3))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                               nullptr, "", nullptr);
+
+  // The first request spent one of the three hits of the lease.
+  for (int i = 0; i < 2; i++) {
+    Filters::Common::RateLimit::MockClient* client;
+    std::unique_ptr<Filter> filter = createFilter(client);
+    EXPECT_CALL(*client, limit(_, _, _, _, _, _)).Times(0);
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter->decodeHeaders(request_headers_, false));
+  }
+
+  Filters::Common::RateLimit::MockClient* client;
+  std::unique_ptr<Filter> filter = createFilter(client);
+  EXPECT_CALL(*client, limit(_, "foo", _, _, _, 3));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(*client, cancel());
+  filter->onDestroy();
+
+  EXPECT_EQ(
+      1U, filter_callbacks_.clusterInfo()->statsScope().counterFromStatName(ratelimit_ok_).value());
+  EXPECT_EQ(2U, filter_callbacks_.clusterInfo()
+                    ->statsScope()
+                    .counterFromStatName(ratelimit_leased_)
+                    .value());
+}
+
+// A refused lease call is replaced by a call for the hits of the request, and the requests that
+// follow make a call per request.
+TEST_F(HttpRateLimitFilterTest, QuotaLeasingRefused) {
+  setUpTest(quota_leasing_config_);
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillRepeatedly(SetArgReferee<0>(descriptor_));
+
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, 3))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+
+  EXPECT_CALL(*client_, limit(_, "foo",
+                              testing::ContainerEq(std::vector<RateLimit::Descriptor>{
+                                  {{{"descriptor_key", "descriptor_value"}}}}),
+                              _, _, 0))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_CALL(filter_callbacks_, continueDecoding()).Times(0);
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OverLimit, nullptr, nullptr,
+                               nullptr, "", nullptr);
+
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                               nullptr, "", nullptr);
+
+  Filters::Common::RateLimit::MockClient* client;
+  std::unique_ptr<Filter> filter = createFilter(client);
+  EXPECT_CALL(*client, limit(_, "foo", _, _, _, 0));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(*client, cancel());
+  filter->onDestroy();
+
+  EXPECT_EQ(1U, filter_callbacks_.clusterInfo()
+                    ->statsScope()
+                    .counterFromStatName(ratelimit_lease_refused_)
+                    .value());
+  EXPECT_EQ(0U, filter_callbacks_.clusterInfo()
+                    ->statsScope()
+                    .counterFromStatName(ratelimit_over_limit_)
+                    .value());
+  EXPECT_EQ(
+      1U, filter_callbacks_.clusterInfo()->statsScope().counterFromStatName(ratelimit_ok_).value());
+}
+
+// While a lease call is in flight, concurrent requests for the same lease make a call for their own
+// hits instead of another lease call.
+TEST_F(HttpRateLimitFilterTest, QuotaLeasingSingleLeaseCallInFlight) {
+  setUpTest(quota_leasing_config_);
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillRepeatedly(SetArgReferee<0>(descriptor_));
+
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, 3))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+
+  std::vector<std::unique_ptr<Filter>> filters;
+  std::vector<Filters::Common::RateLimit::RequestCallbacks*> callbacks;
+  for (int i = 0; i < 2; i++) {
+    Filters::Common::RateLimit::MockClient* client;
+    filters.push_back(createFilter(client));
+    EXPECT_CALL(*client, limit(_, "foo", _, _, _, 0))
+        .WillOnce(WithArgs<0>(
+            Invoke([&](Filters::Common::RateLimit::RequestCallbacks& request_callbacks) -> void {
+              callbacks.push_back(&request_callbacks);
+            })));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+              filters.back()->decodeHeaders(request_headers_, false));
+  }
+
+  EXPECT_CALL(filter_callbacks_, continueDecoding()).Times(3);
+  for (Filters::Common::RateLimit::RequestCallbacks* request_callbacks : callbacks) {
+    request_callbacks->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                                nullptr, "", nullptr);
+  }
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
+                               nullptr, "", nullptr);
+
+  // The granted lease serves the next request.
+  Filters::Common::RateLimit::MockClient* client;
+  std::unique_ptr<Filter> filter = createFilter(client);
+  EXPECT_CALL(*client, limit(_, _, _, _, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter->decodeHeaders(request_headers_, false));
+
+  EXPECT_EQ(
+      3U, filter_callbacks_.clusterInfo()->statsScope().counterFromStatName(ratelimit_ok_).value());
+  EXPECT_EQ(1U, filter_callbacks_.clusterInfo()
+                    ->statsScope()
+                    .counterFromStatName(ratelimit_leased_)
+                    .value());
+}
+
+// A lease call that is cancelled or fails lets the next request make a new lease call.
+TEST_F(HttpRateLimitFilterTest, QuotaLeasingLeaseCallAbandoned) {
+  setUpTest(quota_leasing_config_);
+  EXPECT_CALL(route_rate_limit_, populateDescriptors(_, _, _, _))
+      .WillRepeatedly(SetArgReferee<0>(descriptor_));
+
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, 3));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(*client_, cancel());
+  filter_->onDestroy();
+
+  Filters::Common::RateLimit::MockClient* client;
+  std::unique_ptr<Filter> filter = createFilter(client);
+  EXPECT_CALL(*client, limit(_, "foo", _, _, _, 3))
+      .WillOnce(
+          WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
+            request_callbacks_ = &callbacks;
+          })));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(filter_callbacks_, continueDecoding());
+  request_callbacks_->complete(Filters::Common::RateLimit::LimitStatus::Error, nullptr, nullptr,
+                               nullptr, "", nullptr);
+
+  Filters::Common::RateLimit::MockClient* next_client;
+  std::unique_ptr<Filter> next_filter = createFilter(next_client);
+  EXPECT_CALL(*next_client, limit(_, "foo", _, _, _, 3));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            next_filter->decodeHeaders(request_headers_, false));
+  EXPECT_CALL(*next_client, cancel());
+  next_filter->onDestroy();
+}
+
 TEST(ObjectFactory, HitsAddend) {
   const std::string name = "envoy.ratelimit.hits_addend";
   auto* factory =
@@ -9,6 +9,7 @@
 
 #include "source/common/common/random_generator.h"
 #include "source/common/memory/stats.h"
+#include "source/common/router/metadatamatchcriteria_impl.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/subset/subset_lb.h"
 
@@ -118,6 +119,46 @@ BENCHMARK(benchmarkSubsetLoadBalancerUpdate)
     ->Ranges({{false, true}, {50, 2500}})
     ->Unit(::benchmark::kMillisecond);
 
+class MetadataMatchLoadBalancerContext : public Upstream::TestLoadBalancerContext {
+public:
+  MetadataMatchLoadBalancerContext(uint64_t value) {
+    ProtobufWkt::Struct metadata_matches;
+    (*metadata_matches.mutable_fields())[std::string(Upstream::BaseTester::metadata_key)]
+        .set_number_value(value);
+    metadata_match_ = std::make_unique<Router::MetadataMatchCriteriaImpl>(metadata_matches);
+  }
+
+  // Upstream::LoadBalancerContext
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override {
+    return metadata_match_.get();
+  }
+
+private:
+  std::unique_ptr<Router::MetadataMatchCriteriaImpl> metadata_match_;
+};
+
+void benchmarkSubsetLoadBalancerChooseHost(::benchmark::State& state) {
+  const bool single_host_per_subset = state.range(0);
+  const uint64_t num_hosts = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  SubsetLbTester tester(num_hosts, single_host_per_subset);
+  std::vector<std::unique_ptr<MetadataMatchLoadBalancerContext>> contexts;
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    contexts.push_back(std::make_unique<MetadataMatchLoadBalancerContext>(i));
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(contexts[i++ % num_hosts].get()));
+  }
+}
+
+BENCHMARK(benchmarkSubsetLoadBalancerChooseHost)->Ranges({{false, true}, {50, 2500}});
+
 } // namespace
 } // namespace Subset
 } // namespace LoadBalancingPolices
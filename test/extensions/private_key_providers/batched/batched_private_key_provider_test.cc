@@ -0,0 +1,290 @@
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/private_key_providers/batched/v3/batched.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+
+#include "source/common/thread_local/thread_local_impl.h"
+#include "source/common/tls/private_key/batched_private_key_provider.h"
+#include "source/extensions/private_key_providers/batched/software_batch_processor.h"
+
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/pem.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+namespace {
+
+using TransportSockets::Tls::BatchedPrivateKeyMethodProvider;
+using TransportSockets::Tls::PrivateKeyOperationBatch;
+using TransportSockets::Tls::PrivateKeyOperationSharedPtr;
+using TransportSockets::Tls::PrivateKeyThreadPool;
+using TransportSockets::Tls::PrivateKeyThreadPoolSharedPtr;
+
+using testing::ElementsAre;
+using testing::ReturnRef;
+
+// Records the sizes of the batches it performs, and fails their operations if fail_ is set.
+class RecordingBatchProcessor : public SoftwarePrivateKeyBatchProcessor {
+public:
+  using SoftwarePrivateKeyBatchProcessor::SoftwarePrivateKeyBatchProcessor;
+
+  void process(const PrivateKeyOperationBatch& batch) override {
+    SoftwarePrivateKeyBatchProcessor::process(batch);
+    for (const PrivateKeyOperationSharedPtr& operation : batch) {
+      operation->success_ = operation->success_ && !fail_;
+    }
+    absl::MutexLock lock(&mutex_);
+    batch_sizes_.push_back(batch.size());
+  }
+
+  std::vector<size_t> batchSizes() {
+    absl::MutexLock lock(&mutex_);
+    return batch_sizes_;
+  }
+
+  std::atomic<bool> fail_{};
+
+private:
+  absl::Mutex mutex_;
+  std::vector<size_t> batch_sizes_ ABSL_GUARDED_BY(mutex_);
+};
+
+// A TLS connection over a BIO pair whose server uses the provider for its private key.
+class TestConnection : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  TestConnection(SSL_CTX* client_ctx, SSL_CTX* server_ctx, Ssl::PrivateKeyMethodProvider& provider,
+                 Event::Dispatcher& dispatcher)
+      : client_(SSL_new(client_ctx)), server_(SSL_new(server_ctx)), provider_(provider) {
+    BIO* client_bio;
+    BIO* server_bio;
+    EXPECT_EQ(1, BIO_new_bio_pair(&client_bio, 0, &server_bio, 0));
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+    provider_.registerPrivateKeyMethod(server_.get(), *this, dispatcher);
+  }
+
+  ~TestConnection() override { close(); }
+
+  // Drives the handshake until it completes, fails, or waits for the private key operation.
+  void doHandshake() {
+    for (int i = 0; i < 10 && !done_ && !failed_; i++) {
+      const int client_rc = SSL_do_handshake(client_.get());
+      const int server_rc = SSL_do_handshake(server_.get());
+      if (client_rc == 1 && server_rc == 1) {
+        done_ = true;
+      } else if (SSL_get_error(server_.get(), server_rc) == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+        return;
+      } else if (SSL_get_error(server_.get(), server_rc) == SSL_ERROR_SSL ||
+                 SSL_get_error(client_.get(), client_rc) == SSL_ERROR_SSL) {
+        failed_ = true;
+      }
+    }
+  }
+
+  void close() {
+    if (server_ != nullptr) {
+      provider_.unregisterPrivateKeyMethod(server_.get());
+      server_.reset();
+    }
+  }
+
+  // Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override {
+    ++completions_;
+    doHandshake();
+    if (on_complete_) {
+      on_complete_();
+    }
+  }
+
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+  Ssl::PrivateKeyMethodProvider& provider_;
+  std::function<void()> on_complete_;
+  uint32_t completions_{};
+  bool done_{};
+  bool failed_{};
+};
+
+class BatchedPrivateKeyProviderTest : public testing::Test {
+public:
+  BatchedPrivateKeyProviderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        thread_pool_(std::make_shared<PrivateKeyThreadPool>(2, api_->threadFactory())) {
+    tls_.registerThread(*dispatcher_, true);
+  }
+
+  ~BatchedPrivateKeyProviderTest() override {
+    connections_.clear();
+    provider_.reset();
+    tls_.shutdownGlobalThreading();
+    tls_.shutdownThread();
+  }
+
+  static std::string testDataPath(absl::string_view file) {
+    return TestEnvironment::substitute(
+        absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", file));
+  }
+
+  static bssl::UniquePtr<EVP_PKEY> readKey(absl::string_view file) {
+    bssl::UniquePtr<BIO> bio(BIO_new_file(testDataPath(file).c_str(), "r"));
+    return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  }
+
+  // Creates the provider for the key, and a server context with the certificate that uses it.
+  void initialize(absl::string_view cert_file, absl::string_view key_file, uint32_t max_batch_size,
+                  std::chrono::milliseconds max_batch_delay) {
+    processor_ = std::make_shared<RecordingBatchProcessor>(readKey(key_file));
+    provider_ = std::make_unique<BatchedPrivateKeyMethodProvider>(
+        processor_, thread_pool_, max_batch_size, max_batch_delay, tls_);
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    EXPECT_EQ(1, SSL_CTX_use_certificate_file(server_ctx_.get(), testDataPath(cert_file).c_str(),
+                                              SSL_FILETYPE_PEM));
+    SSL_CTX_set_private_key_method(server_ctx_.get(),
+                                   provider_->getBoringSslPrivateKeyMethod().get());
+  }
+
+  // Starts the handshakes of a number of connections, and runs the dispatcher until all of them
+  // are resumed.
+  void handshake(uint32_t num_connections) {
+    uint32_t pending = num_connections;
+    for (uint32_t i = 0; i < num_connections; i++) {
+      connections_.push_back(std::make_unique<TestConnection>(
+          client_ctx_.get(), server_ctx_.get(), *provider_, *dispatcher_));
+      connections_.back()->on_complete_ = [this, &pending]() {
+        if (--pending == 0) {
+          dispatcher_->exit();
+        }
+      };
+      connections_.back()->doHandshake();
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  ThreadLocal::InstanceImpl tls_;
+  PrivateKeyThreadPoolSharedPtr thread_pool_;
+  std::shared_ptr<RecordingBatchProcessor> processor_;
+  std::unique_ptr<BatchedPrivateKeyMethodProvider> provider_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_{SSL_CTX_new(TLS_method())};
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  std::vector<std::unique_ptr<TestConnection>> connections_;
+};
+
+// Verify the signatures of concurrent handshakes are performed in one batch.
+TEST_F(BatchedPrivateKeyProviderTest, RsaSignInBatch) {
+  initialize("san_dns_cert.pem", "san_dns_key.pem", 4, std::chrono::hours(1));
+  handshake(4);
+  for (const auto& connection : connections_) {
+    EXPECT_TRUE(connection->done_);
+    EXPECT_EQ(1U, connection->completions_);
+  }
+  EXPECT_THAT(processor_->batchSizes(), ElementsAre(4U));
+}
+
+TEST_F(BatchedPrivateKeyProviderTest, EcdsaSignInBatch) {
+  initialize("selfsigned_ecdsa_p256_cert.pem", "selfsigned_ecdsa_p256_key.pem", 2,
+             std::chrono::hours(1));
+  handshake(2);
+  for (const auto& connection : connections_) {
+    EXPECT_TRUE(connection->done_);
+  }
+  EXPECT_THAT(processor_->batchSizes(), ElementsAre(2U));
+}
+
+// Verify RSA key exchange decrypts the premaster secret through the provider.
+TEST_F(BatchedPrivateKeyProviderTest, RsaDecrypt) {
+  initialize("san_dns_cert.pem", "san_dns_key.pem", 1, std::chrono::hours(1));
+  EXPECT_EQ(1, SSL_CTX_set_max_proto_version(client_ctx_.get(), TLS1_2_VERSION));
+  EXPECT_EQ(1, SSL_CTX_set_strict_cipher_list(client_ctx_.get(), "AES128-SHA"));
+  handshake(1);
+  EXPECT_TRUE(connections_[0]->done_);
+  EXPECT_THAT(processor_->batchSizes(), ElementsAre(1U));
+}
+
+// Verify a partial batch is performed after the batch delay.
+TEST_F(BatchedPrivateKeyProviderTest, PartialBatchAfterDelay) {
+  initialize("san_dns_cert.pem", "san_dns_key.pem", 16, std::chrono::milliseconds(1));
+  handshake(3);
+  for (const auto& connection : connections_) {
+    EXPECT_TRUE(connection->done_);
+  }
+  EXPECT_THAT(processor_->batchSizes(), ElementsAre(3U));
+}
+
+// Verify a connection closed while its operation is in a batch is not resumed.
+TEST_F(BatchedPrivateKeyProviderTest, ClosedConnectionNotResumed) {
+  initialize("san_dns_cert.pem", "san_dns_key.pem", 2, std::chrono::hours(1));
+  connections_.push_back(std::make_unique<TestConnection>(client_ctx_.get(), server_ctx_.get(),
+                                                          *provider_, *dispatcher_));
+  connections_.push_back(std::make_unique<TestConnection>(client_ctx_.get(), server_ctx_.get(),
+                                                          *provider_, *dispatcher_));
+  connections_[0]->doHandshake();
+  connections_[0]->close();
+  connections_[1]->on_complete_ = [this]() { dispatcher_->exit(); };
+  connections_[1]->doHandshake();
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+
+  EXPECT_EQ(0U, connections_[0]->completions_);
+  EXPECT_TRUE(connections_[1]->done_);
+}
+
+// Verify a failed operation fails the handshake.
+TEST_F(BatchedPrivateKeyProviderTest, FailedOperationFailsHandshake) {
+  initialize("san_dns_cert.pem", "san_dns_key.pem", 1, std::chrono::hours(1));
+  processor_->fail_ = true;
+  handshake(1);
+  EXPECT_FALSE(connections_[0]->done_);
+  EXPECT_TRUE(connections_[0]->failed_);
+}
+
+TEST_F(BatchedPrivateKeyProviderTest, Factory) {
+  envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider config;
+  config.set_provider_name("envoy.tls.key_providers.batched");
+  envoy::extensions::private_key_providers::batched::v3::BatchedPrivateKeyMethodConfig
+      batched_config;
+  batched_config.mutable_private_key()->set_filename(testDataPath("san_dns_key.pem"));
+  batched_config.mutable_num_threads()->set_value(1);
+  config.mutable_typed_config()->PackFrom(batched_config);
+
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context.server_context_, api()).WillByDefault(ReturnRef(*api_));
+  ON_CALL(factory_context.server_context_, threadLocal()).WillByDefault(ReturnRef(tls_));
+  auto* factory =
+      Registry::FactoryRegistry<Ssl::PrivateKeyMethodProviderInstanceFactory>::getFactory(
+          "envoy.tls.key_providers.batched");
+  ASSERT_NE(nullptr, factory);
+
+  Ssl::PrivateKeyMethodProviderSharedPtr provider =
+      factory->createPrivateKeyMethodProviderInstance(config, factory_context);
+  EXPECT_TRUE(provider->isAvailable());
+  EXPECT_NE(nullptr, provider->getBoringSslPrivateKeyMethod());
+
+  batched_config.mutable_private_key()->set_inline_string("not a key");
+  config.mutable_typed_config()->PackFrom(batched_config);
+  EXPECT_THROW_WITH_MESSAGE(
+      factory->createPrivateKeyMethodProviderInstance(config, factory_context), EnvoyException,
+      "Failed to read private key.");
+}
+
+} // namespace
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,182 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/thread_local/thread_local_impl.h"
+#include "source/common/tls/private_key/batched_private_key_provider.h"
+#include "source/extensions/private_key_providers/batched/software_batch_processor.h"
+
+#include "test/benchmark/main.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/pem.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+namespace {
+
+using TransportSockets::Tls::BatchedPrivateKeyMethodProvider;
+using TransportSockets::Tls::PrivateKeyThreadPool;
+
+constexpr uint32_t NumThreads = 4;
+
+std::string testDataPath(absl::string_view file) {
+  return TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/common/tls/test_data/", file));
+}
+
+// A TLS connection over a BIO pair, whose server signs with the provider if there is one.
+class StormConnection : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  StormConnection(SSL_CTX* client_ctx, SSL_CTX* server_ctx,
+                  Ssl::PrivateKeyMethodProvider* provider, Event::Dispatcher& dispatcher,
+                  std::function<void()> on_done)
+      : client_(SSL_new(client_ctx)), server_(SSL_new(server_ctx)), provider_(provider),
+        on_done_(std::move(on_done)) {
+    BIO* client_bio;
+    BIO* server_bio;
+    RELEASE_ASSERT(BIO_new_bio_pair(&client_bio, 0, &server_bio, 0) == 1, "BIO_new_bio_pair");
+    SSL_set_bio(client_.get(), client_bio, client_bio);
+    SSL_set_bio(server_.get(), server_bio, server_bio);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+    if (provider_ != nullptr) {
+      provider_->registerPrivateKeyMethod(server_.get(), *this, dispatcher);
+    }
+  }
+
+  ~StormConnection() override {
+    if (provider_ != nullptr) {
+      provider_->unregisterPrivateKeyMethod(server_.get());
+    }
+  }
+
+  void doHandshake() {
+    for (int i = 0; i < 10; i++) {
+      const int client_rc = SSL_do_handshake(client_.get());
+      const int server_rc = SSL_do_handshake(server_.get());
+      if (client_rc == 1 && server_rc == 1) {
+        on_done_();
+        return;
+      }
+      const int server_error = SSL_get_error(server_.get(), server_rc);
+      if (server_error == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+        return;
+      }
+      RELEASE_ASSERT(server_error == SSL_ERROR_NONE || server_error == SSL_ERROR_WANT_READ,
+                     "handshake failed");
+    }
+    PANIC("handshake did not complete");
+  }
+
+  // Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override { doHandshake(); }
+
+private:
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+  Ssl::PrivateKeyMethodProvider* provider_;
+  std::function<void()> on_done_;
+};
+
+// Measures full handshakes arriving as storms of concurrent connections on a worker, with the
+// server signing on the worker or with the batched private key provider as given by the first
+// argument (0 for the worker, 1 for the provider), and the number of connections of a storm given
+// by the second. Each handshake signs with a 2048 bit RSA key. The latency of a handshake is the
+// time from the start of its storm until it completes, and the p99 of the latencies is reported.
+void bmHandshakeStorm(::benchmark::State& state) {
+  std::string error;
+  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("private_key_handshake_benchmark", &error));
+  TestEnvironment::setRunfiles(runfiles.get());
+
+  const bool batched = state.range(0) == 1;
+  const uint32_t storm_size =
+      benchmark::skipExpensiveBenchmarks() ? std::min<uint32_t>(state.range(1), 16)
+                                           : state.range(1);
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+  ThreadLocal::InstanceImpl tls;
+  tls.registerThread(*dispatcher, true);
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(SSL_CTX_use_certificate_file(server_ctx.get(),
+                                              testDataPath("san_dns_cert.pem").c_str(),
+                                              SSL_FILETYPE_PEM) == 1,
+                 "SSL_CTX_use_certificate_file");
+  std::unique_ptr<BatchedPrivateKeyMethodProvider> provider;
+  if (batched) {
+    bssl::UniquePtr<BIO> bio(BIO_new_file(testDataPath("san_dns_key.pem").c_str(), "r"));
+    bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+    // The operations queued in an iteration of the event loop are handed over at its end.
+    provider = std::make_unique<BatchedPrivateKeyMethodProvider>(
+        std::make_shared<SoftwarePrivateKeyBatchProcessor>(std::move(pkey)),
+        std::make_shared<PrivateKeyThreadPool>(NumThreads, api->threadFactory()), 16,
+        std::chrono::milliseconds(0), tls);
+    SSL_CTX_set_private_key_method(server_ctx.get(),
+                                   provider->getBoringSslPrivateKeyMethod().get());
+  } else {
+    RELEASE_ASSERT(SSL_CTX_use_PrivateKey_file(server_ctx.get(),
+                                               testDataPath("san_dns_key.pem").c_str(),
+                                               SSL_FILETYPE_PEM) == 1,
+                   "SSL_CTX_use_PrivateKey_file");
+  }
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+
+  std::vector<double> latencies_us;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const MonotonicTime start = api->timeSource().monotonicTime();
+    uint32_t pending = storm_size;
+    bool running = false;
+    const auto on_done = [&]() {
+      const std::chrono::duration<double, std::micro> latency =
+          api->timeSource().monotonicTime() - start;
+      latencies_us.push_back(latency.count());
+      if (--pending == 0 && running) {
+        dispatcher->exit();
+      }
+    };
+
+    std::vector<std::unique_ptr<StormConnection>> connections;
+    for (uint32_t i = 0; i < storm_size; i++) {
+      connections.push_back(std::make_unique<StormConnection>(
+          client_ctx.get(), server_ctx.get(), provider.get(), *dispatcher, on_done));
+      connections.back()->doHandshake();
+    }
+    if (pending > 0) {
+      running = true;
+      dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+    }
+  }
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  state.SetItemsProcessed(latencies_us.size());
+  state.counters["p99_latency_us"] = latencies_us[latencies_us.size() * 99 / 100];
+
+  provider.reset();
+  tls.shutdownGlobalThreading();
+  tls.shutdownThread();
+}
+BENCHMARK(bmHandshakeStorm)
+    ->ArgsProduct({{0, 1}, {1, 64, 512}})
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
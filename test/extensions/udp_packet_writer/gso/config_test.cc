@@ -29,6 +29,16 @@ TEST(FactoryTest, CreateUdpPacketWriterFactory) {
   EXPECT_TRUE(factory.createUdpPacketWriterFactory(config) != nullptr);
 }
 
+TEST(FactoryTest, CreateBatchAcrossConnectionsUdpPacketWriterFactory) {
+  UdpGsoBatchWriterFactoryFactory factory;
+  envoy::extensions::udp_packet_writer::v3::UdpGsoBatchWriterFactory writer_config;
+  writer_config.set_batch_across_connections(true);
+  envoy::config::core::v3::TypedExtensionConfig config;
+  config.mutable_typed_config()->PackFrom(writer_config);
+  Network::UdpPacketWriterFactoryPtr writer_factory = factory.createUdpPacketWriterFactory(config);
+  EXPECT_TRUE(dynamic_cast<UdpGsoMmsgBatchWriterFactory*>(writer_factory.get()) != nullptr);
+}
+
 } // namespace Quic
 } // namespace Envoy
 
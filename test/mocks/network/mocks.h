@@ -454,7 +454,7 @@ public:
   MockUdpPacketWriterFactory() = default;
 
   MOCK_METHOD(Network::UdpPacketWriterPtr, createUdpPacketWriter,
-              (Network::IoHandle&, Stats::Scope&), ());
+              (Network::IoHandle&, Stats::Scope&, Event::Dispatcher&), ());
 };
 
 class MockUdpListenerConfig : public UdpListenerConfig {
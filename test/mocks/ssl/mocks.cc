@@ -44,6 +44,7 @@ MockServerContextConfig::MockServerContextConfig() {
   ON_CALL(*this, tlsKeyLogLocal()).WillByDefault(testing::ReturnRef(iplist_));
   ON_CALL(*this, tlsKeyLogRemote()).WillByDefault(testing::ReturnRef(iplist_));
   ON_CALL(*this, tlsKeyLogPath()).WillByDefault(testing::ReturnRef(path_));
+  ON_CALL(*this, dynamicRecordSizing()).WillByDefault(testing::ReturnRef(dynamic_record_sizing_));
 }
 MockServerContextConfig::~MockServerContextConfig() = default;
 
@@ -139,6 +139,8 @@ public:
   MOCK_METHOD(const std::string&, ecdhCurves, (), (const));
   MOCK_METHOD(const std::string&, signatureAlgorithms, (), (const));
   MOCK_METHOD(bool, preferClientCiphers, (), (const));
+  MOCK_METHOD(bool, kernelTlsOffload, (), (const));
+  MOCK_METHOD(const absl::optional<DynamicRecordSizing>&, dynamicRecordSizing, (), (const));
   MOCK_METHOD(std::vector<std::reference_wrapper<const TlsCertificateConfig>>, tlsCertificates, (),
               (const));
   MOCK_METHOD(const CertificateValidationContextConfig*, certificateValidationContext, (), (const));
@@ -159,6 +161,7 @@ public:
   MOCK_METHOD(const std::vector<SessionTicketKey>&, sessionTicketKeys, (), (const));
   MOCK_METHOD(bool, disableStatelessSessionResumption, (), (const));
   MOCK_METHOD(bool, disableStatefulSessionResumption, (), (const));
+  MOCK_METHOD(uint32_t, sharedSessionCacheSize, (), (const));
   MOCK_METHOD(const Network::Address::IpList&, tlsKeyLogLocal, (), (const));
   MOCK_METHOD(const Network::Address::IpList&, tlsKeyLogRemote, (), (const));
   MOCK_METHOD(const std::string&, tlsKeyLogPath, (), (const));
@@ -172,6 +175,7 @@ public:
   Network::Address::IpList iplist_;
   std::string path_;
   std::vector<SessionTicketKey> ticket_keys_;
+  absl::optional<DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 class MockTlsCertificateConfig : public TlsCertificateConfig {
@@ -213,6 +217,7 @@ public:
   MOCK_METHOD(bool, onlyVerifyLeafCertificateCrl, (), (const));
   MOCK_METHOD(absl::optional<uint32_t>, maxVerifyDepth, (), (const));
   MOCK_METHOD(bool, autoSniSanMatch, (), (const));
+  MOCK_METHOD(uint32_t, verifiedChainCacheSize, (), (const));
 };
 
 class MockPrivateKeyMethodManager : public PrivateKeyMethodManager {
@@ -103,6 +103,7 @@ TEST_F(OptionsImplTest, All) {
       "--local-address-ip-version v6 -l info --component-log-level upstream:debug,connection:trace "
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
+      "--file-write-buffer-limit-bytes 1048576 --file-write-overflow-policy drop "
       "--skip-hot-restart-on-no-parent "
       "--skip-hot-restart-parent-stats "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 "
@@ -131,6 +132,8 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ("node", options->serviceNodeName());
   EXPECT_EQ("zone", options->serviceZone());
   EXPECT_EQ(std::chrono::milliseconds(9000), options->fileFlushIntervalMsec());
+  EXPECT_EQ(1048576U, options->fileWriteBufferLimitBytes());
+  EXPECT_EQ(AccessLog::FileOverflowPolicy::Drop, options->fileWriteOverflowPolicy());
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_TRUE(options->hotRestartDisabled());
@@ -197,6 +200,8 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setLogPath("/foo/bar");
   options->setRestartEpoch(44);
   options->setFileFlushIntervalMsec(std::chrono::milliseconds(45));
+  options->setFileWriteBufferLimitBytes(4096);
+  options->setFileWriteOverflowPolicy(AccessLog::FileOverflowPolicy::Block);
   options->setMode(Server::Mode::Validate);
   options->setServiceClusterName("cluster_foo");
   options->setServiceNodeName("node_foo");
@@ -230,6 +235,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(std::chrono::seconds(43), options->parentShutdownTime());
   EXPECT_EQ(44, options->restartEpoch());
   EXPECT_EQ(std::chrono::milliseconds(45), options->fileFlushIntervalMsec());
+  EXPECT_EQ(4096U, options->fileWriteBufferLimitBytes());
+  EXPECT_EQ(AccessLog::FileOverflowPolicy::Block, options->fileWriteOverflowPolicy());
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ("cluster_foo", options->serviceClusterName());
   EXPECT_EQ("node_foo", options->serviceNodeName());
@@ -263,6 +270,9 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->restartEpoch(), command_line_options->restart_epoch());
   EXPECT_EQ(options->fileFlushIntervalMsec().count() / 1000,
             command_line_options->file_flush_interval().seconds());
+  EXPECT_EQ(options->fileWriteBufferLimitBytes(),
+            command_line_options->file_write_buffer_limit_bytes());
+  EXPECT_EQ("block", command_line_options->file_write_overflow_policy());
   EXPECT_EQ(envoy::admin::v3::CommandLineOptions::Validate, command_line_options->mode());
   EXPECT_EQ(options->serviceClusterName(), command_line_options->service_cluster());
   EXPECT_EQ(options->serviceNodeName(), command_line_options->service_node());
@@ -291,6 +301,8 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(0U, options->statsTags().size());
   EXPECT_FALSE(options->hotRestartDisabled());
   EXPECT_FALSE(options->cpusetThreadsEnabled());
+  EXPECT_EQ(0U, options->fileWriteBufferLimitBytes());
+  EXPECT_EQ(AccessLog::FileOverflowPolicy::Count, options->fileWriteOverflowPolicy());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -308,6 +320,8 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_FALSE(command_line_options->allow_unknown_static_fields());
   EXPECT_FALSE(command_line_options->reject_unknown_dynamic_fields());
   EXPECT_EQ(0, options->statsTags().size());
+  EXPECT_EQ(0U, command_line_options->file_write_buffer_limit_bytes());
+  EXPECT_EQ("count", command_line_options->file_write_overflow_policy());
 }
 
 TEST_F(OptionsImplTest, DefaultParamsNoConstructorArgs) {
@@ -376,6 +390,9 @@ TEST_F(OptionsImplTest, OptionsFromArgvPrefix) {
 TEST_F(OptionsImplTest, BadCliOption) {
   EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --local-address-ip-version foo"),
                           MalformedArgvException, "error: unknown IP address version 'foo'");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy -c hello --file-write-overflow-policy foo"),
+                          MalformedArgvException,
+                          "error: unknown file write overflow policy 'foo'");
 }
 
 TEST_F(OptionsImplTest, ParseComponentLogLevels) {
@@ -511,6 +528,10 @@ TEST_F(OptionsImplTest, SaneTestConstructor) {
   EXPECT_EQ(regular_options_impl->mode(), test_options_impl.mode());
   EXPECT_EQ(regular_options_impl->fileFlushIntervalMsec(),
             test_options_impl.fileFlushIntervalMsec());
+  EXPECT_EQ(regular_options_impl->fileWriteBufferLimitBytes(),
+            test_options_impl.fileWriteBufferLimitBytes());
+  EXPECT_EQ(regular_options_impl->fileWriteOverflowPolicy(),
+            test_options_impl.fileWriteOverflowPolicy());
   EXPECT_EQ(regular_options_impl->hotRestartDisabled(), test_options_impl.hotRestartDisabled());
   EXPECT_EQ(regular_options_impl->cpusetThreadsEnabled(), test_options_impl.cpusetThreadsEnabled());
 }
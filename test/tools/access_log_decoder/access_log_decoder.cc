@@ -0,0 +1,46 @@
+/**
+ * Utility to decode a binary access log written by the file access logger's binary_format into
+ * one JSON object per line.
+ *
+ * Usage:
+ *
+ * access_log_decoder <binary access log path>
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
+
+#include "source/common/protobuf/protobuf.h"
+#include "source/common/protobuf/utility.h"
+
+// NOLINT(namespace-envoy)
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <binary access log path>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream input(argv[1], std::ios_base::binary);
+  if (!input) {
+    std::cerr << "Unable to open " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Envoy::Protobuf::io::IstreamInputStream stream(&input);
+  Envoy::Protobuf::io::CodedInputStream coded_stream(&stream);
+  uint32_t size;
+  while (coded_stream.ReadVarint32(&size)) {
+    const auto limit = coded_stream.PushLimit(size);
+    envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+    if (!entry.ParseFromCodedStream(&coded_stream) || !coded_stream.ConsumedEntireMessage()) {
+      std::cerr << "Truncated or malformed entry" << std::endl;
+      return EXIT_FAILURE;
+    }
+    coded_stream.PopLimit(limit);
+    std::cout << Envoy::MessageUtil::getJsonStringFromMessageOrError(entry, false, false)
+              << std::endl;
+  }
+  return EXIT_SUCCESS;
+}